@@ -1,58 +1,59 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 
-#define MAX_PROCESSES 100
-#define MAX_GANTT_CHART_SIZE 1000
-#define MAX_FILENAME_LENGTH 256
+#include "sim-common.h"
+
 #define DEFAULT_NICE_VALUE 0
 #define MIN_NICE_VALUE -20
 #define MAX_NICE_VALUE 19
 #define DEFAULT_TIMESLICE 1
 #define MIN_VRUNTIME_THRESHOLD 0.01
+#define STARVATION_THRESHOLD 20 // Time units
+#define DEFAULT_MIN_GRANULARITY 1 // Time units
+#define DEFAULT_LATENCY 20 // Time units
+#define SMALL_QUEUE_CAPACITY 32
+#define DEFAULT_SMALL_QUEUE 24 // Runnable processes kept in the inline array before switching to the tree
+#define VRUNTIME_SCALE 5120 // vruntime advances by (VRUNTIME_SCALE + 4 * nice) per ns
+#define METRICS_SCHEDULER "cfs"
 
 // Process structure
-typedef struct
+struct Process
 {
     int id;
-    int arrival_time;
-    int burst_time;
-    int remaining_burst;
-    int completion_time;
-    int waiting_time;
-    int turnaround_time;
-    int response_time;
-    int first_execution_time;
-    int deadline;
+    int64_t arrival_time; // All times are in nanoseconds
+    int64_t burst_time;
+    int64_t remaining_burst;
+    int64_t completion_time;
+    int64_t waiting_time;
+    int64_t turnaround_time;
+    int64_t response_time;
+    int64_t first_execution_time;
+    int64_t deadline;
     int criticality;
-    int period;
+    int64_t period;
     int nice;
-    double vruntime;
+    int64_t vruntime; // Scaled by VRUNTIME_SCALE
     double weight;
     bool executed;
     bool completed;
-} Process;
+    bool rejected; // Shed by admission control
+    SchedStat stat;
+};
 
 // CFS parameters
 typedef struct
 {
-    double min_granularity;
-    double latency;
-    double target_latency;
+    int64_t min_granularity; // ns
+    int64_t latency;         // ns
+    int64_t target_latency;  // ns
     int total_weight;
 } CFSParams;
 
-// Gantt Chart structure
-typedef struct
-{
-    int process_id;
-    int start_time;
-    int end_time;
-} GanttChartItem;
-
 // Benchmarking metrics
 typedef struct
 {
@@ -75,26 +76,53 @@ typedef struct RBNode
     int color; // 0 for black, 1 for red
 } RBNode;
 
+// Ready processes: an inline array searched linearly while the queue is
+// short, the vruntime tree once it outgrows small_queue_max entries
+typedef struct
+{
+    RBNode *tree;
+    bool small;                             // Whether the array holds the queue
+    int size;
+    int64_t keys[SMALL_QUEUE_CAPACITY];     // vruntime of each array entry, in insertion order
+    Process *entries[SMALL_QUEUE_CAPACITY];
+} RunQueue;
+
+// Settings of the runs of a before/after comparison
+typedef struct
+{
+    CFSParams *cfs;
+    TickModel *ticks;
+    InterruptModel *irq;
+} Comparison;
+
 // Global variables
-Process processes[MAX_PROCESSES];
-GanttChartItem gantt_chart[MAX_GANTT_CHART_SIZE];
-int gantt_chart_size = 0;
+Process *processes = NULL;
 Metrics metrics;
-RBNode *root = NULL;
+int small_queue_max = DEFAULT_SMALL_QUEUE;
 
 // Function prototypes
-int readProcessesFromFile(Process *processes, const char *filename);
+int readProcessesFromFile(Process **processes, const char *filename);
 void writeDefaultInputFile(const char *filename);
 void calculateWeight(Process *process);
 RBNode *createNode(Process *process);
 RBNode *insert(RBNode *root, Process *process);
 Process *extractMinVruntime(RBNode **root);
+void resetRunQueue(RunQueue *queue);
+int flattenTree(RBNode *node, RunQueue *queue, int count);
+void enqueueRunnable(RunQueue *queue, Process *process);
+Process *dequeueRunnable(RunQueue *queue);
 void runCFS(Process *processes, int n, CFSParams *cfs);
-void calculateMetrics(Process *processes, int n, int total_time);
-void displayGanttChart();
+void calculateMetrics(Process *processes, int n, int64_t total_time);
 void displayProcessDetails(Process *processes, int n);
 void displayMetrics();
-void addToGanttChart(int process_id, int start_time, int end_time);
+void runSampledCFS(Process *processes, int n, void *context, double *averages);
+int64_t nextArrivalAfter(Process *processes, int n, int64_t time, bool sorted);
+void resetProcessState(Process *process);
+void metricValues(Metrics *run_metrics, double *values);
+void runTickVariant(Process *processes, int n, int variant, double *values, void *context);
+void runTickComparison(Process *processes, int n, CFSParams *cfs, TickModel *model);
+void runInterruptVariant(Process *processes, int n, int variant, double *values, void *context);
+void runInterruptComparison(Process *processes, int n, CFSParams *cfs, InterruptModel *model);
 
 // Insert a process into the RB tree (simplified for this implementation)
 RBNode *insert(RBNode *root, Process *process)
@@ -174,6 +202,89 @@ Process *extractMinVruntime(RBNode **root)
     return process;
 }
 
+// Empty the run queue; it starts out as the inline array
+void resetRunQueue(RunQueue *queue)
+{
+    queue->tree = NULL;
+    queue->small = small_queue_max > 0;
+    queue->size = 0;
+}
+
+// Move the tree into the array in vruntime order, freeing its nodes. Equal
+// vruntimes keep their insertion order, as the tree ordered them.
+int flattenTree(RBNode *node, RunQueue *queue, int count)
+{
+    if (node == NULL)
+        return count;
+
+    count = flattenTree(node->left, queue, count);
+    queue->keys[count] = node->process->vruntime;
+    queue->entries[count++] = node->process;
+    count = flattenTree(node->right, queue, count);
+    free(node);
+    return count;
+}
+
+// Add a process to the run queue, moving to the tree once the array is full
+void enqueueRunnable(RunQueue *queue, Process *process)
+{
+    if (queue->small && queue->size == small_queue_max)
+    {
+        for (int i = 0; i < queue->size; i++)
+            queue->tree = insert(queue->tree, queue->entries[i]);
+        queue->small = false;
+    }
+
+    if (queue->small)
+    {
+        queue->keys[queue->size] = process->vruntime;
+        queue->entries[queue->size] = process;
+    }
+    else
+    {
+        queue->tree = insert(queue->tree, process);
+    }
+    queue->size++;
+}
+
+// Remove the process with the minimum vruntime (the earliest queued on ties)
+Process *dequeueRunnable(RunQueue *queue)
+{
+    if (queue->size == 0)
+        return NULL;
+
+    if (!queue->small)
+    {
+        Process *process = extractMinVruntime(&queue->tree);
+        queue->size--;
+
+        // Back to the array once the queue is well below the threshold, so a
+        // queue hovering around it does not move back and forth
+        if (queue->size <= small_queue_max / 2 && small_queue_max > 0)
+        {
+            flattenTree(queue->tree, queue, 0);
+            queue->tree = NULL;
+            queue->small = true;
+        }
+        return process;
+    }
+
+    // Branch-free scan the compiler vectorizes, then the first entry holding the minimum
+    int64_t smallest = queue->keys[0];
+    for (int i = 1; i < queue->size; i++)
+        smallest = queue->keys[i] < smallest ? queue->keys[i] : smallest;
+    int found = 0;
+    while (queue->keys[found] != smallest)
+        found++;
+
+    Process *process = queue->entries[found];
+    int after = queue->size - found - 1;
+    memmove(&queue->keys[found], &queue->keys[found + 1], sizeof(int64_t) * after);
+    memmove(&queue->entries[found], &queue->entries[found + 1], sizeof(Process *) * after);
+    queue->size--;
+    return process;
+}
+
 // Calculate the weight based on nice value (similar to Linux CFS)
 void calculateWeight(Process *process)
 {
@@ -188,9 +299,16 @@ void calculateWeight(Process *process)
     process->weight = 1024.0 / (0.8 * process->nice + 1024);
 }
 
-// Function to read processes from a file
-int readProcessesFromFile(Process *processes, const char *filename)
+// Function to read processes from a file into a newly allocated array
+int readProcessesFromFile(Process **out, const char *filename)
 {
+    // Traces prepared by trace-prep are mapped instead of parsed
+    int prepared = readPreparedTrace(out, filename);
+    if (prepared < 0)
+        exit(1);
+    if (prepared > 0)
+        return prepared;
+
     FILE *file = fopen(filename, "r");
     if (file == NULL)
     {
@@ -214,23 +332,32 @@ int readProcessesFromFile(Process *processes, const char *filename)
         exit(1);
     }
 
-    if (n <= 0 || n > MAX_PROCESSES)
+    if (n <= 0)
+    {
+        printf("Invalid number of processes: %d (must be at least 1)\n", n);
+        fclose(file);
+        exit(1);
+    }
+
+    Process *processes = (Process *)malloc(sizeof(Process) * n);
+    if (processes == NULL)
     {
-        printf("Invalid number of processes: %d (must be between 1 and %d)\n", n, MAX_PROCESSES);
+        printf("Not enough memory for %d processes\n", n);
         fclose(file);
         exit(1);
     }
 
-    // Read process data
+    // Read process data; times are given in time units and kept in ns
     for (int i = 0; i < n; i++)
     {
-        if (fscanf(file, "%d %d %d %d %d %d %d",
+        long long arrival_time, burst_time, deadline, period;
+        if (fscanf(file, "%d %lld %lld %lld %d %lld %d",
                    &processes[i].id,
-                   &processes[i].arrival_time,
-                   &processes[i].burst_time,
-                   &processes[i].deadline,
+                   &arrival_time,
+                   &burst_time,
+                   &deadline,
                    &processes[i].criticality,
-                   &processes[i].period,
+                   &period,
                    &processes[i].nice) != 7)
         {
             printf("Error reading data for process %d\n", i + 1);
@@ -238,23 +365,113 @@ int readProcessesFromFile(Process *processes, const char *filename)
             exit(1);
         }
 
-        // Initialize other fields
-        processes[i].remaining_burst = processes[i].burst_time;
-        processes[i].completion_time = 0;
-        processes[i].waiting_time = 0;
-        processes[i].turnaround_time = 0;
-        processes[i].response_time = 0;
-        processes[i].first_execution_time = -1;
-        processes[i].vruntime = 0;
-        calculateWeight(&processes[i]);
-        processes[i].executed = false;
-        processes[i].completed = false;
+        processes[i].arrival_time = arrival_time * time_unit;
+        processes[i].burst_time = burst_time * time_unit;
+        processes[i].deadline = deadline * time_unit;
+        processes[i].period = period * time_unit;
+        resetProcessState(&processes[i]);
     }
 
     fclose(file);
+    *out = processes;
     return n;
 }
 
+// Initialize the simulation fields of a freshly loaded process
+void resetProcessState(Process *process)
+{
+    process->remaining_burst = process->burst_time;
+    process->completion_time = 0;
+    process->waiting_time = 0;
+    process->turnaround_time = 0;
+    process->response_time = 0;
+    process->first_execution_time = -1;
+    process->vruntime = 0;
+    calculateWeight(process);
+    process->executed = false;
+    process->completed = false;
+    process->rejected = false;
+    memset(&process->stat, 0, sizeof(process->stat));
+}
+
+// Earliest arrival after the given time, or time + 1 if nothing arrives later.
+// Idle periods jump straight to it instead of stepping through every ns.
+int64_t nextArrivalAfter(Process *processes, int n, int64_t time, bool sorted)
+{
+    if (sorted)
+    {
+        int next = firstArrivalAfter(processes, n, time);
+        return next < n ? processes[next].arrival_time : time + 1;
+    }
+
+    int64_t next_arrival = INT64_MAX;
+    for (int i = 0; i < n; i++)
+    {
+        if (processes[i].arrival_time > time && processes[i].arrival_time < next_arrival)
+            next_arrival = processes[i].arrival_time;
+    }
+    return next_arrival != INT64_MAX ? next_arrival : time + 1;
+}
+
+// Size of a process record, for the shared models
+const size_t process_size = sizeof(Process);
+
+// Fill in what the shared models read from a process
+void viewProcess(Process *process, ProcessView *view)
+{
+    view->arrival_time = process->arrival_time;
+    view->burst_time = process->burst_time;
+    view->work = process->burst_time;
+    view->deadline = process->deadline;
+    view->completion_time = process->completion_time;
+    view->turnaround_time = process->turnaround_time;
+    view->waiting_time = process->waiting_time;
+    view->response_time = process->response_time;
+    view->starved = process->waiting_time > STARVATION_THRESHOLD * time_unit;
+    view->completed = process->completed;
+    view->shed = process->rejected;
+}
+
+// Element of a process array, for the shared models
+Process *processAt(Process *processes, int index)
+{
+    return &processes[index];
+}
+
+// Shed a process for admission control: it counts as done but never runs
+void markShed(Process *process)
+{
+    process->completed = true;
+    process->rejected = true;
+}
+
+// Scheduling statistics of a process, for the shared accounting
+SchedStat *processStat(Process *process)
+{
+    return &process->stat;
+}
+
+// Move a process offset earlier, for a trace window simulated from zero
+void shiftProcess(Process *process, int64_t offset)
+{
+    process->arrival_time -= offset;
+}
+
+// Set the trace fields of a process and reset its simulation state; the
+// priority is its nice value
+void initializeProcess(Process *process, int id, int64_t arrival_time, int64_t burst_time, int64_t deadline,
+                       int criticality, int64_t period, int priority)
+{
+    process->id = id;
+    process->arrival_time = arrival_time;
+    process->burst_time = burst_time;
+    process->deadline = deadline;
+    process->criticality = criticality;
+    process->period = period;
+    process->nice = priority;
+    resetProcessState(process);
+}
+
 // Function to write a default input file if none exists
 void writeDefaultInputFile(const char *filename)
 {
@@ -284,29 +501,28 @@ void writeDefaultInputFile(const char *filename)
     fclose(file);
 }
 
-// Add an entry to the Gantt chart
-void addToGanttChart(int process_id, int start_time, int end_time)
-{
-    if (gantt_chart_size < MAX_GANTT_CHART_SIZE)
-    {
-        gantt_chart[gantt_chart_size].process_id = process_id;
-        gantt_chart[gantt_chart_size].start_time = start_time;
-        gantt_chart[gantt_chart_size].end_time = end_time;
-        gantt_chart_size++;
-    }
-    else
-    {
-        printf("Gantt chart is full!\n");
-    }
-}
-
 // Main CFS algorithm
 void runCFS(Process *processes, int n, CFSParams *cfs)
 {
-    int current_time = 0;
+    int64_t current_time = 0;
     int completed_processes = 0;
     int idle_time = 0;
-    root = NULL;
+    int64_t wakeup_delay = 0;
+    int queued = 0;
+    RunQueue run_queue;
+    resetRunQueue(&run_queue);
+    resetProgress(n);
+    if (tick_model != NULL)
+    {
+        tick_model->busy_ticks = 0;
+        tick_model->stolen_time = 0;
+    }
+    if (idle_model != NULL)
+        resetIdleModel(idle_model);
+    if (admission != NULL)
+        resetAdmission(admission, n);
+    if (irq_model != NULL)
+        resetInterrupts(irq_model);
 
     // Timeslice calculation based on weights is a key aspect of CFS
     double total_weight = 0;
@@ -319,14 +535,22 @@ void runCFS(Process *processes, int n, CFSParams *cfs)
 
     cfs->total_weight = total_weight;
 
+    // Sorted traces (including synthetic ones) find arrivals by binary search
+    bool sorted = arrivalsSorted(processes, n);
+
     // Continue until all processes are completed
-    while (completed_processes < n)
+    // Processes shed by admission control never complete
+    while (completed_processes + (admission != NULL ? admission->rejected : 0) < n)
     {
         // Check for newly arrived processes
-        for (int i = 0; i < n; i++)
+        int from = sorted ? firstArrivalAfter(processes, n, current_time - 1) : 0;
+        int to = sorted ? firstArrivalAfter(processes, n, current_time) : n;
+        for (int i = from; i < to; i++)
         {
             if (processes[i].arrival_time == current_time && !processes[i].completed)
             {
+                if (admission != NULL && !admitArrival(admission, &processes[i], current_time, queued))
+                    continue;
                 // For newly arrived processes, set the vruntime
                 // In real CFS, this is more complex, but we'll use a simplified approach
                 if (!processes[i].executed)
@@ -334,23 +558,42 @@ void runCFS(Process *processes, int n, CFSParams *cfs)
                     // Give new processes a small advantage
                     processes[i].vruntime = 0;
                 }
-                root = insert(root, &processes[i]);
+                enqueueRunnable(&run_queue, &processes[i]);
+                queued++;
             }
         }
 
-        // If no process is ready, increment time and add idle to Gantt chart
-        if (root == NULL)
+        // Deferred processes are admitted as the ready queue drains
+        Process *released;
+        while (admission != NULL && (released = releaseDeferred(admission, current_time, queued)) != NULL)
+        {
+            accountRelease(released, current_time);
+            released->vruntime = 0;
+            enqueueRunnable(&run_queue, released);
+            queued++;
+        }
+
+        // If no process is ready, skip to the next arrival and add idle to Gantt chart
+        if (run_queue.size == 0)
         {
-            current_time++;
+            int64_t idle_start = current_time;
+            current_time = nextArrivalAfter(processes, n, current_time, sorted);
+            if (idle_model != NULL)
+                wakeup_delay = enterIdleState(idle_model, current_time - idle_start);
+            if (irq_model != NULL)
+                wakeup_delay += interruptIdleDelay(irq_model, current_time);
+            if (host_model != NULL)
+                wakeup_delay += hostWakeDelay(host_model, idle_start, current_time);
             idle_time++;
             if (idle_time == 1)
             {
-                addToGanttChart(-1, current_time - 1, current_time);
+                addToGanttChart(-1, idle_start, current_time);
             }
             else
             {
                 gantt_chart[gantt_chart_size - 1].end_time = current_time;
             }
+            updateProgress(current_time, completed_processes, 0);
             continue;
         }
         else
@@ -358,21 +601,63 @@ void runCFS(Process *processes, int n, CFSParams *cfs)
             idle_time = 0;
         }
 
+        // Waking from an idle state holds back the dispatch by its exit latency;
+        // processes arriving meanwhile are queued and the CPU stays idle
+        if (wakeup_delay > 0)
+        {
+            int64_t wake_end = current_time + wakeup_delay;
+            from = sorted ? firstArrivalAfter(processes, n, current_time) : 0;
+            to = sorted ? firstArrivalAfter(processes, n, wake_end - 1) : n;
+            for (int i = from; i < to; i++)
+            {
+                if (processes[i].arrival_time > current_time && processes[i].arrival_time < wake_end)
+                {
+                    if (admission != NULL && !admitArrival(admission, &processes[i], current_time, queued))
+                        continue;
+                    processes[i].vruntime = 0;
+                    enqueueRunnable(&run_queue, &processes[i]);
+                    queued++;
+                }
+            }
+            gantt_chart[gantt_chart_size - 1].end_time = wake_end;
+            current_time = wake_end;
+            wakeup_delay = 0;
+            continue;
+        }
+
         // Get the process with the minimum vruntime
-        Process *current_process = extractMinVruntime(&root);
+        Process *current_process = dequeueRunnable(&run_queue);
+        queued--;
 
         // Calculate dynamic timeslice based on process weight and target latency
         // In real CFS, this depends on many factors including load and sched_latency
-        double active_processes = n - completed_processes;
-        cfs->target_latency = fmax(cfs->min_granularity * active_processes, cfs->latency);
+        int64_t active_processes = n - completed_processes;
+        cfs->target_latency = cfs->min_granularity * active_processes;
+        if (cfs->target_latency < cfs->latency)
+            cfs->target_latency = cfs->latency;
 
         // Calculate timeslice - simplified compared to real CFS
         double timeslice = (current_process->weight / cfs->total_weight) * cfs->target_latency;
-        if (timeslice < 1)
-            timeslice = 1;
+        if (timeslice < cfs->min_granularity)
+            timeslice = cfs->min_granularity;
 
         // Cap the timeslice to the remaining burst time
-        int execution_time = (int)fmin(timeslice, current_process->remaining_burst);
+        int64_t execution_time = timeslice < current_process->remaining_burst ? (int64_t)timeslice : current_process->remaining_burst;
+        int64_t slice_start = current_time;
+        int64_t slice_end = current_time + execution_time;
+
+        // With a periodic tick the slice only ends on a tick, and ticks steal CPU time
+        if (tick_model != NULL)
+            slice_end = tickedExecution(tick_model, current_time, (int64_t)timeslice,
+                                        current_process->remaining_burst, &execution_time);
+
+        // Interrupts arriving during the slice preempt the process
+        if (irq_model != NULL)
+            slice_end = interruptedExecution(irq_model, slice_start, slice_end);
+
+        // Under a hypervisor the slice only advances while the vCPU holds a pCPU
+        if (host_model != NULL)
+            slice_end = hostExecution(host_model, slice_start, slice_end);
 
         // If process is executing for the first time, record response time
         if (!current_process->executed)
@@ -382,16 +667,23 @@ void runCFS(Process *processes, int n, CFSParams *cfs)
         }
 
         // Add to Gantt chart
-        addToGanttChart(current_process->id, current_time, current_time + execution_time);
+        addToGanttChart(current_process->id, slice_start, slice_end);
 
         // Update process information
         current_process->remaining_burst -= execution_time;
+        if (admission != NULL)
+            admission->backlog -= execution_time;
 
         // In CFS, vruntime increases based on actual runtime weighted by process weight
-        // Lower weight (higher priority) processes accumulate vruntime more slowly
-        current_process->vruntime += execution_time / current_process->weight;
+        // Lower weight (higher priority) processes accumulate vruntime more slowly.
+        // execution_time / weight is kept exact in integers scaled by VRUNTIME_SCALE
+        current_process->vruntime += execution_time * (VRUNTIME_SCALE + 4 * current_process->nice);
+        accountSlice(current_process, slice_start, slice_end, execution_time, current_process->remaining_burst > 0);
 
-        current_time += execution_time;
+        current_time = slice_end;
+        progress.busy_time += slice_end - slice_start;
+        if (exporter != NULL)
+            metricsDispatch(execution_time);
 
         // Check if process is completed
         if (current_process->remaining_burst <= 0)
@@ -402,42 +694,68 @@ void runCFS(Process *processes, int n, CFSParams *cfs)
             current_process->waiting_time = current_process->turnaround_time - current_process->burst_time;
             current_process->response_time = current_process->first_execution_time - current_process->arrival_time;
             completed_processes++;
+            recordProgressCompletion(current_process->turnaround_time, current_process->waiting_time,
+                                     current_process->response_time);
+            if (exporter != NULL)
+                metricsCompletion(current_process->completion_time, current_process->deadline);
+
+            // Synthetic runs stop once the steady-state estimates are precise enough
+            if (steady_state != NULL && recordObservation(steady_state, current_process, current_time))
+                break;
         }
         else
         {
             // Put the process back in the tree
-            root = insert(root, current_process);
+            enqueueRunnable(&run_queue, current_process);
+            queued++;
         }
 
-        // Check for newly arrived processes during this time slice
-        for (int i = 0; i < n; i++)
+        // Check for newly arrived processes during this time slice; arrivals at
+        // exactly current_time are queued by the next iteration, not here as well
+        from = sorted ? firstArrivalAfter(processes, n, slice_start) : 0;
+        to = sorted ? firstArrivalAfter(processes, n, current_time - 1) : n;
+        for (int i = from; i < to; i++)
         {
             if (!processes[i].executed && !processes[i].completed &&
-                processes[i].arrival_time > current_time - execution_time &&
-                processes[i].arrival_time <= current_time)
+                processes[i].arrival_time > slice_start &&
+                processes[i].arrival_time < current_time)
             {
+                if (admission != NULL && !admitArrival(admission, &processes[i], current_time, queued))
+                    continue;
 
                 // Set initial vruntime for newly arrived process
                 // In real CFS, this would be the min_vruntime to avoid starvation
                 processes[i].vruntime = 0;
-                root = insert(root, &processes[i]);
+                enqueueRunnable(&run_queue, &processes[i]);
+                queued++;
             }
         }
+
+        updateProgress(current_time, completed_processes, queued);
     }
 
-    // Calculate benchmarking metrics
-    calculateMetrics(processes, n, current_time);
+    if (tick_model != NULL)
+        tick_model->end_time = current_time;
+    if (irq_model != NULL)
+        irq_model->end_time = current_time;
+
+    // Calculate benchmarking metrics over the processes admission control did not shed
+    int admitted;
+    Process *kept = admittedProcesses(processes, n, &admitted);
+    calculateMetrics(kept, admitted, current_time);
+    if (kept != processes)
+        free(kept);
 }
 
 // Calculate various performance metrics
-void calculateMetrics(Process *processes, int n, int total_time)
+void calculateMetrics(Process *processes, int n, int64_t total_time)
 {
     double total_turnaround_time = 0.0;
     double total_waiting_time = 0.0;
     double total_response_time = 0.0;
     double sum_of_squares = 0.0;
     double sum = 0.0;
-    int starvation_threshold = 20;
+    int64_t starvation_threshold = STARVATION_THRESHOLD * time_unit;
     int starved_count = 0;
 
     for (int i = 0; i < n; i++)
@@ -457,13 +775,13 @@ void calculateMetrics(Process *processes, int n, int total_time)
         }
     }
 
-    // Calculate average metrics
-    metrics.avg_turnaround_time = total_turnaround_time / n;
-    metrics.avg_waiting_time = total_waiting_time / n;
-    metrics.avg_response_time = total_response_time / n;
+    // Calculate average metrics (reported in time units)
+    metrics.avg_turnaround_time = total_turnaround_time / n / time_unit;
+    metrics.avg_waiting_time = total_waiting_time / n / time_unit;
+    metrics.avg_response_time = total_response_time / n / time_unit;
 
-    // Calculate throughput
-    metrics.throughput = (double)n / total_time;
+    // Calculate throughput (processes per time unit)
+    metrics.throughput = (double)n / ((double)total_time / time_unit);
 
     // Calculate Jain's fairness index
     metrics.fairness_index = (sum * sum) / (n * sum_of_squares);
@@ -486,70 +804,88 @@ void calculateMetrics(Process *processes, int n, int total_time)
     metrics.load_balancing_efficiency = 1.0 / (1.0 + coefficient_of_variation);
 }
 
-// Display Gantt chart
-void displayGanttChart()
+// Run CFS on a copy of the parameters, for sampling mode and hosted guests
+void runSampledCFS(Process *processes, int n, void *context, double *averages)
 {
-    printf("\n\nGantt Chart:\n");
+    CFSParams params = *(CFSParams *)context;
+    runCFS(processes, n, &params);
 
-    // Print top border
-    printf(" ");
-    for (int i = 0; i < gantt_chart_size; i++)
+    if (averages != NULL)
     {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
-        {
-            printf("--");
-        }
-        printf(" ");
+        averages[0] = metrics.avg_turnaround_time;
+        averages[1] = metrics.avg_waiting_time;
+        averages[2] = metrics.avg_response_time;
+        averages[3] = metrics.starvation_count;
     }
-    printf("\n|");
+}
 
-    // Print process IDs
-    for (int i = 0; i < gantt_chart_size; i++)
-    {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
-        {
-            if (gantt_chart[i].process_id == -1)
-            {
-                printf("I "); // I for Idle
-            }
-            else
-            {
-                printf("P%d", gantt_chart[i].process_id);
-            }
-            if (j < duration - 1)
-            {
-                printf(" ");
-            }
-        }
-        printf("|");
-    }
+// Summary metrics of a run, in the order displayMetrics reports them
+void metricValues(Metrics *run_metrics, double *values)
+{
+    values[0] = run_metrics->avg_turnaround_time;
+    values[1] = run_metrics->avg_waiting_time;
+    values[2] = run_metrics->avg_response_time;
+    values[3] = run_metrics->throughput;
+    values[4] = run_metrics->fairness_index;
+    values[5] = run_metrics->starvation_count;
+    values[6] = run_metrics->load_balancing_efficiency;
+}
 
-    // Print bottom border
-    printf("\n ");
-    for (int i = 0; i < gantt_chart_size; i++)
-    {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
-        {
-            printf("--");
-        }
-        printf(" ");
-    }
+// One run of the tick comparison: tickless, then with the tick model
+void runTickVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    tick_model = variant ? comparison->ticks : NULL;
+    runCFS(processes, n, comparison->cfs);
+    metricValues(&metrics, values);
+}
 
-    // Print time markers
-    printf("\n");
-    for (int i = 0; i < gantt_chart_size; i++)
-    {
-        printf("%2d", gantt_chart[i].start_time);
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration * 2 - 1; j++)
-        {
-            printf(" ");
-        }
-    }
-    printf("%2d\n", gantt_chart[gantt_chart_size - 1].end_time);
+// Run the trace tickless and then with the tick model, and compare the metrics
+void runTickComparison(Process *processes, int n, CFSParams *cfs, TickModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time",
+        "Throughput",
+        "Fairness Index",
+        "Starvation Count",
+        "Load Balancing Efficiency"};
+    Comparison comparison = {cfs, model};
+    char label[32];
+    snprintf(label, sizeof(label), "HZ=%lld", (long long)model->hz);
+
+    runComparison(processes, n, runTickVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "Tickless", label);
+    displayTickStats(model);
+}
+// One run of the interrupt comparison: without, then with the interrupt source
+void runInterruptVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    irq_model = variant ? comparison->irq : NULL;
+    runCFS(processes, n, comparison->cfs);
+    summarizeResponses(processes, n, values);
+    values[4] = metrics.avg_turnaround_time;
+    values[5] = metrics.throughput;
+}
+
+// Run the trace without and then with the interrupt source, and compare the
+// metrics interrupts disturb
+void runInterruptComparison(Process *processes, int n, CFSParams *cfs, InterruptModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Response Time",
+        "Response Time Jitter",
+        "P99 Response Time",
+        "Deadline Misses",
+        "Average Turnaround Time",
+        "Throughput"};
+    Comparison comparison = {cfs, NULL, model};
+
+    runComparison(processes, n, runInterruptVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "No Interrupts", "Interrupts");
+    displayInterruptLoad(model);
 }
 
 // Display process details
@@ -558,22 +894,30 @@ void displayGanttChart()
 // Display metrics
 void displayProcessDetails(Process *processes, int n)
 {
-    printf("ProcessID,ArrivalTime,BurstTime,CompletionTime,TurnaroundTime,WaitingTime,ResponseTime,Deadline,Criticality,Period,Nice,Weight\n");
+    printf("ProcessID,ArrivalTime,BurstTime,CompletionTime,TurnaroundTime,WaitingTime,ResponseTime,Deadline,Criticality,Period,Nice,Weight,"
+           "RunnableTime,RunTime,BlockedTime,ThrottledTime,Slices,Preemptions,Migrations\n");
     for (int i = 0; i < n; i++)
     {
-        printf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%.2f\n",
+        printf("%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%d,%lld,%d,%.2f,%lld,%lld,%lld,%lld,%d,%d,%d\n",
                processes[i].id,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].completion_time,
-               processes[i].turnaround_time,
-               processes[i].waiting_time,
-               processes[i].response_time,
-               processes[i].deadline,
+               (long long)processes[i].arrival_time,
+               (long long)processes[i].burst_time,
+               (long long)processes[i].completion_time,
+               (long long)processes[i].turnaround_time,
+               (long long)processes[i].waiting_time,
+               (long long)processes[i].response_time,
+               (long long)processes[i].deadline,
                processes[i].criticality,
-               processes[i].period,
+               (long long)processes[i].period,
                processes[i].nice,
-               processes[i].weight);
+               processes[i].weight,
+               (long long)processes[i].stat.wait_time,
+               (long long)processes[i].stat.run_time,
+               (long long)processes[i].stat.blocked_time,
+               (long long)processes[i].stat.throttled_time,
+               processes[i].stat.slices,
+               processes[i].stat.preemptions,
+               processes[i].stat.migrations);
     }
 }
 
@@ -595,38 +939,382 @@ int main(int argc, char *argv[])
 {
     int n;
     CFSParams cfs;
+    SamplingParams sampling;
+    SteadyStateParams steady;
     char filename[MAX_FILENAME_LENGTH];
-
-    // Initialize CFS parameters (approximating Linux defaults)
-    cfs.min_granularity = 1.0; // Minimum timeslice (ms)
-    cfs.latency = 20.0;        // Target latency (ms)
-    cfs.target_latency = 20.0; // Initial target latency
-
+    const char *gantt_filename = NULL;
+    bool process_details = false;
+    const char *stats_filename = NULL;
+    int progress_interval = 0;
+    const char *metrics_socket = NULL;
+    const char *metrics_file = NULL;
+    int metrics_interval = DEFAULT_METRICS_INTERVAL;
+    TickModel ticks;
+    bool tick_compare = false;
+    IdleModel idle;
+    const char *idle_states = NULL;
+    const char *idle_governor = NULL;
+    AdmissionControl admit;
+    InterruptModel irq;
+    HostModel host;
+    const char *host_policy = NULL;
+    bool irq_compare = false;
+
+    // Initialize CFS parameters (approximating Linux defaults); unless given in
+    // ns they default to DEFAULT_MIN_GRANULARITY and DEFAULT_LATENCY time units
+    cfs.min_granularity = -1; // Minimum timeslice (ns)
+    cfs.latency = -1;         // Target latency (ns)
+
+    // Tickless unless a tick rate is given with --hz
+    memset(&ticks, 0, sizeof(ticks));
+    ticks.overhead = DEFAULT_TICK_OVERHEAD_NS;
+
+    // Idle CPUs wake up instantly unless idle states are enabled
+    memset(&idle, 0, sizeof(idle));
+    idle.latency_limit = -1;
+
+    // Every arrival is admitted unless an admission limit is set
+    memset(&admit, 0, sizeof(admit));
+    admit.horizon = -1;
+
+    // No interrupt load unless an interval is given with --irq-interval-ns
+    memset(&irq, 0, sizeof(irq));
+    irq.hardirq = DEFAULT_HARDIRQ_NS;
+    irq.softirq = DEFAULT_SOFTIRQ_NS;
+    irq.burst = 1.0;
+
+    // No hypervisor unless --host-pcpus is given
+    memset(&host, 0, sizeof(host));
+    host.guests = 1;
+    host.guest_weight = HOST_DEFAULT_WEIGHT;
+    host.slice = -1;
+
+    // Sampling mode is off unless requested with --sample
+    sampling.enabled = false;
+    sampling.window_length = 0;
+    sampling.strata = 4;
+    sampling.windows_per_stratum = 3;
+    sampling.warmup = -1;
+    sampling.seed = 1;
+    sampling.compare = false;
+
+    // Synthetic workloads are off unless requested with --synthetic
+    steady.enabled = false;
+    steady.arrival_rate = 0.15;
+    steady.mean_burst = 4.0;
+    steady.max_jobs = 200000;
+    steady.precision = 0.05;
+    steady.abs_precision = 0.01;
+    steady.check_interval = 1000;
+    steady.seed = 1;
 
     // Check if filename is provided as command-line argument
-    if (argc > 1)
+    int first_option = 1;
+    if (argc > 1 && strncmp(argv[1], "--", 2) != 0)
     {
         strncpy(filename, argv[1], MAX_FILENAME_LENGTH - 1);
         filename[MAX_FILENAME_LENGTH - 1] = '\0'; // Ensure null-terminated
+        first_option = 2;
     }
     else
     {
         // Use default filename if no argument is provided
         strcpy(filename, "input.txt");
-        printf("No input file specified. Using default: input.txt\n");
     }
 
+    // Optional flags follow the input file
+    for (int i = first_option; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sample") == 0)
+            sampling.enabled = true;
+        else if (strcmp(argv[i], "--compare") == 0)
+            sampling.compare = true;
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+            sampling.window_length = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--strata") == 0 && i + 1 < argc)
+            sampling.strata = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--per-stratum") == 0 && i + 1 < argc)
+            sampling.windows_per_stratum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            sampling.warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--gantt-out") == 0 && i + 1 < argc)
+            gantt_filename = argv[++i];
+        else if (strcmp(argv[i], "--process-details") == 0)
+            process_details = true;
+        else if (strcmp(argv[i], "--synthetic") == 0)
+            steady.enabled = true;
+        else if (strcmp(argv[i], "--arrival-rate") == 0 && i + 1 < argc)
+            steady.arrival_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--mean-burst") == 0 && i + 1 < argc)
+            steady.mean_burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-jobs") == 0 && i + 1 < argc)
+            steady.max_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc)
+            steady.precision = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            sampling.seed = steady.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--time-unit-ns") == 0 && i + 1 < argc)
+            time_unit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--min-granularity-ns") == 0 && i + 1 < argc)
+            cfs.min_granularity = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--latency-ns") == 0 && i + 1 < argc)
+            cfs.latency = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--small-queue") == 0 && i + 1 < argc)
+            small_queue_max = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            ticks.hz = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-overhead-ns") == 0 && i + 1 < argc)
+            ticks.overhead = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-compare") == 0)
+            tick_compare = true;
+        else if (strcmp(argv[i], "--idle-states") == 0 && i + 1 < argc)
+            idle_states = argv[++i];
+        else if (strcmp(argv[i], "--idle-governor") == 0 && i + 1 < argc)
+            idle_governor = argv[++i];
+        else if (strcmp(argv[i], "--idle-latency-limit-ns") == 0 && i + 1 < argc)
+            idle.latency_limit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-utilization") == 0 && i + 1 < argc)
+            admit.max_utilization = atof(argv[++i]);
+        else if (strcmp(argv[i], "--admit-horizon-ns") == 0 && i + 1 < argc)
+            admit.horizon = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-queue") == 0 && i + 1 < argc)
+            admit.max_queue = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--admit-max-defer-ns") == 0 && i + 1 < argc)
+            admit.max_deferral = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-deadlines") == 0)
+            admit.deadline_check = true;
+        else if (strcmp(argv[i], "--irq-interval-ns") == 0 && i + 1 < argc)
+            irq.interval = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-hardirq-ns") == 0 && i + 1 < argc)
+            irq.hardirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-softirq-ns") == 0 && i + 1 < argc)
+            irq.softirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-burst") == 0 && i + 1 < argc)
+            irq.burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--irq-compare") == 0)
+            irq_compare = true;
+        else if (strcmp(argv[i], "--host-pcpus") == 0 && i + 1 < argc)
+            host.pcpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--host-policy") == 0 && i + 1 < argc)
+            host_policy = argv[++i];
+        else if (strcmp(argv[i], "--host-slice-ns") == 0 && i + 1 < argc)
+            host.slice = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--host-tenant-vcpus") == 0 && i + 1 < argc)
+            host.tenant_vcpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--guests") == 0 && i + 1 < argc)
+            host.guests = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--guest-weight") == 0 && i + 1 < argc)
+            host.guest_weight = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--progress-file") == 0 && i + 1 < argc)
+            stats_filename = argv[++i];
+        else if (strcmp(argv[i], "--progress-interval") == 0 && i + 1 < argc)
+            progress_interval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+            metrics_socket = argv[++i];
+        else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc)
+            metrics_file = argv[++i];
+        else if (strcmp(argv[i], "--metrics-interval") == 0 && i + 1 < argc)
+            metrics_interval = atoi(argv[++i]);
+        else
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (time_unit < 1)
+    {
+        printf("Invalid time unit: %lld ns (must be at least 1)\n", (long long)time_unit);
+        return 1;
+    }
+    if (small_queue_max < 0 || small_queue_max > SMALL_QUEUE_CAPACITY)
+    {
+        printf("Invalid small queue size: %d (must be 0 to %d)\n", small_queue_max, SMALL_QUEUE_CAPACITY);
+        return 1;
+    }
+    if (cfs.min_granularity < 0)
+        cfs.min_granularity = DEFAULT_MIN_GRANULARITY * time_unit;
+    if (cfs.latency < 0)
+        cfs.latency = DEFAULT_LATENCY * time_unit;
+    cfs.target_latency = cfs.latency; // Initial target latency
+
+    if (ticks.hz > 0)
+    {
+        ticks.period = 1000000000LL / ticks.hz;
+        if (ticks.period < 1 || ticks.overhead < 0 || ticks.overhead >= ticks.period)
+        {
+            printf("Invalid tick settings: %lld HZ with %lld ns overhead per tick\n",
+                   (long long)ticks.hz, (long long)ticks.overhead);
+            return 1;
+        }
+        tick_model = &ticks;
+    }
+
+    if (idle_states != NULL || idle_governor != NULL || idle.latency_limit >= 0)
+    {
+        if (parseIdleStates(&idle, idle_states != NULL ? idle_states : DEFAULT_IDLE_STATES) < 1)
+        {
+            printf("Invalid idle states: %s\n", idle_states);
+            return 1;
+        }
+        int governor = parseIdleGovernor(idle_governor != NULL ? idle_governor : "menu");
+        if (governor < 0)
+        {
+            printf("Unknown idle governor: %s\n", idle_governor);
+            return 1;
+        }
+        idle.governor = (IdleGovernor)governor;
+        idle_model = &idle;
+    }
+
+    if (admit.horizon < 0)
+        admit.horizon = DEFAULT_ADMISSION_HORIZON * time_unit;
+    if (admit.max_utilization < 0 || admit.horizon < 1 || admit.max_queue < 0 || admit.max_deferral < 0)
+    {
+        printf("Invalid admission settings\n");
+        return 1;
+    }
+    if (admit.max_utilization > 0 || admit.max_queue > 0 || admit.deadline_check)
+        admission = &admit;
+
+    if (irq.interval > 0)
+    {
+        // The handlers must leave the CPU some time, or no process ever finishes
+        if (irq.hardirq < 0 || irq.softirq < 0 || irq.burst < 1.0 || irq.hardirq + irq.softirq >= irq.interval)
+        {
+            printf("Invalid interrupt settings: %lld ns handlers every %lld ns in bursts of %g\n",
+                   (long long)(irq.hardirq + irq.softirq), (long long)irq.interval, irq.burst);
+            return 1;
+        }
+        irq.seed = sampling.seed;
+        irq_model = &irq;
+    }
+
+    if (host.pcpus != 0 || host_policy != NULL)
+    {
+        int policy = parseHostPolicy(host_policy != NULL ? host_policy : "credit");
+        if (policy < 0)
+        {
+            printf("Unknown host policy: %s\n", host_policy);
+            return 1;
+        }
+        host.policy = (HostPolicy)policy;
+        if (host.pcpus == 0)
+            host.pcpus = 1;
+        if (host.slice < 0)
+            host.slice = host.policy == HOST_CREDIT ? DEFAULT_CREDIT_SLICE_NS : DEFAULT_HOST_LATENCY_NS;
+        if (host.pcpus < 1 || host.guests < 1 || host.tenant_vcpus < 0 || host.guest_weight < 1 || host.slice < 1)
+        {
+            printf("Invalid host settings\n");
+            return 1;
+        }
+    }
+
+    // SIGUSR1 (and --progress-interval) dump live progress to stderr or --progress-file
+    startProgressReporting(stats_filename, progress_interval);
+
+    // --metrics-socket and --metrics-file export Prometheus metrics from a separate thread
+    if (metrics_socket != NULL || metrics_file != NULL)
+    {
+        if (metrics_interval < 1)
+        {
+            printf("Invalid metrics interval: %d s\n", metrics_interval);
+            return 1;
+        }
+        exporter = startMetricsExporter(METRICS_SCHEDULER, metrics_socket, metrics_file, metrics_interval);
+        if (exporter == NULL)
+        {
+            printf("Error starting metrics exporter on %s\n", metrics_socket != NULL ? metrics_socket : metrics_file);
+            return 1;
+        }
+        atexit(stopMetricsExporter);
+    }
+
+    if (steady.enabled)
+    {
+        SteadyState state;
+        n = generateSyntheticProcesses(&processes, &steady);
+        initializeSteadyState(&state, &steady);
+        steady_state = &state;
+
+        runCFS(processes, n, &cfs);
+        if (!state.converged)
+            evaluateSteadyState(&state);
+        displaySteadyState(&state);
+
+        steady_state = NULL;
+        freeSteadyState(&state);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (first_option == 1)
+        printf("No input file specified. Using default: input.txt\n");
+
     // Read processes from file
-    n = readProcessesFromFile(processes, filename);
+    n = readProcessesFromFile(&processes, filename);
+
+    if (sampling.enabled)
+    {
+        runSampling(processes, n, runSampledCFS, &cfs, &sampling);
+        free(processes);
+        return 0;
+    }
+
+    if (tick_compare && tick_model != NULL)
+    {
+        runTickComparison(processes, n, &cfs, tick_model);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (irq_compare && irq_model != NULL)
+    {
+        runInterruptComparison(processes, n, &cfs, irq_model);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (host.pcpus > 0)
+    {
+        // The guests run side by side and these keep the state of one run
+        if (tick_model != NULL || idle_model != NULL || admission != NULL || irq_model != NULL || gantt_filename != NULL ||
+            stats_filename != NULL || progress_interval > 0 || metrics_socket != NULL || metrics_file != NULL)
+        {
+            printf("Invalid host settings: tick, idle, admission and interrupt models, progress reporting, the metrics exporter and the Gantt chart cannot be used with a host\n");
+            return 1;
+        }
+        runHostedGuests(processes, n, &host, runSampledCFS, &cfs);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
 
     // Run the CFS algorithm
     runCFS(processes, n, &cfs);
 
+    if (gantt_filename != NULL)
+        writeGanttChart(gantt_filename);
+
     // Display results
-    /*displayProcessDetails(processes, n);*/
+    if (process_details)
+        displayProcessDetails(processes, n);
     // displayGanttChart();
     displayMetrics();
-
-
+    if (tick_model != NULL)
+        displayTickStats(tick_model);
+    if (idle_model != NULL)
+        displayIdleStats(idle_model);
+    if (admission != NULL)
+        displayAdmissionStats(admission, processes, n);
+    if (irq_model != NULL)
+        displayInterruptStats(irq_model, processes, n);
+
+    free(admit.deferred);
+    free(processes);
+    free(gantt_chart);
     return 0;
 }
@@ -1,40 +1,77 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 
-#define MAX_PROCESSES 100
-#define MAX_QUEUE_SIZE 100
-#define MAX_GANTT_CHART_SIZE 1000
-#define MAX_FILENAME_LENGTH 256
+#include "sim-common.h"
+
+#define STARVATION_THRESHOLD 20 // Time units
+#define AGING_HORIZON 10 // Waiting time units for full aging effect
+#define DEFAULT_BASE_QUANTUM 4 // Time units
+#define SMALL_QUEUE_CAPACITY 32
+#define SMALL_QUEUE_NETWORK_SIZE 4096 // Comparators of the networks for all lengths up to SMALL_QUEUE_CAPACITY
+#define DEFAULT_SMALL_QUEUE 32 // Queues up to this length are ordered by the sorting network
+#define SLO_CLASSES 11          // Criticality classes 1-10; index 0 is unused
+#define SLO_WINDOW 128          // Recent response times kept per class for the live percentile
+#define SLO_MIN_SAMPLES 20      // Samples a class needs before the controller acts on it
+#define SLO_UPDATE_INTERVAL 16  // Dispatches of new processes between controller updates
+#define SLO_BOOST_STEP 0.1      // Queue precedence added per unit of relative SLO violation
+#define SLO_MAX_BOOST 2.0
+#define SLO_BOOST_DECAY 0.9     // Boost kept per update while a class has slack
+#define SLO_SLACK 0.8           // A class has slack below this fraction of its target
+#define SLO_URGENCY 0.5         // Fraction of the target after which a waiting process jumps the queue
+#define SLO_MIN_BATCH_SCALE 0.25
+#define SLO_MAX_BATCH_SCALE 2.0
+#define METRICS_SCHEDULER "dps-dtq"
+#define NO_DEADLINE (INT64_MAX / 2) // Laxity key of processes without a deadline, before their arrival time
+#define LAXITY_HEAP 0
+#define DEADLINE_HEAP 1
+#define CRITICALITY_BANDS 11 // Criticality bands 1-10 of the banded queue; index 0 is unused
+#define MAX_LOCK_CPUS 1024
+#define DEFAULT_LOCK_BASE_NS 100
+#define DEFAULT_LOCK_ELEMENT_NS 10
+#define DEFAULT_LOCK_WAKE_NS 2000
+#define LOCK_SCALING_TOLERANCE 0.1 // Turnaround excess over per-CPU queues a shared queue may have
 
 // Process structure
-typedef struct
+struct Process
 {
     int id;
-    int arrival_time;
-    int burst_time;
-    int remaining_burst;
-    int completion_time;
-    int waiting_time;
-    int turnaround_time;
-    int response_time;
-    int first_execution_time; // For response time calculation
-    int deadline;             // For real-time processes
-    int criticality;          // Higher for safety-critical tasks (1-10)
-    int period;               // For periodic tasks
+    int64_t arrival_time;         // All times are in nanoseconds
+    int64_t burst_time;           // Actual execution time
+    int64_t estimated_burst;      // Execution time given by the trace
+    int64_t predicted_burst;      // Execution time the policy sees
+    int64_t remaining_burst;
+    int64_t completion_time;
+    int64_t waiting_time;
+    int64_t turnaround_time;
+    int64_t response_time;
+    int64_t first_execution_time; // For response time calculation
+    int64_t deadline;             // For real-time processes
+    int criticality;              // Higher for safety-critical tasks (1-10)
+    int64_t period;               // For periodic tasks
     int system_priority;      // Manual override or industry standard
     bool executed;            // Flag to check if process has started execution
     bool completed;           // Flag to check if process has completed
-} Process;
+    bool rejected; // Shed by admission control
+    SchedStat stat;
+    int heap_slot[2];         // Positions in the deadline policy heaps
+    int band;                 // Banded queue the process waits in
+    int64_t band_since;       // When it entered that band
+    struct Process *band_next;
+    int64_t guard_due;        // When the bounded-wait guard dispatches it at the latest
+    int guard_slot;           // Position in the guard's heap
+    int queue_slot;           // Position in the ready queue ring
+};
 
 // Dynamic Time Quantum structure
 typedef struct
 {
-    double base;               // Base time quantum
-    double current;            // Current time quantum after adjustment
+    int64_t base;              // Base time quantum (ns)
+    double current;            // Current time quantum after adjustment (ns)
     double load_factor;        // CPU load factor (0.0 to 1.0)
     double criticality_weight; // Weight for criticality (Wc)
     double deadline_weight;    // Weight for deadline (Wf)
@@ -42,23 +79,143 @@ typedef struct
     double priority_weight;    // Weight for system priority (Ws)
 } DynamicQuantum;
 
+// Live state of one criticality class under SLO mode
+typedef struct
+{
+    int64_t target;             // Response time target (ns) at the SLO percentile, 0 for batch
+    int64_t window[SLO_WINDOW]; // Most recent response times (ns), used as a ring
+    long long samples;
+    double boost;               // Queue precedence over classes with a lower boost
+    double quantum_scale;       // Multiplies the dynamic quantum of the class
+} SloClass;
+
+// SLO mode: classes with a response time target get precedence until their live
+// percentile meets it, and batch classes get longer quanta while all have slack
+typedef struct
+{
+    SloClass classes[SLO_CLASSES];
+    double percentile;
+    int pending; // Samples since the last controller update
+    long long updates;
+    double batch_scale;
+} SloController;
+
+// Scheduling policy deciding the dispatch order and slice length
+typedef enum
+{
+    POLICY_DPS_DTQ, // Dynamic priority order with a dynamic time quantum
+    POLICY_LLF,     // Least laxity first
+    POLICY_EDZL,    // Earliest deadline first until a waiting process reaches zero laxity
+    POLICY_BANDED   // DPS-DTQ with a FIFO per criticality band served by weighted round-robin
+} SchedulingPolicy;
+
+// Ready processes of the deadline policies. The laxity of a waiting process
+// (deadline - now - remaining) falls at the same rate for all of them, so a
+// heap keyed by deadline - remaining stays ordered without rekeying; only the
+// dispatched process changes its key, and it is out of the heaps meanwhile.
+typedef struct
+{
+    SchedulingPolicy policy;
+    int64_t min_slice;  // Shortest slice a laxity change may end (ns)
+    Process **heap[2];  // Indexed min-heaps by laxity key and, for EDZL, by deadline
+    int size;
+    int capacity;
+    long long guarded;  // Slices the minimum slice lengthened
+} DeadlinePolicy;
+
+// Ready processes of the banded variant: one FIFO per criticality band. A
+// round serves the bands from the highest down, each for as many dispatches
+// as its criticality, and a process that has waited AGING_HORIZON time units
+// at the head of its band moves up one band, so a dispatch costs
+// O(CRITICALITY_BANDS) whatever the queue length.
+typedef struct
+{
+    Process *head[CRITICALITY_BANDS];
+    Process *tail[CRITICALITY_BANDS];
+    int size[CRITICALITY_BANDS];
+    int cursor;  // Band served in the current round
+    int credits; // Dispatches left to the band in this round
+    long long promotions;
+    long long dispatches[CRITICALITY_BANDS];
+} BandedQueue;
+
+// Bounded-wait guard of the sorted queue: a ready process is due max_wait
+// after it became runnable, and due processes are dispatched ahead of the
+// priority order, earliest due first. The heap by due time makes the check
+// O(1) and each insertion and removal O(log n). Before each dispatch every
+// due process moves from the heap to a FIFO, which is served before the
+// queue is sorted again.
+typedef struct
+{
+    int64_t max_wait;     // ns
+    Process **heap;
+    int size;
+    int capacity;
+    Process **due;        // Ring of released processes, earliest due first
+    int due_head;
+    int due_count;
+    long long dispatches; // Processes dispatched ahead of the priority order
+} WaitGuard;
+
+// Run queue organisation of the lock contention model
+typedef enum
+{
+    RUNQUEUE_SHARED, // One queue and lock for all CPUs
+    RUNQUEUE_PER_CPU // A queue and lock per CPU
+} RunQueueKind;
+
+// Ready structure whose operations the run queue lock is held for
+typedef enum
+{
+    STRUCTURE_FIFO,   // O(1) enqueue and dispatch
+    STRUCTURE_HEAP,   // O(log n) enqueue and dispatch
+    STRUCTURE_SORTED  // O(1) enqueue, O(n log n) re-sort per dispatch
+} QueueStructure;
+
+// Lock contention model: every enqueue and dispatch on a run queue holds its
+// lock for a cost that grows with the queue as the structure's operation
+// does, and CPUs that find the lock held spin or sleep
+typedef struct
+{
+    int cpus;              // Largest CPU count simulated
+    QueueStructure structure;
+    bool sleep;            // Waiting CPUs sleep instead of spinning
+    int64_t base_cost;     // ns any lock hold costs
+    int64_t element_cost;  // ns per element the operation touches
+    int64_t wake_latency;  // ns from release until a sleeping waiter holds the lock
+} LockModel;
+
+// Outcome of one contention run
+typedef struct
+{
+    int64_t makespan;
+    double avg_turnaround; // Time units
+    double avg_response;
+    int64_t lock_wait;     // ns CPUs spun or slept waiting for locks
+    int64_t lock_held;     // ns the busiest lock was held
+    int64_t overhead;      // ns CPUs held locks
+    bool stable;           // The CPUs had capacity for the work, lock holds and spinning the trace brought
+} ContentionResult;
+
+// Next slice end or wakeup of a CPU
+typedef struct
+{
+    int64_t time;
+    int cpu;
+} CpuEvent;
+
 // Ready Queue structure
 typedef struct
 {
-    Process *processes[MAX_QUEUE_SIZE];
+    Process **processes;
+    Process **scratch; // Merge buffer for sorting long queues
     int front;
     int rear;
     int size;
+    int capacity;
+    int holes; // Slots of processes taken out of the middle, dropped at the next sort
 } ReadyQueue;
 
-// Gantt Chart structure
-typedef struct
-{
-    int process_id;
-    int start_time;
-    int end_time;
-} GanttChartItem;
-
 // Benchmarking metrics
 typedef struct
 {
@@ -69,38 +226,137 @@ typedef struct
     double fairness_index; // Jain's fairness index
     int starvation_count;  // Number of starved processes
     double load_balancing_efficiency;
+    long long context_switches; // Dispatches of a different process than the previous one
+    int64_t worst_wait;         // Longest a ready process waited for a slice (ns)
 } Metrics;
 
+// Settings of the runs of a before/after comparison
+typedef struct
+{
+    DynamicQuantum *dtq;
+    TickModel *ticks;
+    InterruptModel *irq;
+    DeadlinePolicy *policy;
+    BandedQueue *bands;
+    WaitGuard *guard;
+} Comparison;
+
 // Global variables
-Process processes[MAX_PROCESSES];
-GanttChartItem gantt_chart[MAX_GANTT_CHART_SIZE];
-int gantt_chart_size = 0;
+Process *processes = NULL;
 Metrics metrics;
+int small_queue_max = DEFAULT_SMALL_QUEUE;
+SloController *slo = NULL;
+DeadlinePolicy *deadline_policy = NULL;
+BandedQueue *banded_queue = NULL;
+WaitGuard *wait_guard = NULL;
 
 // Function prototypes
-void initializeQueue(ReadyQueue *queue);
+void initializeQueue(ReadyQueue *queue, int capacity);
+void freeQueue(ReadyQueue *queue);
 bool isQueueEmpty(ReadyQueue *queue);
 bool isQueueFull(ReadyQueue *queue);
 void enqueue(ReadyQueue *queue, Process *process);
 Process *dequeue(ReadyQueue *queue);
-void calculateDynamicPriority(Process *process, int current_time, DynamicQuantum *dtq);
-double calculateAgingFactor(Process *process, int current_time);
-void sortQueueByPriority(ReadyQueue *queue, int current_time, DynamicQuantum *dtq);
+void calculateDynamicPriority(Process *process, int64_t current_time, DynamicQuantum *dtq);
+double calculateAgingFactor(Process *process, int64_t current_time);
+bool sloUrgent(Process *process, int64_t current_time);
+bool runsBefore(Process *a, Process *b, int64_t current_time);
+int buildSortingNetworks(int pairs[][2], int *first);
+void sortingNetwork(int64_t *keys, int count);
+void sortSmallQueue(ReadyQueue *queue);
+void mergeSortQueue(ReadyQueue *queue, int64_t current_time);
+void sortQueueByPriority(ReadyQueue *queue, int64_t current_time, DynamicQuantum *dtq);
 void runDPS_DTQ(Process *processes, int n, DynamicQuantum *dtq);
-void calculateMetrics(Process *processes, int n, int total_time);
-void displayGanttChart();
+void calculateMetrics(Process *processes, int n, int64_t total_time);
 void displayProcessDetails(Process *processes, int n);
 void displayMetrics();
-void addToGanttChart(int process_id, int start_time, int end_time);
-int readProcessesFromFile(Process *processes, const char *filename);
+int readProcessesFromFile(Process **processes, const char *filename);
 void writeDefaultInputFile(const char *filename);
+void runSampledDPS_DTQ(Process *processes, int n, void *context, double *averages);
+int64_t arrivalTimeAfter(Process *processes, int n, int64_t time, bool sorted);
+int64_t nextArrivalAfter(Process *processes, int n, int64_t time, bool sorted);
+void resetProcessState(Process *process);
+void metricValues(Metrics *run_metrics, double *values);
+void runTickVariant(Process *processes, int n, int variant, double *values, void *context);
+void runTickComparison(Process *processes, int n, DynamicQuantum *dtq, TickModel *model);
+void runInterruptVariant(Process *processes, int n, int variant, double *values, void *context);
+void runInterruptComparison(Process *processes, int n, DynamicQuantum *dtq, InterruptModel *model);
+int sloClass(Process *process);
+int parseSloTargets(SloController *controller, const char *spec);
+void resetSlo(SloController *controller);
+void updateSloController(SloController *controller);
+void recordSloSample(SloController *controller, Process *process, int64_t response_time);
+void displaySloAttainment(SloController *controller, Process *processes, int n);
+void sampleActualBursts(Process *processes, int n, BurstDistribution distribution, double sigma);
+void predictArrival(Process *process);
+void observeBurst(Process *process);
+int64_t visibleRemaining(Process *process);
+int parsePolicy(const char *name);
+void resetDeadlinePolicy(DeadlinePolicy *dp, int n);
+int64_t policyKey(Process *process, int heap);
+bool policyBefore(Process *a, Process *b, int heap);
+void siftPolicyHeap(DeadlinePolicy *dp, int heap, int slot);
+void pushDeadlinePolicy(DeadlinePolicy *dp, Process *process);
+void removeDeadlinePolicy(DeadlinePolicy *dp, Process *process);
+Process *selectDeadlinePolicy(DeadlinePolicy *dp, int64_t current_time);
+int64_t deadlinePolicySlice(DeadlinePolicy *dp, Process *process, int64_t current_time, int64_t next_arrival);
+void resetBandedQueue(BandedQueue *bq);
+int baseBand(Process *process);
+void appendToBand(BandedQueue *bq, Process *process, int band, int64_t since);
+Process *removeBandHead(BandedQueue *bq, int band);
+void pushBandedQueue(BandedQueue *bq, Process *process);
+Process *selectBandedQueue(BandedQueue *bq, int64_t current_time, int n, DynamicQuantum *dtq);
+void displayPolicyStats(SchedulingPolicy policy, Process *processes, int n);
+void runPolicyVariant(Process *processes, int n, int variant, double *values, void *context);
+void runPolicyComparison(Process *processes, int n, DynamicQuantum *dtq, SchedulingPolicy policy);
+void resetWaitGuard(WaitGuard *guard, int n);
+bool dueBefore(Process *a, Process *b);
+void siftWaitGuard(WaitGuard *guard, int slot);
+void pushWaitGuard(WaitGuard *guard, Process *process);
+void removeWaitGuard(WaitGuard *guard, Process *process);
+void compactQueue(ReadyQueue *queue);
+void removeFromQueue(ReadyQueue *queue, Process *process);
+void releaseDueProcesses(WaitGuard *guard, int64_t current_time);
+Process *takeDueProcess(WaitGuard *guard, ReadyQueue *queue, int64_t current_time);
+int64_t longestWaitingTime(Process *processes, int n);
+void displayWaitGuardStats(WaitGuard *guard, Process *processes, int n);
+void runWaitGuardVariant(Process *processes, int n, int variant, double *values, void *context);
+void runWaitGuardComparison(Process *processes, int n, DynamicQuantum *dtq, WaitGuard *guard);
+int parseQueueStructure(const char *name);
+int64_t lockHoldCost(LockModel *model, int length, bool dispatch);
+int64_t acquireLock(LockModel *model, int64_t *free_at, int64_t request, int64_t hold, bool sleep, int64_t *waited);
+int compareArrival(const void *a, const void *b);
+void pushCpuEvent(CpuEvent *heap, int *size, int64_t time, int cpu);
+CpuEvent popCpuEvent(CpuEvent *heap, int *size);
+void simulateContention(Process *processes, int n, LockModel *model, RunQueueKind kind, int cpus,
+                        DynamicQuantum *dtq, ContentionResult *result);
+void runLockContention(Process *processes, int n, DynamicQuantum *dtq, LockModel *model);
 
 // Initialize the ready queue
-void initializeQueue(ReadyQueue *queue)
+void initializeQueue(ReadyQueue *queue, int capacity)
 {
+    queue->processes = (Process **)malloc(sizeof(Process *) * capacity);
+    queue->scratch = (Process **)malloc(sizeof(Process *) * capacity);
+    if (queue->processes == NULL || queue->scratch == NULL)
+    {
+        printf("Not enough memory for a ready queue of %d processes\n", capacity);
+        exit(1);
+    }
     queue->front = 0;
     queue->rear = -1;
     queue->size = 0;
+    queue->capacity = capacity;
+    queue->holes = 0;
+}
+
+// Release the ready queue storage
+void freeQueue(ReadyQueue *queue)
+{
+    free(queue->processes);
+    free(queue->scratch);
+    queue->processes = NULL;
+    queue->scratch = NULL;
+    queue->capacity = 0;
 }
 
 // Check if the queue is empty
@@ -112,7 +368,7 @@ bool isQueueEmpty(ReadyQueue *queue)
 // Check if the queue is full
 bool isQueueFull(ReadyQueue *queue)
 {
-    return queue->size == MAX_QUEUE_SIZE;
+    return queue->size == queue->capacity;
 }
 
 // Add a process to the queue
@@ -124,9 +380,29 @@ void enqueue(ReadyQueue *queue, Process *process)
         return;
     }
 
-    queue->rear = (queue->rear + 1) % MAX_QUEUE_SIZE;
+    // The deadline policies and the banded variant keep their ready processes
+    // in structures of their own
+    if (deadline_policy != NULL)
+    {
+        pushDeadlinePolicy(deadline_policy, process);
+        queue->size++;
+        return;
+    }
+    if (banded_queue != NULL)
+    {
+        pushBandedQueue(banded_queue, process);
+        queue->size++;
+        return;
+    }
+
+    if (queue->size + queue->holes == queue->capacity)
+        compactQueue(queue);
+    queue->rear = (queue->rear + 1) % queue->capacity;
     queue->processes[queue->rear] = process;
+    process->queue_slot = queue->rear;
     queue->size++;
+    if (wait_guard != NULL)
+        pushWaitGuard(wait_guard, process);
 }
 
 // Remove a process from the queue
@@ -137,22 +413,30 @@ Process *dequeue(ReadyQueue *queue)
         return NULL;
     }
 
+    while (queue->processes[queue->front] == NULL)
+    {
+        queue->front = (queue->front + 1) % queue->capacity;
+        queue->holes--;
+    }
+
     Process *process = queue->processes[queue->front];
-    queue->front = (queue->front + 1) % MAX_QUEUE_SIZE;
+    queue->front = (queue->front + 1) % queue->capacity;
     queue->size--;
+    if (wait_guard != NULL)
+        removeWaitGuard(wait_guard, process);
 
     return process;
 }
 
 // Calculate the aging factor for a process
-double calculateAgingFactor(Process *process, int current_time)
+double calculateAgingFactor(Process *process, int64_t current_time)
 {
     // Aging factor increases as the waiting time increases
-    int waiting_time = current_time - process->arrival_time -
-                       (process->burst_time - process->remaining_burst);
+    int64_t waiting_time = current_time - process->arrival_time -
+                           (process->burst_time - process->remaining_burst);
 
-    // Normalize aging factor between 0 and 1, with a max of 10 time units for full effect
-    double aging_factor = waiting_time > 0 ? (double)waiting_time / 10.0 : 0.0;
+    // Normalize aging factor between 0 and 1, with a max of AGING_HORIZON time units for full effect
+    double aging_factor = waiting_time > 0 ? (double)waiting_time / (AGING_HORIZON * time_unit) : 0.0;
     if (aging_factor > 1.0)
         aging_factor = 1.0;
 
@@ -160,7 +444,7 @@ double calculateAgingFactor(Process *process, int current_time)
 }
 
 // Calculate dynamic priority for a process
-void calculateDynamicPriority(Process *process, int current_time, DynamicQuantum *dtq)
+void calculateDynamicPriority(Process *process, int64_t current_time, DynamicQuantum *dtq)
 {
     double priority = 0.0;
 
@@ -171,14 +455,14 @@ void calculateDynamicPriority(Process *process, int current_time, DynamicQuantum
     double deadline_component = 0.0;
     if (process->deadline > 0)
     {
-        int time_to_deadline = process->deadline - current_time;
+        int64_t time_to_deadline = process->deadline - current_time;
         if (time_to_deadline <= 0)
         {
             deadline_component = 1.0; // Maximum priority if deadline passed or imminent
         }
         else
         {
-            deadline_component = 1.0 / (1.0 + time_to_deadline); // Inverse relation to time left
+            deadline_component = 1.0 / (1.0 + (double)time_to_deadline / time_unit); // Inverse relation to time left
         }
     }
 
@@ -186,7 +470,7 @@ void calculateDynamicPriority(Process *process, int current_time, DynamicQuantum
     double period_component = 0.0;
     if (process->period > 0)
     {
-        period_component = 1.0 / process->period; // Inverse relation to period
+        period_component = (double)time_unit / process->period; // Inverse relation to period
     }
 
     // Aging component (longer wait = higher priority)
@@ -204,59 +488,190 @@ void calculateDynamicPriority(Process *process, int current_time, DynamicQuantum
     // Adjust dynamic time quantum based on priority and load
     dtq->current = dtq->base * (1.0 + priority) * (1.0 - 0.5 * dtq->load_factor);
 
+    // SLO mode reallocates quantum between the classes (and orders the queue, see runsBefore)
+    if (slo != NULL)
+        dtq->current *= slo->classes[sloClass(process)].quantum_scale;
+
     // Store the calculated priority in the remaining_burst for comparison (for sorting)
     // This is just a hack for the demo - in a real implementation, we'd add a priority field
     process->system_priority = (int)(priority * 100); // Scale for easier comparison
 }
 
-// Sort the queue based on calculated priorities
-void sortQueueByPriority(ReadyQueue *queue, int current_time, DynamicQuantum *dtq)
+// Whether a process of an SLO class has waited long enough for its first
+// dispatch that it is about to miss the response time target
+bool sloUrgent(Process *process, int64_t current_time)
 {
-    // Calculate priorities for all processes in the queue
-    for (int i = 0; i < queue->size; i++)
+    int64_t target = slo->classes[sloClass(process)].target;
+    return target > 0 && !process->executed && current_time - process->arrival_time >= SLO_URGENCY * target;
+}
+
+// Whether a goes before b in the ready queue. In SLO mode urgent processes
+// go first by response deadline, then classes boosted by the controller;
+// otherwise the queue is ordered by dynamic priority.
+bool runsBefore(Process *a, Process *b, int64_t current_time)
+{
+    if (slo != NULL)
     {
-        int idx = (queue->front + i) % MAX_QUEUE_SIZE;
-        calculateDynamicPriority(queue->processes[idx], current_time, dtq);
+        bool urgent_a = sloUrgent(a, current_time);
+        bool urgent_b = sloUrgent(b, current_time);
+        if (urgent_a != urgent_b)
+            return urgent_a;
+        if (urgent_a)
+            return a->arrival_time + slo->classes[sloClass(a)].target <
+                   b->arrival_time + slo->classes[sloClass(b)].target;
+
+        double boost_a = slo->classes[sloClass(a)].boost;
+        double boost_b = slo->classes[sloClass(b)].boost;
+        if (boost_a != boost_b)
+            return boost_a > boost_b;
     }
+    return a->system_priority > b->system_priority;
+}
 
-    // Simple bubble sort for demonstration (not efficient for large queues)
-    for (int i = 0; i < queue->size - 1; i++)
+// Build the comparators of Batcher's odd-even merge sort network for every
+// queue length up to SMALL_QUEUE_CAPACITY, skipping the wires past the length
+int buildSortingNetworks(int pairs[][2], int *first)
+{
+    int total = 0;
+    for (int count = 0; count <= SMALL_QUEUE_CAPACITY; count++)
     {
-        for (int j = 0; j < queue->size - i - 1; j++)
+        first[count] = total;
+        for (int p = 1; p < count; p += p)
         {
-            int idx1 = (queue->front + j) % MAX_QUEUE_SIZE;
-            int idx2 = (queue->front + j + 1) % MAX_QUEUE_SIZE;
-
-            if (queue->processes[idx1]->system_priority < queue->processes[idx2]->system_priority)
+            for (int k = p; k >= 1; k /= 2)
             {
-                // Swap processes
-                Process *temp = queue->processes[idx1];
-                queue->processes[idx1] = queue->processes[idx2];
-                queue->processes[idx2] = temp;
+                for (int j = k % p; j + k < count; j += 2 * k)
+                {
+                    for (int i = 0; i < k && i + j + k < count; i++)
+                    {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                        {
+                            pairs[total][0] = i + j;
+                            pairs[total][1] = i + j + k;
+                            total++;
+                        }
+                    }
+                }
             }
         }
     }
+    first[SMALL_QUEUE_CAPACITY + 1] = total;
+    return total;
+}
+
+// Sort count distinct keys with the network for that length; each step is a
+// branch-free min/max
+void sortingNetwork(int64_t *keys, int count)
+{
+    static int pairs[SMALL_QUEUE_NETWORK_SIZE][2];
+    static int first[SMALL_QUEUE_CAPACITY + 2];
+    static bool built = false;
+    if (!built)
+    {
+        buildSortingNetworks(pairs, first);
+        built = true;
+    }
+
+    for (int c = first[count]; c < first[count + 1]; c++)
+    {
+        int64_t a = keys[pairs[c][0]];
+        int64_t b = keys[pairs[c][1]];
+        keys[pairs[c][0]] = a < b ? a : b;
+        keys[pairs[c][1]] = a < b ? b : a;
+    }
+}
+
+// Order a short queue by descending priority through the sorting network.
+// Each key carries its queue slot in the low digits, so tying priorities
+// keep their order as in a stable sort.
+void sortSmallQueue(ReadyQueue *queue)
+{
+    int64_t keys[SMALL_QUEUE_CAPACITY];
+    for (int i = 0; i < queue->size; i++)
+    {
+        queue->scratch[i] = queue->processes[(queue->front + i) % queue->capacity];
+        keys[i] = ((int64_t)INT32_MAX - queue->scratch[i]->system_priority) * SMALL_QUEUE_CAPACITY + i;
+    }
+
+    sortingNetwork(keys, queue->size);
+
+    for (int i = 0; i < queue->size; i++)
+        queue->processes[i] = queue->scratch[keys[i] % SMALL_QUEUE_CAPACITY];
+    queue->front = 0;
+    queue->rear = queue->size - 1;
+}
+
+// Stable bottom-up merge sort of a long queue by runsBefore
+void mergeSortQueue(ReadyQueue *queue, int64_t current_time)
+{
+    Process **from = queue->scratch;
+    Process **to = queue->processes;
+    for (int i = 0; i < queue->size; i++)
+        from[i] = queue->processes[(queue->front + i) % queue->capacity];
+
+    for (int width = 1; width < queue->size; width *= 2)
+    {
+        for (int left = 0; left < queue->size; left += 2 * width)
+        {
+            int middle = left + width < queue->size ? left + width : queue->size;
+            int right = middle + width < queue->size ? middle + width : queue->size;
+            int a = left, b = middle, out = left;
+            while (a < middle && b < right)
+                to[out++] = runsBefore(from[b], from[a], current_time) ? from[b++] : from[a++];
+            while (a < middle)
+                to[out++] = from[a++];
+            while (b < right)
+                to[out++] = from[b++];
+        }
+        Process **swap = from;
+        from = to;
+        to = swap;
+    }
+
+    if (from != queue->processes)
+        memcpy(queue->processes, from, sizeof(Process *) * queue->size);
+    queue->front = 0;
+    queue->rear = queue->size - 1;
 }
 
-// Add an entry to the Gantt chart
-void addToGanttChart(int process_id, int start_time, int end_time)
+// Sort the queue based on calculated priorities
+void sortQueueByPriority(ReadyQueue *queue, int64_t current_time, DynamicQuantum *dtq)
 {
-    if (gantt_chart_size < MAX_GANTT_CHART_SIZE)
+    if (queue->holes > 0)
+        compactQueue(queue);
+
+    // Calculate priorities for all processes in the queue
+    for (int i = 0; i < queue->size; i++)
     {
-        gantt_chart[gantt_chart_size].process_id = process_id;
-        gantt_chart[gantt_chart_size].start_time = start_time;
-        gantt_chart[gantt_chart_size].end_time = end_time;
-        gantt_chart_size++;
+        int idx = (queue->front + i) % queue->capacity;
+        calculateDynamicPriority(queue->processes[idx], current_time, dtq);
     }
+
+    // Short queues are ordered by priority alone through the sorting network;
+    // long queues, and SLO mode with its urgency and class boosts, by merge sort
+    if (slo == NULL && queue->size <= small_queue_max)
+        sortSmallQueue(queue);
     else
+        mergeSortQueue(queue, current_time);
+
+    // The guard takes due processes out of the queue by their slots
+    if (wait_guard != NULL)
     {
-        printf("Gantt chart is full!\n");
+        for (int i = 0; i < queue->size; i++)
+            queue->processes[i]->queue_slot = i;
     }
 }
 
-// Function to read processes from a file
-int readProcessesFromFile(Process *processes, const char *filename)
+// Function to read processes from a file into a newly allocated array
+int readProcessesFromFile(Process **out, const char *filename)
 {
+    // Traces prepared by trace-prep are mapped instead of parsed
+    int prepared = readPreparedTrace(out, filename);
+    if (prepared < 0)
+        exit(1);
+    if (prepared > 0)
+        return prepared;
+
     FILE *file = fopen(filename, "r");
     if (file == NULL)
     {
@@ -281,23 +696,32 @@ int readProcessesFromFile(Process *processes, const char *filename)
         exit(1);
     }
 
-    if (n <= 0 || n > MAX_PROCESSES)
+    if (n <= 0)
+    {
+        printf("Invalid number of processes: %d (must be at least 1)\n", n);
+        fclose(file);
+        exit(1);
+    }
+
+    Process *processes = (Process *)malloc(sizeof(Process) * n);
+    if (processes == NULL)
     {
-        printf("Invalid number of processes: %d (must be between 1 and %d)\n", n, MAX_PROCESSES);
+        printf("Not enough memory for %d processes\n", n);
         fclose(file);
         exit(1);
     }
 
-    // Read process data
+    // Read process data; times are given in time units and kept in ns
     for (int i = 0; i < n; i++)
     {
-        if (fscanf(file, "%d %d %d %d %d %d %d",
+        long long arrival_time, burst_time, deadline, period;
+        if (fscanf(file, "%d %lld %lld %lld %d %lld %d",
                    &processes[i].id,
-                   &processes[i].arrival_time,
-                   &processes[i].burst_time,
-                   &processes[i].deadline,
+                   &arrival_time,
+                   &burst_time,
+                   &deadline,
                    &processes[i].criticality,
-                   &processes[i].period,
+                   &period,
                    &processes[i].system_priority) != 7)
         {
             printf("Error reading data for process %d\n", i + 1);
@@ -305,21 +729,124 @@ int readProcessesFromFile(Process *processes, const char *filename)
             exit(1);
         }
 
-        // Initialize other fields
-        processes[i].remaining_burst = processes[i].burst_time;
-        processes[i].completion_time = 0;
-        processes[i].waiting_time = 0;
-        processes[i].turnaround_time = 0;
-        processes[i].response_time = 0;
-        processes[i].first_execution_time = -1;
-        processes[i].executed = false;
-        processes[i].completed = false;
+        processes[i].arrival_time = arrival_time * time_unit;
+        processes[i].burst_time = burst_time * time_unit;
+        processes[i].deadline = deadline * time_unit;
+        processes[i].period = period * time_unit;
+        resetProcessState(&processes[i]);
     }
 
     fclose(file);
+    *out = processes;
     return n;
 }
 
+// Initialize the simulation fields of a freshly loaded process
+void resetProcessState(Process *process)
+{
+    process->remaining_burst = process->burst_time;
+    process->estimated_burst = process->burst_time;
+    process->predicted_burst = process->burst_time;
+    process->completion_time = 0;
+    process->waiting_time = 0;
+    process->turnaround_time = 0;
+    process->response_time = 0;
+    process->first_execution_time = -1;
+    process->executed = false;
+    process->completed = false;
+    process->rejected = false;
+    memset(&process->stat, 0, sizeof(process->stat));
+}
+
+// Earliest arrival after the given time, or INT64_MAX if nothing arrives later
+int64_t arrivalTimeAfter(Process *processes, int n, int64_t time, bool sorted)
+{
+    if (sorted)
+    {
+        int next = firstArrivalAfter(processes, n, time);
+        return next < n ? processes[next].arrival_time : INT64_MAX;
+    }
+
+    int64_t next_arrival = INT64_MAX;
+    for (int i = 0; i < n; i++)
+    {
+        if (processes[i].arrival_time > time && processes[i].arrival_time < next_arrival)
+            next_arrival = processes[i].arrival_time;
+    }
+    return next_arrival;
+}
+
+// Earliest arrival after the given time, or time + 1 if nothing arrives later.
+// Idle periods jump straight to it instead of stepping through every ns.
+int64_t nextArrivalAfter(Process *processes, int n, int64_t time, bool sorted)
+{
+    int64_t next_arrival = arrivalTimeAfter(processes, n, time, sorted);
+    return next_arrival != INT64_MAX ? next_arrival : time + 1;
+}
+
+// Size of a process record, for the shared models
+const size_t process_size = sizeof(Process);
+
+// Fill in what the shared models read from a process
+void viewProcess(Process *process, ProcessView *view)
+{
+    view->arrival_time = process->arrival_time;
+    view->burst_time = process->burst_time;
+    view->work = visibleRemaining(process);
+    view->deadline = process->deadline;
+    view->completion_time = process->completion_time;
+    view->turnaround_time = process->turnaround_time;
+    view->waiting_time = process->waiting_time;
+    view->response_time = process->response_time;
+    view->starved = process->waiting_time > STARVATION_THRESHOLD * time_unit;
+    view->completed = process->completed;
+    view->shed = process->rejected;
+}
+
+// Element of a process array, for the shared models
+Process *processAt(Process *processes, int index)
+{
+    return &processes[index];
+}
+
+// Shed a process for admission control: it counts as done but never runs
+void markShed(Process *process)
+{
+    process->completed = true;
+    process->rejected = true;
+}
+
+// Scheduling statistics of a process, for the shared accounting
+SchedStat *processStat(Process *process)
+{
+    return &process->stat;
+}
+
+// Move a process offset earlier, for a trace window simulated from zero
+void shiftProcess(Process *process, int64_t offset)
+{
+    process->arrival_time -= offset;
+
+    // Deadlines are absolute; one already passed at the offset stays imminent
+    if (process->deadline > 0)
+        process->deadline = process->deadline - offset > 1 ? process->deadline - offset : 1;
+}
+
+// Set the trace fields of a process and reset its simulation state; the
+// priority is its system priority
+void initializeProcess(Process *process, int id, int64_t arrival_time, int64_t burst_time, int64_t deadline,
+                       int criticality, int64_t period, int priority)
+{
+    process->id = id;
+    process->arrival_time = arrival_time;
+    process->burst_time = burst_time;
+    process->deadline = deadline;
+    process->criticality = criticality;
+    process->period = period;
+    process->system_priority = priority;
+    resetProcessState(process);
+}
+
 // Function to write a default input file if none exists
 void writeDefaultInputFile(const char *filename)
 {
@@ -353,39 +880,91 @@ void writeDefaultInputFile(const char *filename)
 void runDPS_DTQ(Process *processes, int n, DynamicQuantum *dtq)
 {
     ReadyQueue ready_queue;
-    initializeQueue(&ready_queue);
 
-    int current_time = 0;
+    initializeQueue(&ready_queue, n);
+
+    int64_t current_time = 0;
     int completed_processes = 0;
     int idle_time = 0;
+    int64_t wakeup_delay = 0;
+    long long context_switches = 0;
+    int64_t worst_wait = 0;
+    Process *previous_process = NULL;
+    resetProgress(n);
+    if (tick_model != NULL)
+    {
+        tick_model->busy_ticks = 0;
+        tick_model->stolen_time = 0;
+    }
+    if (idle_model != NULL)
+        resetIdleModel(idle_model);
+    if (admission != NULL)
+        resetAdmission(admission, n);
+    if (irq_model != NULL)
+        resetInterrupts(irq_model);
+    if (burst_predictor != NULL)
+        resetPredictor(burst_predictor);
+    if (slo != NULL)
+        resetSlo(slo);
+    if (deadline_policy != NULL)
+        resetDeadlinePolicy(deadline_policy, n);
+    if (banded_queue != NULL)
+        resetBandedQueue(banded_queue);
+    if (wait_guard != NULL)
+        resetWaitGuard(wait_guard, n);
+
+    // Sorted traces (including synthetic ones) find arrivals by binary search
+    bool sorted = arrivalsSorted(processes, n);
 
     // Continue until all processes are completed
-    while (completed_processes < n)
+    // Processes shed by admission control never complete
+    while (completed_processes + (admission != NULL ? admission->rejected : 0) < n)
     {
         // Check for newly arrived processes
-        for (int i = 0; i < n; i++)
+        int from = sorted ? firstArrivalAfter(processes, n, current_time - 1) : 0;
+        int to = sorted ? firstArrivalAfter(processes, n, current_time) : n;
+        for (int i = from; i < to; i++)
         {
             if (processes[i].arrival_time == current_time)
             {
+                predictArrival(&processes[i]);
+                if (admission != NULL && !admitArrival(admission, &processes[i], current_time, ready_queue.size))
+                    continue;
                 enqueue(&ready_queue, &processes[i]);
             }
         }
 
-        // If ready queue is empty, increase time and continue
+        // Deferred processes are admitted as the ready queue drains
+        Process *released;
+        while (admission != NULL && (released = releaseDeferred(admission, current_time, ready_queue.size)) != NULL)
+        {
+            accountRelease(released, current_time);
+            enqueue(&ready_queue, released);
+        }
+
+        // If ready queue is empty, skip to the next arrival and continue
         if (isQueueEmpty(&ready_queue))
         {
-            current_time++;
+            int64_t idle_start = current_time;
+            current_time = nextArrivalAfter(processes, n, current_time, sorted);
+            if (idle_model != NULL)
+                wakeup_delay = enterIdleState(idle_model, current_time - idle_start);
+            if (irq_model != NULL)
+                wakeup_delay += interruptIdleDelay(irq_model, current_time);
+            if (host_model != NULL)
+                wakeup_delay += hostWakeDelay(host_model, idle_start, current_time);
             idle_time++;
             // Add idle time to Gantt chart
             if (idle_time == 1)
             {
-                addToGanttChart(-1, current_time - 1, current_time); // -1 represents idle
+                addToGanttChart(-1, idle_start, current_time); // -1 represents idle
             }
             else
             {
                 // Update the end time of the last idle entry
                 gantt_chart[gantt_chart_size - 1].end_time = current_time;
             }
+            updateProgress(current_time, completed_processes, 0);
             continue;
         }
         else
@@ -393,37 +972,126 @@ void runDPS_DTQ(Process *processes, int n, DynamicQuantum *dtq)
             idle_time = 0;
         }
 
-        // Update CPU load factor based on queue size
-        dtq->load_factor = (double)ready_queue.size / n;
+        // Waking from an idle state holds back the dispatch by its exit latency;
+        // processes arriving meanwhile are queued and the CPU stays idle
+        if (wakeup_delay > 0)
+        {
+            int64_t wake_end = current_time + wakeup_delay;
+            from = sorted ? firstArrivalAfter(processes, n, current_time) : 0;
+            to = sorted ? firstArrivalAfter(processes, n, wake_end - 1) : n;
+            for (int i = from; i < to; i++)
+            {
+                if (processes[i].arrival_time > current_time && processes[i].arrival_time < wake_end)
+                {
+                    predictArrival(&processes[i]);
+                    if (admission != NULL && !admitArrival(admission, &processes[i], current_time, ready_queue.size))
+                        continue;
+                    enqueue(&ready_queue, &processes[i]);
+                }
+            }
+            gantt_chart[gantt_chart_size - 1].end_time = wake_end;
+            current_time = wake_end;
+            wakeup_delay = 0;
+            continue;
+        }
+
+        Process *current_process;
+        if (deadline_policy != NULL)
+        {
+            current_process = selectDeadlinePolicy(deadline_policy, current_time);
+            ready_queue.size--;
+        }
+        else if (banded_queue != NULL)
+        {
+            current_process = selectBandedQueue(banded_queue, current_time, n, dtq);
+            ready_queue.size--;
+        }
+        else
+        {
+            // Update CPU load factor based on queue size
+            dtq->load_factor = (double)ready_queue.size / n;
 
-        // Sort the ready queue based on the dynamic priority
-        sortQueueByPriority(&ready_queue, current_time, dtq);
+            // A process past the maximum wait goes first, and the queue is
+            // not sorted for this dispatch
+            current_process = wait_guard != NULL ? takeDueProcess(wait_guard, &ready_queue, current_time) : NULL;
+            if (current_process == NULL)
+            {
+                // Sort the ready queue based on the dynamic priority
+                sortQueueByPriority(&ready_queue, current_time, dtq);
 
-        // Get the highest priority process
-        Process *current_process = dequeue(&ready_queue);
+                // Get the highest priority process
+                current_process = dequeue(&ready_queue);
+            }
+        }
+        if (current_process != previous_process)
+            context_switches++;
+        previous_process = current_process;
+        int64_t runnable_since = current_process->stat.runnable_since > current_process->arrival_time
+                                     ? current_process->stat.runnable_since
+                                     : current_process->arrival_time;
+        if (current_time - runnable_since > worst_wait)
+            worst_wait = current_time - runnable_since;
 
         // If process is executing for the first time, record response time
         if (!current_process->executed)
         {
             current_process->first_execution_time = current_time;
             current_process->executed = true;
+            if (slo != NULL)
+                recordSloSample(slo, current_process, current_time - current_process->arrival_time);
         }
 
-        // Calculate time quantum for this process
-        calculateDynamicPriority(current_process, current_time, dtq);
-        int time_quantum = (int)dtq->current;
-        if (time_quantum < 1)
-            time_quantum = 1; // Minimum time quantum
+        // Calculate time quantum for this process; the deadline policies run it
+        // until the next arrival or until a waiting process should preempt it
+        int64_t time_quantum;
+        if (deadline_policy != NULL)
+        {
+            time_quantum = deadlinePolicySlice(deadline_policy, current_process, current_time,
+                                               arrivalTimeAfter(processes, n, current_time, sorted));
+        }
+        else
+        {
+            // The banded variant computed the quantum of the band on dispatch
+            if (banded_queue == NULL)
+                calculateDynamicPriority(current_process, current_time, dtq);
+            time_quantum = (int64_t)dtq->current;
+            if (time_quantum < 1)
+                time_quantum = 1; // Minimum time quantum (1 ns)
+        }
 
         // Determine how long the process will run
-        int execution_time = (current_process->remaining_burst < time_quantum) ? current_process->remaining_burst : time_quantum;
+        int64_t execution_time = (current_process->remaining_burst < time_quantum) ? current_process->remaining_burst : time_quantum;
+        int64_t slice_start = current_time;
+        int64_t slice_end = current_time + execution_time;
+
+        // With a periodic tick the quantum only ends on a tick, and ticks steal CPU time
+        if (tick_model != NULL)
+            slice_end = tickedExecution(tick_model, current_time, time_quantum,
+                                        current_process->remaining_burst, &execution_time);
+
+        // Interrupts arriving during the slice preempt the process
+        if (irq_model != NULL)
+            slice_end = interruptedExecution(irq_model, slice_start, slice_end);
+
+        // Under a hypervisor the slice only advances while the vCPU holds a pCPU
+        if (host_model != NULL)
+            slice_end = hostExecution(host_model, slice_start, slice_end);
 
         // Add to Gantt chart
-        addToGanttChart(current_process->id, current_time, current_time + execution_time);
+        addToGanttChart(current_process->id, slice_start, slice_end);
 
-        // Update process information
+        // Update process information; the admitted backlog shrinks by the work the
+        // policy sees done, which includes any revision of a predicted burst
+        int64_t visible_before = visibleRemaining(current_process);
         current_process->remaining_burst -= execution_time;
-        current_time += execution_time;
+        if (admission != NULL)
+            admission->backlog -= visible_before -
+                                  (current_process->remaining_burst > 0 ? visibleRemaining(current_process) : 0);
+        accountSlice(current_process, slice_start, slice_end, execution_time, current_process->remaining_burst > 0);
+        current_time = slice_end;
+        progress.busy_time += slice_end - slice_start;
+        if (exporter != NULL)
+            metricsDispatch(execution_time);
 
         // Check if process is completed
         if (current_process->remaining_burst == 0)
@@ -434,6 +1102,15 @@ void runDPS_DTQ(Process *processes, int n, DynamicQuantum *dtq)
             current_process->waiting_time = current_process->turnaround_time - current_process->burst_time;
             current_process->response_time = current_process->first_execution_time - current_process->arrival_time;
             completed_processes++;
+            observeBurst(current_process);
+            recordProgressCompletion(current_process->turnaround_time, current_process->waiting_time,
+                                     current_process->response_time);
+            if (exporter != NULL)
+                metricsCompletion(current_process->completion_time, current_process->deadline);
+
+            // Synthetic runs stop once the steady-state estimates are precise enough
+            if (steady_state != NULL && recordObservation(steady_state, current_process, current_time))
+                break;
         }
         else
         {
@@ -441,31 +1118,51 @@ void runDPS_DTQ(Process *processes, int n, DynamicQuantum *dtq)
             enqueue(&ready_queue, current_process);
         }
 
-        // Check for newly arrived processes during this time slice
-        for (int i = 0; i < n; i++)
+        // Check for newly arrived processes during this time slice; arrivals at
+        // exactly current_time are queued by the next iteration, not here as well
+        from = sorted ? firstArrivalAfter(processes, n, slice_start) : 0;
+        to = sorted ? firstArrivalAfter(processes, n, current_time - 1) : n;
+        for (int i = from; i < to; i++)
         {
             if (!processes[i].executed &&
-                processes[i].arrival_time > current_time - execution_time &&
-                processes[i].arrival_time <= current_time)
+                processes[i].arrival_time > slice_start &&
+                processes[i].arrival_time < current_time)
             {
+                predictArrival(&processes[i]);
+                if (admission != NULL && !admitArrival(admission, &processes[i], current_time, ready_queue.size))
+                    continue;
                 enqueue(&ready_queue, &processes[i]);
             }
         }
+
+        updateProgress(current_time, completed_processes, ready_queue.size);
     }
 
-    // Calculate benchmarking metrics
-    calculateMetrics(processes, n, current_time);
+    freeQueue(&ready_queue);
+    if (tick_model != NULL)
+        tick_model->end_time = current_time;
+    if (irq_model != NULL)
+        irq_model->end_time = current_time;
+
+    // Calculate benchmarking metrics over the processes admission control did not shed
+    int admitted;
+    Process *kept = admittedProcesses(processes, n, &admitted);
+    calculateMetrics(kept, admitted, current_time);
+    metrics.context_switches = context_switches;
+    metrics.worst_wait = worst_wait;
+    if (kept != processes)
+        free(kept);
 }
 
 // Calculate various performance metrics
-void calculateMetrics(Process *processes, int n, int total_time)
+void calculateMetrics(Process *processes, int n, int64_t total_time)
 {
     double total_turnaround_time = 0.0;
     double total_waiting_time = 0.0;
     double total_response_time = 0.0;
     double sum_of_squares = 0.0;
     double sum = 0.0;
-    int starvation_threshold = 20; // Define starvation as waiting > 20 time units
+    int64_t starvation_threshold = STARVATION_THRESHOLD * time_unit; // Define starvation as waiting > 20 time units
     int starved_count = 0;
 
     for (int i = 0; i < n; i++)
@@ -485,13 +1182,13 @@ void calculateMetrics(Process *processes, int n, int total_time)
         }
     }
 
-    // Calculate average metrics
-    metrics.avg_turnaround_time = total_turnaround_time / n;
-    metrics.avg_waiting_time = total_waiting_time / n;
-    metrics.avg_response_time = total_response_time / n;
+    // Calculate average metrics (reported in time units)
+    metrics.avg_turnaround_time = total_turnaround_time / n / time_unit;
+    metrics.avg_waiting_time = total_waiting_time / n / time_unit;
+    metrics.avg_response_time = total_response_time / n / time_unit;
 
     // Calculate throughput (processes per unit time)
-    metrics.throughput = (double)n / total_time;
+    metrics.throughput = (double)n / ((double)total_time / time_unit);
 
     // Calculate Jain's fairness index
     // This ranges from 1/n (worst case) to 1 (best case)
@@ -517,150 +1214,1742 @@ void calculateMetrics(Process *processes, int n, int total_time)
     metrics.load_balancing_efficiency = 1.0 / (1.0 + coefficient_of_variation);
 }
 
-// Display Gantt chart
-void displayGanttChart()
+// Run DPS-DTQ on a copy of the parameters, for sampling mode and hosted guests
+void runSampledDPS_DTQ(Process *processes, int n, void *context, double *averages)
 {
-    printf("\n\nGantt Chart:\n");
+    DynamicQuantum params = *(DynamicQuantum *)context;
+    runDPS_DTQ(processes, n, &params);
 
-    // Print top border
-    printf(" ");
-    for (int i = 0; i < gantt_chart_size; i++)
+    if (averages != NULL)
     {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
-        {
-            printf("--");
-        }
-        printf(" ");
+        averages[0] = metrics.avg_turnaround_time;
+        averages[1] = metrics.avg_waiting_time;
+        averages[2] = metrics.avg_response_time;
+        averages[3] = metrics.starvation_count;
     }
-    printf("\n|");
+}
+
+// Summary metrics of a run, in the order displayMetrics reports them
+void metricValues(Metrics *run_metrics, double *values)
+{
+    values[0] = run_metrics->avg_turnaround_time;
+    values[1] = run_metrics->avg_waiting_time;
+    values[2] = run_metrics->avg_response_time;
+    values[3] = run_metrics->throughput;
+    values[4] = run_metrics->fairness_index;
+    values[5] = run_metrics->starvation_count;
+    values[6] = run_metrics->load_balancing_efficiency;
+}
+
+// One run of the tick comparison: tickless, then with the tick model
+void runTickVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    DynamicQuantum params = *comparison->dtq;
+    tick_model = variant ? comparison->ticks : NULL;
+    runDPS_DTQ(processes, n, &params);
+    metricValues(&metrics, values);
+}
+
+// Run the trace tickless and then with the tick model, and compare the metrics
+void runTickComparison(Process *processes, int n, DynamicQuantum *dtq, TickModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time",
+        "Throughput",
+        "Fairness Index",
+        "Starvation Count",
+        "Load Balancing Efficiency"};
+    Comparison comparison = {dtq, model};
+    char label[32];
+    snprintf(label, sizeof(label), "HZ=%lld", (long long)model->hz);
+
+    runComparison(processes, n, runTickVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "Tickless", label);
+    displayTickStats(model);
+}
+// SLO class of a process: its criticality clamped to 1-10
+int sloClass(Process *process)
+{
+    if (process->criticality < 1)
+        return 1;
+    if (process->criticality > SLO_CLASSES - 1)
+        return SLO_CLASSES - 1;
+    return process->criticality;
+}
 
-    // Print process IDs
-    for (int i = 0; i < gantt_chart_size; i++)
+// Parse "class:target_ns,..." where class is a criticality or a range lo-hi.
+// Returns the number of classes given a target, or -1 if the list is malformed.
+int parseSloTargets(SloController *controller, const char *spec)
+{
+    int count = 0;
+    while (*spec != '\0')
     {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
+        int low, high, used = 0;
+        long long target;
+        if (sscanf(spec, "%d-%d:%lld%n", &low, &high, &target, &used) != 3)
         {
-            if (gantt_chart[i].process_id == -1)
-            {
-                printf("I "); // I for Idle
-            }
-            else
-            {
-                printf("P%d", gantt_chart[i].process_id);
-            }
-            if (j < duration - 1)
-            {
-                printf(" ");
-            }
+            if (sscanf(spec, "%d:%lld%n", &low, &target, &used) != 2)
+                return -1;
+            high = low;
+        }
+        if (low < 1 || high > SLO_CLASSES - 1 || low > high || target < 1)
+            return -1;
+        for (int c = low; c <= high; c++)
+        {
+            if (controller->classes[c].target == 0)
+                count++;
+            controller->classes[c].target = target;
         }
-        printf("|");
+
+        spec += used;
+        if (*spec == ',')
+            spec++;
+        else if (*spec != '\0')
+            return -1;
     }
+    return count;
+}
 
-    // Print bottom border
-    printf("\n ");
-    for (int i = 0; i < gantt_chart_size; i++)
+// Forget the live percentiles and allocations before a run
+void resetSlo(SloController *controller)
+{
+    for (int c = 0; c < SLO_CLASSES; c++)
     {
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration; j++)
-        {
-            printf("--");
-        }
-        printf(" ");
+        controller->classes[c].samples = 0;
+        controller->classes[c].boost = 0.0;
+        controller->classes[c].quantum_scale = 1.0;
     }
+    controller->pending = 0;
+    controller->updates = 0;
+    controller->batch_scale = 1.0;
+}
+
+// Compare each class's live percentile with its target. Violating classes
+// gain precedence in proportion to the violation, classes with slack give it
+// back, and batch quanta shrink on any violation and grow while all have slack.
+void updateSloController(SloController *controller)
+{
+    int64_t recent[SLO_WINDOW];
+    bool violated = false;
+    bool slack = true;
 
-    // Print time markers
-    printf("\n");
-    for (int i = 0; i < gantt_chart_size; i++)
+    for (int c = 1; c < SLO_CLASSES; c++)
     {
-        printf("%2d", gantt_chart[i].start_time);
-        int duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
-        for (int j = 0; j < duration * 2 - 1; j++)
+        SloClass *class = &controller->classes[c];
+        if (class->target == 0 || class->samples < SLO_MIN_SAMPLES)
+            continue;
+
+        int count = class->samples < SLO_WINDOW ? (int)class->samples : SLO_WINDOW;
+        memcpy(recent, class->window, sizeof(int64_t) * count);
+        double ratio = (double)nearestRankPercentile(recent, count, controller->percentile) / class->target;
+        if (ratio > 1.0)
+        {
+            class->boost += SLO_BOOST_STEP * ratio;
+            if (class->boost > SLO_MAX_BOOST)
+                class->boost = SLO_MAX_BOOST;
+            violated = true;
+            slack = false;
+        }
+        else if (ratio > SLO_SLACK)
+        {
+            slack = false;
+        }
+        else
         {
-            printf(" ");
+            class->boost *= SLO_BOOST_DECAY;
+            if (class->boost < SLO_BOOST_STEP / 2)
+                class->boost = 0.0;
         }
     }
-    printf("%2d\n", gantt_chart[gantt_chart_size - 1].end_time);
-}
-
-// Display process details
 
-void displayProcessDetails(Process *processes, int n)
-{
-    printf("ProcessID,ArrivalTime,BurstTime,CompletionTime,TurnaroundTime,WaitingTime,ResponseTime,Deadline,Criticality,Period,SystemPriority\n");
+    if (violated)
+        controller->batch_scale *= 0.8;
+    else if (slack)
+        controller->batch_scale *= 1.1;
+    if (controller->batch_scale < SLO_MIN_BATCH_SCALE)
+        controller->batch_scale = SLO_MIN_BATCH_SCALE;
+    if (controller->batch_scale > SLO_MAX_BATCH_SCALE)
+        controller->batch_scale = SLO_MAX_BATCH_SCALE;
 
-    for (int i = 0; i < n; i++)
+    for (int c = 1; c < SLO_CLASSES; c++)
     {
-        printf("%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
-               processes[i].id,
-               processes[i].arrival_time,
-               processes[i].burst_time,
-               processes[i].completion_time,
-               processes[i].turnaround_time,
-               processes[i].waiting_time,
-               processes[i].response_time,
-               processes[i].deadline,
-               processes[i].criticality,
-               processes[i].period,
-               processes[i].system_priority);
+        if (controller->classes[c].target == 0)
+            controller->classes[c].quantum_scale = controller->batch_scale;
     }
+    controller->updates++;
 }
 
-void displayMetrics()
+// Record the response time of a process on its first dispatch
+void recordSloSample(SloController *controller, Process *process, int64_t response_time)
 {
-    printf("Metric,Value\n");
-    printf("Average Turnaround Time,%.2f\n", metrics.avg_turnaround_time);
-    printf("Average Waiting Time,%.2f\n", metrics.avg_waiting_time);
-    printf("Average Response Time,%.2f\n", metrics.avg_response_time);
-    printf("Throughput,%.2f\n", metrics.throughput);
-    printf("Fairness Index,%.2f\n", metrics.fairness_index);
-    printf("Starvation Count,%d\n", metrics.starvation_count);
-    printf("Load Balancing Efficiency,%.2f\n", metrics.load_balancing_efficiency);
-}
+    SloClass *class = &controller->classes[sloClass(process)];
+    class->window[class->samples % SLO_WINDOW] = response_time;
+    class->samples++;
 
+    if (++controller->pending == SLO_UPDATE_INTERVAL)
+    {
+        controller->pending = 0;
+        updateSloController(controller);
+    }
+}
 
-// Main function
-// Main function - modified to accept command line arguments
-int main(int argc, char *argv[])
+// Write the SLO attainment per criticality class and the batch throughput as CSV
+void displaySloAttainment(SloController *controller, Process *processes, int n)
 {
-    int n;
-    DynamicQuantum dtq;
-    char filename[MAX_FILENAME_LENGTH];
-
-    // Initialize dynamic time quantum parameters
-    dtq.base = 4.0; // Base time quantum
-    dtq.current = dtq.base;
-    dtq.load_factor = 0.0;
-    dtq.criticality_weight = 0.35;
-    dtq.deadline_weight = 0.30;
-    dtq.aging_weight = 0.25;
-    dtq.priority_weight = 0.10;
-
-
-    // Check if a filename was provided as a command line argument
-    if (argc > 1)
+    int64_t *response = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    if (response == NULL)
     {
-        strncpy(filename, argv[1], MAX_FILENAME_LENGTH - 1);
-        filename[MAX_FILENAME_LENGTH - 1] = '\0'; // Ensure null termination
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
     }
-    else
+
+    int64_t end_time = 0;
+    int batch_jobs = 0;
+    double batch_turnaround = 0.0;
+    for (int i = 0; i < n; i++)
     {
-        // Use default filename if no argument provided
-        strcpy(filename, "input.txt");
-        printf("No input file specified. Using default: %s\n", filename);
+        if (processes[i].completion_time > end_time)
+            end_time = processes[i].completion_time;
     }
 
-    // Read processes from file
-    n = readProcessesFromFile(processes, filename);
+    printf("Class,Jobs,Target,P%g Response Time,Attainment (%%),SLO Met\n", controller->percentile);
+    for (int c = 1; c < SLO_CLASSES; c++)
+    {
+        int64_t target = controller->classes[c].target;
+        int count = 0;
+        int attained = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (processes[i].rejected || !processes[i].completed || sloClass(&processes[i]) != c)
+                continue;
+            response[count++] = processes[i].response_time;
+            if (processes[i].response_time <= target)
+                attained++;
+            if (target == 0)
+                batch_turnaround += processes[i].turnaround_time;
+        }
+        if (count == 0)
+            continue;
+
+        double tail = (double)nearestRankPercentile(response, count, controller->percentile) / time_unit;
+        if (target == 0)
+        {
+            batch_jobs += count;
+            printf("%d,%d,batch,%.2f,-,-\n", c, count, tail);
+        }
+        else
+        {
+            printf("%d,%d,%.2f,%.2f,%.2f,%s\n", c, count, (double)target / time_unit, tail,
+                   100.0 * attained / count, tail * time_unit <= target ? "Yes" : "No");
+        }
+    }
+    printf("Batch Throughput,%.4f\n", end_time > 0 ? batch_jobs / ((double)end_time / time_unit) : 0.0);
+    printf("Batch Average Turnaround Time,%.2f\n", batch_jobs > 0 ? batch_turnaround / batch_jobs / time_unit : 0.0);
+    printf("Final Batch Quantum Scale,%.2f\n", controller->batch_scale);
+    printf("Controller Updates,%lld\n", controller->updates);
+
+    free(response);
+}
+
+// Draw the actual burst of every process around its trace burst, which is kept
+// as the estimate. sigma is the lognormal shape parameter.
+void sampleActualBursts(Process *processes, int n, BurstDistribution distribution, double sigma)
+{
+    for (int i = 0; i < n; i++)
+    {
+        processes[i].burst_time = drawActualBurst(distribution, sigma, processes[i].estimated_burst);
+        processes[i].remaining_burst = processes[i].burst_time;
+    }
+}
+
+// Predict the burst of an arriving process and keep it as what the policy sees
+void predictArrival(Process *process)
+{
+    if (burst_predictor != NULL)
+        process->predicted_burst = predictBurst(burst_predictor, process->estimated_burst, process->burst_time,
+                                                process->criticality);
+}
+
+// Let the predictor learn from a completed process
+void observeBurst(Process *process)
+{
+    if (burst_predictor != NULL)
+        learnBurst(burst_predictor, process->estimated_burst, process->burst_time, process->criticality);
+}
+
+// Remaining time of a process as the policy sees it. A process that has run
+// past its predicted burst has its prediction doubled until it is ahead again.
+int64_t visibleRemaining(Process *process)
+{
+    if (burst_predictor == NULL)
+        return process->remaining_burst;
+
+    int64_t executed = process->burst_time - process->remaining_burst;
+    while (process->predicted_burst <= executed)
+        process->predicted_burst *= 2;
+    return process->predicted_burst - executed;
+}
+
+// One run of the interrupt comparison: without, then with the interrupt source
+void runInterruptVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    DynamicQuantum params = *comparison->dtq;
+    irq_model = variant ? comparison->irq : NULL;
+    runDPS_DTQ(processes, n, &params);
+    summarizeResponses(processes, n, values);
+    values[4] = metrics.avg_turnaround_time;
+    values[5] = metrics.throughput;
+}
+
+// Run the trace without and then with the interrupt source, and compare the
+// metrics interrupts disturb
+void runInterruptComparison(Process *processes, int n, DynamicQuantum *dtq, InterruptModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Response Time",
+        "Response Time Jitter",
+        "P99 Response Time",
+        "Deadline Misses",
+        "Average Turnaround Time",
+        "Throughput"};
+    Comparison comparison = {dtq, NULL, model};
+
+    runComparison(processes, n, runInterruptVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "No Interrupts", "Interrupts");
+    displayInterruptLoad(model);
+}
+
+// Policy index of a --policy name, or -1 if unknown
+int parsePolicy(const char *name)
+{
+    static const char *names[] = {"dps", "llf", "edzl", "banded"};
+    for (int k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++)
+    {
+        if (strcmp(name, names[k]) == 0)
+            return k;
+    }
+    return -1;
+}
+
+// Empty the heaps before a run, growing them to hold every process
+void resetDeadlinePolicy(DeadlinePolicy *dp, int n)
+{
+    if (dp->capacity < n)
+    {
+        for (int h = 0; h < 2; h++)
+        {
+            free(dp->heap[h]);
+            dp->heap[h] = (Process **)malloc(sizeof(Process *) * n);
+            if (dp->heap[h] == NULL)
+            {
+                printf("Not enough memory for %d processes\n", n);
+                exit(1);
+            }
+        }
+        dp->capacity = n;
+    }
+    dp->size = 0;
+    dp->guarded = 0;
+}
+
+// Order key of a process in one of the heaps. The laxity key is the time at
+// which the laxity of a waiting process reaches zero. Processes without a
+// deadline follow all others in arrival order.
+int64_t policyKey(Process *process, int heap)
+{
+    if (process->deadline <= 0)
+        return NO_DEADLINE + process->arrival_time;
+    return heap == LAXITY_HEAP ? process->deadline - visibleRemaining(process) : process->deadline;
+}
+
+// Whether a goes before b in the heap; ties go to the earlier arrival
+bool policyBefore(Process *a, Process *b, int heap)
+{
+    int64_t key_a = policyKey(a, heap);
+    int64_t key_b = policyKey(b, heap);
+    if (key_a != key_b)
+        return key_a < key_b;
+    if (a->arrival_time != b->arrival_time)
+        return a->arrival_time < b->arrival_time;
+    return a->id < b->id;
+}
+
+// Move the process at the given slot up or down until the heap is ordered
+void siftPolicyHeap(DeadlinePolicy *dp, int heap, int slot)
+{
+    Process **h = dp->heap[heap];
+    Process *process = h[slot];
+
+    while (slot > 0 && policyBefore(process, h[(slot - 1) / 2], heap))
+    {
+        h[slot] = h[(slot - 1) / 2];
+        h[slot]->heap_slot[heap] = slot;
+        slot = (slot - 1) / 2;
+    }
+    while (2 * slot + 1 < dp->size)
+    {
+        int child = 2 * slot + 1;
+        if (child + 1 < dp->size && policyBefore(h[child + 1], h[child], heap))
+            child++;
+        if (!policyBefore(h[child], process, heap))
+            break;
+        h[slot] = h[child];
+        h[slot]->heap_slot[heap] = slot;
+        slot = child;
+    }
+    h[slot] = process;
+    process->heap_slot[heap] = slot;
+}
+
+// Add a ready process; only EDZL needs the deadline heap
+void pushDeadlinePolicy(DeadlinePolicy *dp, Process *process)
+{
+    int heaps = dp->policy == POLICY_EDZL ? 2 : 1;
+    int slot = dp->size++;
+    for (int h = 0; h < heaps; h++)
+    {
+        dp->heap[h][slot] = process;
+        siftPolicyHeap(dp, h, slot);
+    }
+}
+
+// Take a process out of the heaps, filling its slots with the last ones
+void removeDeadlinePolicy(DeadlinePolicy *dp, Process *process)
+{
+    int heaps = dp->policy == POLICY_EDZL ? 2 : 1;
+    dp->size--;
+    for (int h = 0; h < heaps; h++)
+    {
+        int slot = process->heap_slot[h];
+        if (slot == dp->size)
+            continue;
+        dp->heap[h][slot] = dp->heap[h][dp->size];
+        siftPolicyHeap(dp, h, slot);
+    }
+}
+
+// Dispatch the least laxity process under LLF. EDZL dispatches the earliest
+// deadline unless a process has reached zero laxity.
+Process *selectDeadlinePolicy(DeadlinePolicy *dp, int64_t current_time)
+{
+    Process *process = dp->heap[LAXITY_HEAP][0];
+    if (dp->policy == POLICY_EDZL && policyKey(process, LAXITY_HEAP) > current_time)
+        process = dp->heap[DEADLINE_HEAP][0];
+    removeDeadlinePolicy(dp, process);
+    return process;
+}
+
+// Slice of the dispatched process: it runs until the next arrival or until
+// the least laxity waiting process should take over. Under LLF that happens
+// once the falling laxity of the waiting process passes the constant laxity of
+// the running one, which on ties would be after every ns; under EDZL when the
+// waiting process reaches zero laxity, unless the running one already has.
+// The minimum slice keeps such preemptions from thrashing.
+int64_t deadlinePolicySlice(DeadlinePolicy *dp, Process *process, int64_t current_time, int64_t next_arrival)
+{
+    int64_t end = next_arrival;
+    if (dp->size > 0 && dp->heap[LAXITY_HEAP][0]->deadline > 0)
+    {
+        int64_t waiting_key = policyKey(dp->heap[LAXITY_HEAP][0], LAXITY_HEAP);
+        int64_t running_key = policyKey(process, LAXITY_HEAP);
+        int64_t takeover = end;
+        if (dp->policy == POLICY_LLF)
+            takeover = current_time + (waiting_key - running_key) + 1;
+        else if (running_key > current_time)
+            takeover = waiting_key;
+        if (takeover < end)
+            end = takeover;
+    }
+
+    int64_t slice = end - current_time;
+    if (slice < dp->min_slice)
+    {
+        if (process->remaining_burst > slice)
+            dp->guarded++;
+        slice = dp->min_slice;
+    }
+    return slice < process->remaining_burst ? slice : process->remaining_burst;
+}
+
+// Empty the bands before a run and start a new round
+void resetBandedQueue(BandedQueue *bq)
+{
+    memset(bq, 0, sizeof(*bq));
+    bq->cursor = 1;
+}
+
+// Band a process enters when it becomes ready: its criticality, clamped to 1-10
+int baseBand(Process *process)
+{
+    if (process->criticality < 1)
+        return 1;
+    return process->criticality < CRITICALITY_BANDS - 1 ? process->criticality : CRITICALITY_BANDS - 1;
+}
+
+void appendToBand(BandedQueue *bq, Process *process, int band, int64_t since)
+{
+    process->band = band;
+    process->band_since = since;
+    process->band_next = NULL;
+    if (bq->tail[band] != NULL)
+        bq->tail[band]->band_next = process;
+    else
+        bq->head[band] = process;
+    bq->tail[band] = process;
+    bq->size[band]++;
+}
+
+Process *removeBandHead(BandedQueue *bq, int band)
+{
+    Process *process = bq->head[band];
+    bq->head[band] = process->band_next;
+    if (bq->head[band] == NULL)
+        bq->tail[band] = NULL;
+    bq->size[band]--;
+    return process;
+}
+
+// Queue a ready process in its criticality band; a process that ran is back
+// in its own band, whatever band aging had moved it to
+void pushBandedQueue(BandedQueue *bq, Process *process)
+{
+    int64_t since = process->stat.runnable_since;
+    if (since < process->arrival_time)
+        since = process->arrival_time;
+    appendToBand(bq, process, baseBand(process), since);
+}
+
+// Promote the processes that waited too long, then dispatch from the band
+// whose turn it is in the weighted round-robin and set the dynamic quantum
+// from the band's criticality and its share of the ready processes
+Process *selectBandedQueue(BandedQueue *bq, int64_t current_time, int n, DynamicQuantum *dtq)
+{
+    // Bands are FIFO, so the head of a band is the process that has waited
+    // there (about) the longest and the only one checked
+    int64_t promotion_wait = AGING_HORIZON * time_unit;
+    for (int band = CRITICALITY_BANDS - 2; band >= 1; band--)
+    {
+        while (bq->head[band] != NULL && current_time - bq->head[band]->band_since >= promotion_wait)
+        {
+            appendToBand(bq, removeBandHead(bq, band), band + 1, current_time);
+            bq->promotions++;
+        }
+    }
+
+    if (bq->credits == 0 || bq->size[bq->cursor] == 0)
+    {
+        do
+            bq->cursor = bq->cursor > 1 ? bq->cursor - 1 : CRITICALITY_BANDS - 1;
+        while (bq->size[bq->cursor] == 0);
+        bq->credits = bq->cursor;
+    }
+    int band = bq->cursor;
+    bq->credits--;
+    bq->dispatches[band]++;
+
+    dtq->load_factor = (double)bq->size[band] / n;
+    dtq->current = dtq->base * (1.0 + dtq->criticality_weight * band / 10.0) * (1.0 - 0.5 * dtq->load_factor);
+    return removeBandHead(bq, band);
+}
+
+// Empty the guard before a run, growing its heap to hold every process
+void resetWaitGuard(WaitGuard *guard, int n)
+{
+    if (guard->capacity < n)
+    {
+        free(guard->heap);
+        free(guard->due);
+        guard->heap = (Process **)malloc(sizeof(Process *) * n);
+        guard->due = (Process **)malloc(sizeof(Process *) * n);
+        if (guard->heap == NULL || guard->due == NULL)
+        {
+            printf("Not enough memory for %d processes\n", n);
+            exit(1);
+        }
+        guard->capacity = n;
+    }
+    guard->size = 0;
+    guard->due_head = 0;
+    guard->due_count = 0;
+    guard->dispatches = 0;
+}
+
+// Whether a is due before b; ties go to the earlier arrival
+bool dueBefore(Process *a, Process *b)
+{
+    if (a->guard_due != b->guard_due)
+        return a->guard_due < b->guard_due;
+    if (a->arrival_time != b->arrival_time)
+        return a->arrival_time < b->arrival_time;
+    return a->id < b->id;
+}
+
+// Move the process at the given slot up or down until the heap is ordered
+void siftWaitGuard(WaitGuard *guard, int slot)
+{
+    Process **h = guard->heap;
+    Process *process = h[slot];
+
+    while (slot > 0 && dueBefore(process, h[(slot - 1) / 2]))
+    {
+        h[slot] = h[(slot - 1) / 2];
+        h[slot]->guard_slot = slot;
+        slot = (slot - 1) / 2;
+    }
+    while (2 * slot + 1 < guard->size)
+    {
+        int child = 2 * slot + 1;
+        if (child + 1 < guard->size && dueBefore(h[child + 1], h[child]))
+            child++;
+        if (!dueBefore(h[child], process))
+            break;
+        h[slot] = h[child];
+        h[slot]->guard_slot = slot;
+        slot = child;
+    }
+    h[slot] = process;
+    process->guard_slot = slot;
+}
+
+// Track a process that became ready; it is due max_wait after it became runnable
+void pushWaitGuard(WaitGuard *guard, Process *process)
+{
+    int64_t since = process->stat.runnable_since;
+    if (since < process->arrival_time)
+        since = process->arrival_time;
+    process->guard_due = since + guard->max_wait;
+    guard->heap[guard->size] = process;
+    guard->size++;
+    siftWaitGuard(guard, guard->size - 1);
+}
+
+void removeWaitGuard(WaitGuard *guard, Process *process)
+{
+    int slot = process->guard_slot;
+    guard->size--;
+    if (slot == guard->size)
+        return;
+    guard->heap[slot] = guard->heap[guard->size];
+    siftWaitGuard(guard, slot);
+}
+
+// Close the holes left in the ready queue ring, keeping the order of the rest
+void compactQueue(ReadyQueue *queue)
+{
+    int used = 0;
+    for (int i = 0; i < queue->size + queue->holes; i++)
+    {
+        Process *process = queue->processes[(queue->front + i) % queue->capacity];
+        if (process == NULL)
+            continue;
+        int slot = (queue->front + used) % queue->capacity;
+        queue->processes[slot] = process;
+        process->queue_slot = slot;
+        used++;
+    }
+    queue->rear = (queue->front + queue->size - 1 + queue->capacity) % queue->capacity;
+    queue->holes = 0;
+}
+
+// Take a process out of the middle of the ready queue in O(1). Its slot stays
+// a hole until the next sort or until the ring runs out of free slots.
+void removeFromQueue(ReadyQueue *queue, Process *process)
+{
+    queue->processes[process->queue_slot] = NULL;
+    queue->size--;
+    queue->holes++;
+}
+
+// Move every process that has reached the maximum wait from the heap to the
+// FIFO of due processes. Later releases are due later, so the FIFO stays
+// ordered by due time.
+void releaseDueProcesses(WaitGuard *guard, int64_t current_time)
+{
+    while (guard->size > 0 && guard->heap[0]->guard_due <= current_time)
+    {
+        Process *process = guard->heap[0];
+        removeWaitGuard(guard, process);
+        guard->due[(guard->due_head + guard->due_count) % guard->capacity] = process;
+        guard->due_count++;
+    }
+}
+
+// The released process that reached the maximum wait first, taken out of the
+// ready queue, or NULL if none has
+Process *takeDueProcess(WaitGuard *guard, ReadyQueue *queue, int64_t current_time)
+{
+    releaseDueProcesses(guard, current_time);
+    if (guard->due_count == 0)
+        return NULL;
+
+    Process *process = guard->due[guard->due_head];
+    guard->due_head = (guard->due_head + 1) % guard->capacity;
+    guard->due_count--;
+    removeFromQueue(queue, process);
+    guard->dispatches++;
+    return process;
+}
+
+// Longest total waiting time of a completed process (ns)
+int64_t longestWaitingTime(Process *processes, int n)
+{
+    int64_t longest = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (processes[i].completed && processes[i].waiting_time > longest)
+            longest = processes[i].waiting_time;
+    }
+    return longest;
+}
+
+// Write the waits the guard achieved in the last run as CSV rows
+void displayWaitGuardStats(WaitGuard *guard, Process *processes, int n)
+{
+    printf("Maximum Wait,%.2f\n", (double)guard->max_wait / time_unit);
+    printf("Worst Wait For A Slice,%.2f\n", (double)metrics.worst_wait / time_unit);
+    printf("Longest Waiting Time,%.2f\n", (double)longestWaitingTime(processes, n) / time_unit);
+    printf("Guard Dispatches,%lld\n", guard->dispatches);
+}
+
+// One run of the wait guard comparison: without, then with the guard
+void runWaitGuardVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    DynamicQuantum params = *comparison->dtq;
+    double summary[4];
+    wait_guard = variant ? comparison->guard : NULL;
+    runDPS_DTQ(processes, n, &params);
+    summarizeResponses(processes, n, summary);
+    values[0] = (double)metrics.worst_wait / time_unit;
+    values[1] = (double)longestWaitingTime(processes, n) / time_unit;
+    values[2] = metrics.starvation_count;
+    values[3] = summary[0];
+    values[4] = summary[2];
+    values[5] = summary[3];
+}
+
+// Run the trace without and then with the bounded-wait guard, and compare
+// the waits and what the guard costs the priority order
+void runWaitGuardComparison(Process *processes, int n, DynamicQuantum *dtq, WaitGuard *guard)
+{
+    static const char *metric_names[] = {
+        "Worst Wait For A Slice",
+        "Longest Waiting Time",
+        "Starvation Count",
+        "Average Response Time",
+        "P99 Response Time",
+        "Deadline Misses"};
+    Comparison comparison = {dtq, NULL, NULL, NULL, NULL, guard};
+
+    runComparison(processes, n, runWaitGuardVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "No Guard", "Guard");
+    printf("Guard Dispatches,%lld\n", guard->dispatches);
+}
+
+// Write the deadline misses and context switches of the last run as CSV rows
+void displayPolicyStats(SchedulingPolicy policy, Process *processes, int n)
+{
+    static const char *names[] = {"DPS-DTQ", "LLF", "EDZL", "Banded DPS-DTQ"};
+    double summary[4];
+    summarizeResponses(processes, n, summary);
+    printf("Scheduling Policy,%s\n", names[policy]);
+    printf("Deadline Misses,%.0f\n", summary[3]);
+    printf("Context Switches,%lld\n", metrics.context_switches);
+    if (deadline_policy != NULL)
+        printf("Minimum Slice Guards,%lld\n", deadline_policy->guarded);
+    if (banded_queue != NULL)
+    {
+        printf("Band Promotions,%lld\n", banded_queue->promotions);
+        for (int band = CRITICALITY_BANDS - 1; band >= 1; band--)
+            printf("Band %d Dispatches,%lld\n", band, banded_queue->dispatches[band]);
+    }
+}
+
+// One run of the policy comparison: DPS-DTQ, then the chosen policy
+void runPolicyVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Comparison *comparison = (Comparison *)context;
+    DynamicQuantum params = *comparison->dtq;
+    double summary[4];
+    deadline_policy = variant ? comparison->policy : NULL;
+    banded_queue = variant ? comparison->bands : NULL;
+    runDPS_DTQ(processes, n, &params);
+    summarizeResponses(processes, n, summary);
+    values[0] = summary[3];
+    values[1] = metrics.context_switches;
+    values[2] = metrics.avg_turnaround_time;
+    values[3] = metrics.avg_response_time;
+    values[4] = summary[2];
+    values[5] = metrics.throughput;
+}
+
+// Run the trace under DPS-DTQ and then under the chosen policy, and compare
+// their deadline misses and context switches
+void runPolicyComparison(Process *processes, int n, DynamicQuantum *dtq, SchedulingPolicy policy)
+{
+    static const char *names[] = {"DPS-DTQ", "LLF", "EDZL", "Banded DPS-DTQ"};
+    static const char *metric_names[] = {
+        "Deadline Misses",
+        "Context Switches",
+        "Average Turnaround Time",
+        "Average Response Time",
+        "P99 Response Time",
+        "Throughput"};
+    Comparison comparison = {dtq, NULL, NULL, deadline_policy, banded_queue};
+
+    runComparison(processes, n, runPolicyVariant, &comparison, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "DPS-DTQ", names[policy]);
+    if (comparison.policy != NULL)
+        printf("Minimum Slice Guards,%lld\n", comparison.policy->guarded);
+    if (comparison.bands != NULL)
+        printf("Band Promotions,%lld\n", comparison.bands->promotions);
+}
+
+// Structure name of --runqueue-structure, or -1 if unknown
+int parseQueueStructure(const char *name)
+{
+    static const char *names[] = {"fifo", "heap", "sorted"};
+    for (int k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++)
+    {
+        if (strcmp(name, names[k]) == 0)
+            return k;
+    }
+    return -1;
+}
+
+// ns a queue operation holds the lock: the base cost plus the elements the
+// structure touches. The sorted queue is re-sorted before each dispatch, as
+// the DPS-DTQ ready queue is.
+int64_t lockHoldCost(LockModel *model, int length, bool dispatch)
+{
+    double log_length = log2(length + 1.0);
+    double elements = 1.0;
+    if (model->structure == STRUCTURE_HEAP)
+        elements = log_length;
+    else if (model->structure == STRUCTURE_SORTED && dispatch)
+        elements = length * log_length;
+    return model->base_cost + (int64_t)(model->element_cost * elements);
+}
+
+// Take a lock requested at the given time and hold it; returns the release
+// time. Requests are made in time order, so the lock is granted FIFO. A
+// sleeping waiter only holds the lock wake_latency after it is released.
+int64_t acquireLock(LockModel *model, int64_t *free_at, int64_t request, int64_t hold, bool sleep, int64_t *waited)
+{
+    int64_t start = request;
+    if (*free_at > request)
+        start = *free_at + (sleep ? model->wake_latency : 0);
+    *waited = start - request;
+    *free_at = start + hold;
+    return start + hold;
+}
+
+// Order processes by arrival time
+int compareArrival(const void *a, const void *b)
+{
+    const Process *p1 = *(const Process *const *)a;
+    const Process *p2 = *(const Process *const *)b;
+    return (p1->arrival_time > p2->arrival_time) - (p1->arrival_time < p2->arrival_time);
+}
+
+void pushCpuEvent(CpuEvent *heap, int *size, int64_t time, int cpu)
+{
+    int slot = (*size)++;
+    while (slot > 0 && heap[(slot - 1) / 2].time > time)
+    {
+        heap[slot] = heap[(slot - 1) / 2];
+        slot = (slot - 1) / 2;
+    }
+    heap[slot].time = time;
+    heap[slot].cpu = cpu;
+}
+
+CpuEvent popCpuEvent(CpuEvent *heap, int *size)
+{
+    CpuEvent top = heap[0];
+    CpuEvent last = heap[--(*size)];
+    int slot = 0;
+    while (2 * slot + 1 < *size)
+    {
+        int child = 2 * slot + 1;
+        if (child + 1 < *size && heap[child + 1].time < heap[child].time)
+            child++;
+        if (heap[child].time >= last.time)
+            break;
+        heap[slot] = heap[child];
+        slot = child;
+    }
+    if (*size > 0)
+        heap[slot] = last;
+    return top;
+}
+
+// Run the trace on several CPUs from one shared run queue or from a queue per
+// CPU that arrivals join by length. Queues are served in FIFO order: the cost
+// of keeping the DPS-DTQ order is charged to the lock holds, but the order
+// itself is not simulated. Each slice gets the DPS-DTQ dynamic quantum for
+// the process and the length of its queue. Every enqueue and dispatch holds
+// its queue's lock; arrivals are enqueued from interrupt context and always
+// spin. The processes are left untouched.
+void simulateContention(Process *processes, int n, LockModel *model, RunQueueKind kind, int cpus,
+                        DynamicQuantum *dtq, ContentionResult *result)
+{
+    int queues = kind == RUNQUEUE_SHARED ? 1 : cpus;
+    Process **order = (Process **)malloc(sizeof(Process *) * (n > 0 ? n : 1));
+    int64_t *remaining = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    int64_t *first_dispatch = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    int *next = (int *)malloc(sizeof(int) * (n > 0 ? n : 1));
+    int *head = (int *)malloc(sizeof(int) * queues);
+    int *tail = (int *)malloc(sizeof(int) * queues);
+    int *length = (int *)calloc(queues, sizeof(int));
+    int64_t *free_at = (int64_t *)calloc(queues, sizeof(int64_t));
+    int64_t *held = (int64_t *)calloc(queues, sizeof(int64_t));
+    int *current = (int *)malloc(sizeof(int) * cpus);
+    int *idle = (int *)malloc(sizeof(int) * cpus); // Stack of idle CPUs
+    bool *is_idle = (bool *)malloc(sizeof(bool) * cpus);
+    CpuEvent *events = (CpuEvent *)malloc(sizeof(CpuEvent) * cpus);
+    if (order == NULL || remaining == NULL || first_dispatch == NULL || next == NULL || head == NULL ||
+        tail == NULL || length == NULL || free_at == NULL || held == NULL || current == NULL ||
+        idle == NULL || is_idle == NULL || events == NULL)
+    {
+        printf("Not enough memory for %d processes on %d CPUs\n", n, cpus);
+        exit(1);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        order[i] = &processes[i];
+        remaining[i] = processes[i].burst_time;
+        first_dispatch[i] = -1;
+    }
+    if (!arrivalsSorted(processes, n))
+        qsort(order, n, sizeof(Process *), compareArrival);
+    int idle_count = cpus;
+    for (int c = 0; c < cpus; c++)
+    {
+        current[c] = -1;
+        idle[c] = cpus - 1 - c;
+        is_idle[c] = true;
+    }
+
+    memset(result, 0, sizeof(*result));
+    DynamicQuantum params = *dtq;
+    int64_t demand = 0; // CPU time taken by slices, lock holds and spinning
+    double total_turnaround = 0.0;
+    double total_response = 0.0;
+    int event_count = 0;
+    int arrived = 0;
+    int dispatched_out = 0; // Processes whose last slice has been dispatched
+    while (dispatched_out < n)
+    {
+        int64_t next_arrival = arrived < n ? order[arrived]->arrival_time : INT64_MAX;
+        int64_t next_event = event_count > 0 ? events[0].time : INT64_MAX;
+        int64_t waited;
+
+        if (next_arrival <= next_event)
+        {
+            // Arrivals join the shared queue or the shortest per-CPU queue
+            int p = (int)(order[arrived++] - processes);
+            int q = 0;
+            for (int k = 1; k < queues; k++)
+            {
+                if (length[k] + (current[k] >= 0) < length[q] + (current[q] >= 0))
+                    q = k;
+            }
+            int64_t hold = lockHoldCost(model, length[q], false);
+            int64_t release = acquireLock(model, &free_at[q], next_arrival, hold, false, &waited);
+            result->lock_wait += waited;
+            result->overhead += hold;
+            demand += waited + hold;
+            held[q] += hold;
+            next[p] = -1;
+            if (length[q]++ > 0)
+                next[tail[q]] = p;
+            else
+                head[q] = p;
+            tail[q] = p;
+
+            // The enqueue wakes an idle CPU that serves the queue
+            int c = -1;
+            if (kind == RUNQUEUE_SHARED && idle_count > 0)
+                c = idle[--idle_count];
+            else if (kind == RUNQUEUE_PER_CPU && is_idle[q])
+                c = q;
+            if (c >= 0)
+            {
+                is_idle[c] = false;
+                pushCpuEvent(events, &event_count, release, c);
+            }
+            continue;
+        }
+
+        // A CPU ends its slice (or wakes up): it puts back its process if that
+        // has work left and picks the next one under a single lock hold
+        CpuEvent event = popCpuEvent(events, &event_count);
+        int c = event.cpu;
+        int q = kind == RUNQUEUE_SHARED ? 0 : c;
+        int previous = current[c];
+        bool requeue = previous >= 0 && remaining[previous] > 0;
+        if (!requeue && length[q] == 0)
+        {
+            current[c] = -1;
+            is_idle[c] = true;
+            if (kind == RUNQUEUE_SHARED)
+                idle[idle_count++] = c;
+            continue;
+        }
+
+        int64_t hold = lockHoldCost(model, length[q] + requeue, true) +
+                       (requeue ? lockHoldCost(model, length[q], false) : 0);
+        int64_t release = acquireLock(model, &free_at[q], event.time, hold, model->sleep, &waited);
+        result->lock_wait += waited;
+        result->overhead += hold;
+        demand += (model->sleep ? 0 : waited) + hold;
+        held[q] += hold;
+        if (requeue)
+        {
+            next[previous] = -1;
+            if (length[q]++ > 0)
+                next[tail[q]] = previous;
+            else
+                head[q] = previous;
+            tail[q] = previous;
+        }
+
+        // The quantum is computed on a copy, as it updates the process's priority
+        params.load_factor = (double)length[q] / n;
+        int p = head[q];
+        head[q] = next[p];
+        length[q]--;
+        current[c] = p;
+        if (first_dispatch[p] < 0)
+        {
+            first_dispatch[p] = release;
+            total_response += release - processes[p].arrival_time;
+        }
+        Process copy = processes[p];
+        copy.remaining_burst = remaining[p];
+        calculateDynamicPriority(&copy, release, &params);
+        int64_t quantum = params.current >= 1.0 ? (int64_t)params.current : 1;
+        int64_t slice = remaining[p] < quantum ? remaining[p] : quantum;
+        remaining[p] -= slice;
+        demand += slice;
+        int64_t end = release + slice;
+        if (remaining[p] == 0)
+        {
+            dispatched_out++;
+            total_turnaround += end - processes[p].arrival_time;
+            if (end > result->makespan)
+                result->makespan = end;
+        }
+        pushCpuEvent(events, &event_count, end, c);
+    }
+
+    result->avg_turnaround = n > 0 ? total_turnaround / n / time_unit : 0.0;
+    result->avg_response = n > 0 ? total_response / n / time_unit : 0.0;
+
+    // Demand beyond the CPUs' capacity over the arrival span grows the queues
+    // (and with them the lock holds) for as long as the trace runs
+    int64_t span = n > 0 ? order[n - 1]->arrival_time - order[0]->arrival_time : 0;
+    result->stable = span <= 0 || (double)demand < (double)span * cpus;
+    for (int q = 0; q < queues; q++)
+    {
+        if (held[q] > result->lock_held)
+            result->lock_held = held[q];
+    }
+
+    free(order);
+    free(remaining);
+    free(first_dispatch);
+    free(next);
+    free(head);
+    free(tail);
+    free(length);
+    free(free_at);
+    free(held);
+    free(current);
+    free(idle);
+    free(is_idle);
+    free(events);
+}
+
+// Run the trace on 1, 2, 4, ... up to the model's CPUs with a shared run queue
+// and with per-CPU queues, and write how each scales as CSV rows
+void runLockContention(Process *processes, int n, DynamicQuantum *dtq, LockModel *model)
+{
+    static const char *kinds[] = {"shared", "per-cpu"};
+    double base_throughput[2] = {0.0, 0.0};
+    bool base_stable[2] = {true, true};
+    int within = 0; // CPUs up to which the shared queue keeps up with per-CPU queues
+    bool keeps_up = true;
+
+    printf("CPUs,Run Queue,Throughput,Speedup,Average Turnaround Time,Average Response Time,"
+           "Lock Wait (%%),Busiest Lock Held (%%),Lock Overhead (%%),Stable\n");
+    for (int cpus = 1;; cpus = cpus * 2 < model->cpus ? cpus * 2 : model->cpus)
+    {
+        ContentionResult results[2];
+        for (int kind = 0; kind < 2; kind++)
+        {
+            ContentionResult *r = &results[kind];
+            simulateContention(processes, n, model, (RunQueueKind)kind, cpus, dtq, r);
+            double elapsed = r->makespan > 0 ? (double)r->makespan : 1.0;
+            double throughput = n / (elapsed / time_unit);
+            if (cpus == 1)
+            {
+                base_throughput[kind] = throughput;
+                base_stable[kind] = r->stable;
+            }
+
+            // An overloaded single CPU finishes whenever its backlog drains, so
+            // the throughput of more CPUs is not a speedup over it
+            printf("%d,%s,%.4f,", cpus, kinds[kind], throughput);
+            if (base_stable[kind] && base_throughput[kind] > 0)
+                printf("%.2f,", throughput / base_throughput[kind]);
+            else
+                printf("NA,");
+            printf("%.2f,%.2f,%.2f,%.2f,%.2f,%s\n", r->avg_turnaround, r->avg_response,
+                   100.0 * r->lock_wait / (elapsed * cpus),
+                   100.0 * r->lock_held / elapsed,
+                   100.0 * r->overhead / (elapsed * cpus),
+                   r->stable ? "Yes" : "No");
+        }
+        keeps_up = keeps_up && results[RUNQUEUE_SHARED].avg_turnaround <=
+                                   (1.0 + LOCK_SCALING_TOLERANCE) * results[RUNQUEUE_PER_CPU].avg_turnaround;
+        if (keeps_up)
+            within = cpus;
+        if (cpus == model->cpus)
+            break;
+    }
+    printf("Shared Queue Within %.0f%% Of Per-CPU Up To (CPUs),%d\n", 100.0 * LOCK_SCALING_TOLERANCE, within);
+}
+
+// Display process details
+
+void displayProcessDetails(Process *processes, int n)
+{
+    printf("ProcessID,ArrivalTime,BurstTime,CompletionTime,TurnaroundTime,WaitingTime,ResponseTime,Deadline,Criticality,Period,SystemPriority,"
+           "RunnableTime,RunTime,BlockedTime,ThrottledTime,Slices,Preemptions,Migrations\n");
+
+    for (int i = 0; i < n; i++)
+    {
+        printf("%d,%lld,%lld,%lld,%lld,%lld,%lld,%lld,%d,%lld,%d,%lld,%lld,%lld,%lld,%d,%d,%d\n",
+               processes[i].id,
+               (long long)processes[i].arrival_time,
+               (long long)processes[i].burst_time,
+               (long long)processes[i].completion_time,
+               (long long)processes[i].turnaround_time,
+               (long long)processes[i].waiting_time,
+               (long long)processes[i].response_time,
+               (long long)processes[i].deadline,
+               processes[i].criticality,
+               (long long)processes[i].period,
+               processes[i].system_priority,
+               (long long)processes[i].stat.wait_time,
+               (long long)processes[i].stat.run_time,
+               (long long)processes[i].stat.blocked_time,
+               (long long)processes[i].stat.throttled_time,
+               processes[i].stat.slices,
+               processes[i].stat.preemptions,
+               processes[i].stat.migrations);
+    }
+}
+
+void displayMetrics()
+{
+    printf("Metric,Value\n");
+    printf("Average Turnaround Time,%.2f\n", metrics.avg_turnaround_time);
+    printf("Average Waiting Time,%.2f\n", metrics.avg_waiting_time);
+    printf("Average Response Time,%.2f\n", metrics.avg_response_time);
+    printf("Throughput,%.2f\n", metrics.throughput);
+    printf("Fairness Index,%.2f\n", metrics.fairness_index);
+    printf("Starvation Count,%d\n", metrics.starvation_count);
+    printf("Load Balancing Efficiency,%.2f\n", metrics.load_balancing_efficiency);
+}
+
+
+// Main function
+// Main function - modified to accept command line arguments
+int main(int argc, char *argv[])
+{
+    int n;
+    DynamicQuantum dtq;
+    SamplingParams sampling;
+    SteadyStateParams steady;
+    char filename[MAX_FILENAME_LENGTH];
+    const char *gantt_filename = NULL;
+    bool process_details = false;
+    const char *stats_filename = NULL;
+    int progress_interval = 0;
+    const char *metrics_socket = NULL;
+    const char *metrics_file = NULL;
+    int metrics_interval = DEFAULT_METRICS_INTERVAL;
+    TickModel ticks;
+    bool tick_compare = false;
+    IdleModel idle;
+    const char *idle_states = NULL;
+    const char *idle_governor = NULL;
+    AdmissionControl admit;
+    InterruptModel irq;
+    HostModel host;
+    const char *host_policy = NULL;
+    bool irq_compare = false;
+    BurstPredictor predictor;
+    const char *predictor_name = NULL;
+    const char *actual_bursts = NULL;
+    SloController slo_mode;
+    const char *slo_targets = NULL;
+    DeadlinePolicy policy;
+    BandedQueue bands;
+    const char *policy_name = NULL;
+    bool policy_compare = false;
+    WaitGuard guard;
+    bool wait_compare = false;
+    LockModel lock;
+    const char *queue_structure = NULL;
+    const char *lock_wait = NULL;
+
+    // Initialize dynamic time quantum parameters
+    dtq.base = -1; // Base time quantum (ns), DEFAULT_BASE_QUANTUM time units unless given
+    dtq.load_factor = 0.0;
+    dtq.criticality_weight = 0.35;
+    dtq.deadline_weight = 0.30;
+    dtq.aging_weight = 0.25;
+    dtq.priority_weight = 0.10;
+
+    // Tickless unless a tick rate is given with --hz
+    memset(&ticks, 0, sizeof(ticks));
+    ticks.overhead = DEFAULT_TICK_OVERHEAD_NS;
+
+    // Idle CPUs wake up instantly unless idle states are enabled
+    memset(&idle, 0, sizeof(idle));
+    idle.latency_limit = -1;
+
+    // Every arrival is admitted unless an admission limit is set
+    memset(&admit, 0, sizeof(admit));
+    admit.horizon = -1;
+
+    // No interrupt load unless an interval is given with --irq-interval-ns
+    memset(&irq, 0, sizeof(irq));
+    irq.hardirq = DEFAULT_HARDIRQ_NS;
+    irq.softirq = DEFAULT_SOFTIRQ_NS;
+    irq.burst = 1.0;
+
+    // No hypervisor unless --host-pcpus is given
+    memset(&host, 0, sizeof(host));
+    host.guests = 1;
+    host.guest_weight = HOST_DEFAULT_WEIGHT;
+    host.slice = -1;
+
+    // Policies know the exact bursts unless a predictor is chosen with --predictor
+    memset(&predictor, 0, sizeof(predictor));
+    predictor.alpha = DEFAULT_PREDICTOR_ALPHA;
+
+    // SLO mode is off unless per-class targets are given with --slo
+    memset(&slo_mode, 0, sizeof(slo_mode));
+    slo_mode.percentile = 99.0;
+
+    // DPS-DTQ decides unless a deadline policy is chosen with --policy
+    memset(&policy, 0, sizeof(policy));
+    policy.min_slice = -1; // One time unit unless given
+
+    // Waits are unbounded unless a maximum is given with --max-wait-ns
+    memset(&guard, 0, sizeof(guard));
+
+    // One CPU without run queue locks unless --cpus is given
+    memset(&lock, 0, sizeof(lock));
+    lock.structure = STRUCTURE_SORTED;
+    lock.base_cost = DEFAULT_LOCK_BASE_NS;
+    lock.element_cost = DEFAULT_LOCK_ELEMENT_NS;
+    lock.wake_latency = DEFAULT_LOCK_WAKE_NS;
+
+    // Sampling mode is off unless requested with --sample
+    sampling.enabled = false;
+    sampling.window_length = 0;
+    sampling.strata = 4;
+    sampling.windows_per_stratum = 3;
+    sampling.warmup = -1;
+    sampling.seed = 1;
+    sampling.compare = false;
+
+    // Synthetic workloads are off unless requested with --synthetic
+    steady.enabled = false;
+    steady.arrival_rate = 0.15;
+    steady.mean_burst = 4.0;
+    steady.max_jobs = 200000;
+    steady.precision = 0.05;
+    steady.abs_precision = 0.01;
+    steady.check_interval = 1000;
+    steady.seed = 1;
+
+    // Check if a filename was provided as a command line argument
+    int first_option = 1;
+    if (argc > 1 && strncmp(argv[1], "--", 2) != 0)
+    {
+        strncpy(filename, argv[1], MAX_FILENAME_LENGTH - 1);
+        filename[MAX_FILENAME_LENGTH - 1] = '\0'; // Ensure null termination
+        first_option = 2;
+    }
+    else
+    {
+        // Use default filename if no argument provided
+        strcpy(filename, "input.txt");
+    }
+
+    // Optional flags follow the input file
+    for (int i = first_option; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sample") == 0)
+            sampling.enabled = true;
+        else if (strcmp(argv[i], "--compare") == 0)
+            sampling.compare = true;
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+            sampling.window_length = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--strata") == 0 && i + 1 < argc)
+            sampling.strata = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--per-stratum") == 0 && i + 1 < argc)
+            sampling.windows_per_stratum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            sampling.warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--gantt-out") == 0 && i + 1 < argc)
+            gantt_filename = argv[++i];
+        else if (strcmp(argv[i], "--process-details") == 0)
+            process_details = true;
+        else if (strcmp(argv[i], "--synthetic") == 0)
+            steady.enabled = true;
+        else if (strcmp(argv[i], "--arrival-rate") == 0 && i + 1 < argc)
+            steady.arrival_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--mean-burst") == 0 && i + 1 < argc)
+            steady.mean_burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-jobs") == 0 && i + 1 < argc)
+            steady.max_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc)
+            steady.precision = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            sampling.seed = steady.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--time-unit-ns") == 0 && i + 1 < argc)
+            time_unit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--quantum-ns") == 0 && i + 1 < argc)
+            dtq.base = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--small-queue") == 0 && i + 1 < argc)
+            small_queue_max = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            ticks.hz = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-overhead-ns") == 0 && i + 1 < argc)
+            ticks.overhead = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-compare") == 0)
+            tick_compare = true;
+        else if (strcmp(argv[i], "--idle-states") == 0 && i + 1 < argc)
+            idle_states = argv[++i];
+        else if (strcmp(argv[i], "--idle-governor") == 0 && i + 1 < argc)
+            idle_governor = argv[++i];
+        else if (strcmp(argv[i], "--idle-latency-limit-ns") == 0 && i + 1 < argc)
+            idle.latency_limit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-utilization") == 0 && i + 1 < argc)
+            admit.max_utilization = atof(argv[++i]);
+        else if (strcmp(argv[i], "--admit-horizon-ns") == 0 && i + 1 < argc)
+            admit.horizon = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-queue") == 0 && i + 1 < argc)
+            admit.max_queue = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--admit-max-defer-ns") == 0 && i + 1 < argc)
+            admit.max_deferral = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-deadlines") == 0)
+            admit.deadline_check = true;
+        else if (strcmp(argv[i], "--slo") == 0 && i + 1 < argc)
+            slo_targets = argv[++i];
+        else if (strcmp(argv[i], "--slo-percentile") == 0 && i + 1 < argc)
+            slo_mode.percentile = atof(argv[++i]);
+        else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+            policy_name = argv[++i];
+        else if (strcmp(argv[i], "--min-slice-ns") == 0 && i + 1 < argc)
+            policy.min_slice = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--policy-compare") == 0)
+            policy_compare = true;
+        else if (strcmp(argv[i], "--max-wait-ns") == 0 && i + 1 < argc)
+            guard.max_wait = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--wait-compare") == 0)
+            wait_compare = true;
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc)
+            lock.cpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--runqueue-structure") == 0 && i + 1 < argc)
+            queue_structure = argv[++i];
+        else if (strcmp(argv[i], "--lock-wait") == 0 && i + 1 < argc)
+            lock_wait = argv[++i];
+        else if (strcmp(argv[i], "--lock-base-ns") == 0 && i + 1 < argc)
+            lock.base_cost = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--lock-element-ns") == 0 && i + 1 < argc)
+            lock.element_cost = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--lock-wake-ns") == 0 && i + 1 < argc)
+            lock.wake_latency = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--actual-bursts") == 0 && i + 1 < argc)
+            actual_bursts = argv[++i];
+        else if (strcmp(argv[i], "--predictor") == 0 && i + 1 < argc)
+            predictor_name = argv[++i];
+        else if (strcmp(argv[i], "--predictor-alpha") == 0 && i + 1 < argc)
+            predictor.alpha = atof(argv[++i]);
+        else if (strcmp(argv[i], "--irq-interval-ns") == 0 && i + 1 < argc)
+            irq.interval = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-hardirq-ns") == 0 && i + 1 < argc)
+            irq.hardirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-softirq-ns") == 0 && i + 1 < argc)
+            irq.softirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-burst") == 0 && i + 1 < argc)
+            irq.burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--irq-compare") == 0)
+            irq_compare = true;
+        else if (strcmp(argv[i], "--host-pcpus") == 0 && i + 1 < argc)
+            host.pcpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--host-policy") == 0 && i + 1 < argc)
+            host_policy = argv[++i];
+        else if (strcmp(argv[i], "--host-slice-ns") == 0 && i + 1 < argc)
+            host.slice = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--host-tenant-vcpus") == 0 && i + 1 < argc)
+            host.tenant_vcpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--guests") == 0 && i + 1 < argc)
+            host.guests = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--guest-weight") == 0 && i + 1 < argc)
+            host.guest_weight = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--progress-file") == 0 && i + 1 < argc)
+            stats_filename = argv[++i];
+        else if (strcmp(argv[i], "--progress-interval") == 0 && i + 1 < argc)
+            progress_interval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+            metrics_socket = argv[++i];
+        else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc)
+            metrics_file = argv[++i];
+        else if (strcmp(argv[i], "--metrics-interval") == 0 && i + 1 < argc)
+            metrics_interval = atoi(argv[++i]);
+        else
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (time_unit < 1)
+    {
+        printf("Invalid time unit: %lld ns (must be at least 1)\n", (long long)time_unit);
+        return 1;
+    }
+    if (small_queue_max < 0 || small_queue_max > SMALL_QUEUE_CAPACITY)
+    {
+        printf("Invalid small queue size: %d (must be 0 to %d)\n", small_queue_max, SMALL_QUEUE_CAPACITY);
+        return 1;
+    }
+    if (dtq.base < 0)
+        dtq.base = DEFAULT_BASE_QUANTUM * time_unit;
+    dtq.current = dtq.base;
+
+    if (ticks.hz > 0)
+    {
+        ticks.period = 1000000000LL / ticks.hz;
+        if (ticks.period < 1 || ticks.overhead < 0 || ticks.overhead >= ticks.period)
+        {
+            printf("Invalid tick settings: %lld HZ with %lld ns overhead per tick\n",
+                   (long long)ticks.hz, (long long)ticks.overhead);
+            return 1;
+        }
+        tick_model = &ticks;
+    }
+
+    if (idle_states != NULL || idle_governor != NULL || idle.latency_limit >= 0)
+    {
+        if (parseIdleStates(&idle, idle_states != NULL ? idle_states : DEFAULT_IDLE_STATES) < 1)
+        {
+            printf("Invalid idle states: %s\n", idle_states);
+            return 1;
+        }
+        int governor = parseIdleGovernor(idle_governor != NULL ? idle_governor : "menu");
+        if (governor < 0)
+        {
+            printf("Unknown idle governor: %s\n", idle_governor);
+            return 1;
+        }
+        idle.governor = (IdleGovernor)governor;
+        idle_model = &idle;
+    }
+
+    if (admit.horizon < 0)
+        admit.horizon = DEFAULT_ADMISSION_HORIZON * time_unit;
+    if (admit.max_utilization < 0 || admit.horizon < 1 || admit.max_queue < 0 || admit.max_deferral < 0)
+    {
+        printf("Invalid admission settings\n");
+        return 1;
+    }
+    if (admit.max_utilization > 0 || admit.max_queue > 0 || admit.deadline_check)
+        admission = &admit;
+
+    if (irq.interval > 0)
+    {
+        // The handlers must leave the CPU some time, or no process ever finishes
+        if (irq.hardirq < 0 || irq.softirq < 0 || irq.burst < 1.0 || irq.hardirq + irq.softirq >= irq.interval)
+        {
+            printf("Invalid interrupt settings: %lld ns handlers every %lld ns in bursts of %g\n",
+                   (long long)(irq.hardirq + irq.softirq), (long long)irq.interval, irq.burst);
+            return 1;
+        }
+        irq.seed = sampling.seed;
+        irq_model = &irq;
+    }
+
+    if (host.pcpus != 0 || host_policy != NULL)
+    {
+        int policy = parseHostPolicy(host_policy != NULL ? host_policy : "credit");
+        if (policy < 0)
+        {
+            printf("Unknown host policy: %s\n", host_policy);
+            return 1;
+        }
+        host.policy = (HostPolicy)policy;
+        if (host.pcpus == 0)
+            host.pcpus = 1;
+        if (host.slice < 0)
+            host.slice = host.policy == HOST_CREDIT ? DEFAULT_CREDIT_SLICE_NS : DEFAULT_HOST_LATENCY_NS;
+        if (host.pcpus < 1 || host.guests < 1 || host.tenant_vcpus < 0 || host.guest_weight < 1 || host.slice < 1)
+        {
+            printf("Invalid host settings\n");
+            return 1;
+        }
+    }
+
+    // Actual bursts are drawn as "lognormal[:sigma]" or "exponential" around the trace's
+    BurstDistribution distribution = BURSTS_EXACT;
+    double burst_sigma = DEFAULT_BURST_SIGMA;
+    if (actual_bursts != NULL)
+    {
+        int parsed = parseBurstDistribution(actual_bursts, &burst_sigma);
+        if (parsed < 0)
+        {
+            printf("Invalid actual burst distribution: %s\n", actual_bursts);
+            return 1;
+        }
+        distribution = (BurstDistribution)parsed;
+    }
+
+    if (predictor_name != NULL)
+    {
+        int kind = parsePredictor(predictor_name);
+        if (kind < 0 || predictor.alpha <= 0 || predictor.alpha > 1)
+        {
+            printf("Invalid burst predictor: %s with alpha %g\n", predictor_name, predictor.alpha);
+            return 1;
+        }
+        predictor.kind = (PredictorKind)kind;
+        burst_predictor = &predictor;
+    }
+
+    if (slo_targets != NULL)
+    {
+        if (parseSloTargets(&slo_mode, slo_targets) < 1 || slo_mode.percentile <= 0 || slo_mode.percentile > 100)
+        {
+            printf("Invalid SLO targets: %s at p%g\n", slo_targets, slo_mode.percentile);
+            return 1;
+        }
+        slo = &slo_mode;
+    }
+
+    if (policy_name != NULL)
+    {
+        int kind = parsePolicy(policy_name);
+        if (policy.min_slice < 0)
+            policy.min_slice = time_unit;
+        if (kind < 0 || policy.min_slice < 1)
+        {
+            printf("Invalid scheduling policy: %s with minimum slice %lld ns\n", policy_name, (long long)policy.min_slice);
+            return 1;
+        }
+        if (kind != POLICY_DPS_DTQ && slo != NULL)
+        {
+            printf("Invalid scheduling policy: %s cannot run in SLO mode\n", policy_name);
+            return 1;
+        }
+        policy.policy = (SchedulingPolicy)kind;
+        if (policy.policy == POLICY_BANDED)
+            banded_queue = &bands;
+        else if (policy.policy != POLICY_DPS_DTQ)
+            deadline_policy = &policy;
+    }
+
+    if (guard.max_wait != 0)
+    {
+        if (guard.max_wait < 0 || policy.policy != POLICY_DPS_DTQ)
+        {
+            printf("Invalid maximum wait: %lld ns (the guard only applies to the sorted DPS-DTQ queue)\n", (long long)guard.max_wait);
+            return 1;
+        }
+        wait_guard = &guard;
+    }
+
+    if (lock.cpus != 0 || queue_structure != NULL || lock_wait != NULL)
+    {
+        int structure = queue_structure != NULL ? parseQueueStructure(queue_structure) : (int)lock.structure;
+        bool wait_valid = lock_wait == NULL || strcmp(lock_wait, "spin") == 0 || strcmp(lock_wait, "sleep") == 0;
+        if (lock.cpus < 1 || lock.cpus > MAX_LOCK_CPUS || structure < 0 || !wait_valid ||
+            lock.base_cost < 0 || lock.element_cost < 0 || lock.wake_latency < 0)
+        {
+            printf("Invalid lock contention model: %d CPUs, structure %s, %s waiters\n", lock.cpus,
+                   queue_structure != NULL ? queue_structure : "sorted", lock_wait != NULL ? lock_wait : "spin");
+            return 1;
+        }
+        lock.structure = (QueueStructure)structure;
+        lock.sleep = lock_wait != NULL && strcmp(lock_wait, "sleep") == 0;
+    }
+
+    // SIGUSR1 (and --progress-interval) dump live progress to stderr or --progress-file
+    startProgressReporting(stats_filename, progress_interval);
+
+    // --metrics-socket and --metrics-file export Prometheus metrics from a separate thread
+    if (metrics_socket != NULL || metrics_file != NULL)
+    {
+        if (metrics_interval < 1)
+        {
+            printf("Invalid metrics interval: %d s\n", metrics_interval);
+            return 1;
+        }
+        exporter = startMetricsExporter(METRICS_SCHEDULER, metrics_socket, metrics_file, metrics_interval);
+        if (exporter == NULL)
+        {
+            printf("Error starting metrics exporter on %s\n", metrics_socket != NULL ? metrics_socket : metrics_file);
+            return 1;
+        }
+        atexit(stopMetricsExporter);
+    }
+
+    if (steady.enabled)
+    {
+        SteadyState state;
+        n = generateSyntheticProcesses(&processes, &steady);
+        initializeSteadyState(&state, &steady);
+        steady_state = &state;
+
+        runDPS_DTQ(processes, n, &dtq);
+        if (!state.converged)
+            evaluateSteadyState(&state);
+        displaySteadyState(&state);
+
+        steady_state = NULL;
+        freeSteadyState(&state);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (first_option == 1)
+        printf("No input file specified. Using default: %s\n", filename);
+
+    // Read processes from file
+    n = readProcessesFromFile(&processes, filename);
+    if (distribution != BURSTS_EXACT)
+    {
+        srand(sampling.seed);
+        sampleActualBursts(processes, n, distribution, burst_sigma);
+    }
+
+    if (sampling.enabled)
+    {
+        runSampling(processes, n, runSampledDPS_DTQ, &dtq, &sampling);
+        free(processes);
+        return 0;
+    }
+
+    if (tick_compare && tick_model != NULL)
+    {
+        runTickComparison(processes, n, &dtq, tick_model);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (irq_compare && irq_model != NULL)
+    {
+        runInterruptComparison(processes, n, &dtq, irq_model);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (lock.cpus > 0)
+    {
+        runLockContention(processes, n, &dtq, &lock);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (wait_compare && wait_guard != NULL)
+    {
+        runWaitGuardComparison(processes, n, &dtq, wait_guard);
+        free(guard.heap);
+        free(guard.due);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (policy_compare && policy.policy != POLICY_DPS_DTQ)
+    {
+        runPolicyComparison(processes, n, &dtq, policy.policy);
+        free(policy.heap[0]);
+        free(policy.heap[1]);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
+
+    if (host.pcpus > 0)
+    {
+        // The guests run side by side and these keep the state of one run
+        if (tick_model != NULL || idle_model != NULL || admission != NULL || irq_model != NULL ||
+            burst_predictor != NULL || slo != NULL || deadline_policy != NULL || banded_queue != NULL ||
+            wait_guard != NULL || gantt_filename != NULL || stats_filename != NULL || progress_interval > 0 ||
+            metrics_socket != NULL || metrics_file != NULL)
+        {
+            printf("Invalid host settings: tick, idle, admission, interrupt, predictor and SLO models, scheduling policies, the wait guard, progress reporting, the metrics exporter and the Gantt chart cannot be used with a host\n");
+            return 1;
+        }
+        runHostedGuests(processes, n, &host, runSampledDPS_DTQ, &dtq);
+        free(processes);
+        free(gantt_chart);
+        return 0;
+    }
 
     // Run the DPS-DTQ algorithm
     runDPS_DTQ(processes, n, &dtq);
 
+    if (gantt_filename != NULL)
+        writeGanttChart(gantt_filename);
+
     // Display results
-    /*displayProcessDetails(processes, n);*/
+    if (process_details)
+        displayProcessDetails(processes, n);
     // displayGanttChart();
     displayMetrics();
-
-
+    if (tick_model != NULL)
+        displayTickStats(tick_model);
+    if (idle_model != NULL)
+        displayIdleStats(idle_model);
+    if (admission != NULL)
+        displayAdmissionStats(admission, processes, n);
+    if (irq_model != NULL)
+        displayInterruptStats(irq_model, processes, n);
+    if (burst_predictor != NULL)
+        displayPredictorStats(burst_predictor);
+    if (slo != NULL)
+        displaySloAttainment(slo, processes, n);
+    if (policy.policy != POLICY_DPS_DTQ)
+        displayPolicyStats(policy.policy, processes, n);
+    if (wait_guard != NULL)
+        displayWaitGuardStats(wait_guard, processes, n);
+
+    free(admit.deferred);
+    free(policy.heap[0]);
+    free(policy.heap[1]);
+    free(guard.heap);
+    free(guard.due);
+    free(processes);
+    free(gantt_chart);
     return 0;
 }
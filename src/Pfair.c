@@ -0,0 +1,488 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>
+
+#define MAX_FILENAME_LENGTH 256
+#define DEFAULT_CORES 4
+#define DEFAULT_MAX_HORIZON 1000000 // Quanta simulated when the hyperperiod is longer
+#define POLICIES 3
+
+// Policies compared on the periodic tasks of a trace
+typedef enum
+{
+    POLICY_GLOBAL_EDF, // Jobs in deadline order on any core
+    POLICY_PD2,        // Pfair: subtasks run within their windows, PD2 priorities
+    POLICY_ER_PD2      // ERfair: like PD2, but a job's subtasks may run before their windows
+} PolicyKind;
+
+// Periodic task with implicit deadlines, in quanta. Each job is split into
+// quantum-sized subtasks numbered from 1 across the jobs of the task; only
+// the next subtask is tracked, keyed by the policy being simulated.
+typedef struct
+{
+    int id;
+    int64_t phase;          // Release of the first job
+    int64_t execution;      // Quanta per job
+    int64_t period;
+    int64_t subtask;        // Next subtask to run
+    int64_t eligible;       // First quantum it may run in
+    int64_t deadline;       // Subtask deadline (Pfair) or job deadline (EDF)
+    int b_bit;              // 1 if the subtask's window overlaps the next one
+    int64_t group_deadline; // End of the cascade of length-2 windows (heavy tasks)
+    int64_t last_slot;      // Last quantum the task ran in, -1 if none
+    int cpu;                // Core the task last ran on, -1 if none
+} Task;
+
+// Binary min-heap of tasks
+typedef struct
+{
+    Task **items;
+    int size;
+    bool (*before)(Task *a, Task *b);
+} TaskHeap;
+
+// Outcome of one policy over the horizon
+typedef struct
+{
+    long long jobs;       // Jobs whose deadline falls within the horizon
+    long long on_time;    // Of those, completed by their deadline
+    long long preemptions; // A job stops running with work left
+    long long migrations;  // A job resumes on another core
+    int64_t max_tardiness;
+    double max_lag;       // Largest lag behind the fluid schedule, in quanta
+    double min_lag;       // Largest lead over the fluid schedule (negative)
+    long long busy;       // Core-quanta spent running tasks
+} ScheduleStats;
+
+// Function prototypes
+int64_t floorDiv(int64_t a, int64_t b);
+int64_t ceilDiv(int64_t a, int64_t b);
+int64_t groupDeadline(int64_t subtask, int64_t execution, int64_t period);
+void setSubtask(Task *task, PolicyKind policy, int64_t earliest);
+bool eligibleBefore(Task *a, Task *b);
+bool priorityBefore(Task *a, Task *b);
+void pushTask(TaskHeap *heap, Task *task);
+Task *popTask(TaskHeap *heap);
+int readPeriodicTasks(const char *filename, int64_t quantum, Task **tasks, int *aperiodic, int *overweight);
+int64_t defaultHorizon(Task *tasks, int n);
+void simulate(Task *tasks, int n, int cores, int64_t horizon, PolicyKind policy, ScheduleStats *stats);
+void displayComparison(ScheduleStats stats[POLICIES]);
+
+int64_t floorDiv(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+int64_t ceilDiv(int64_t a, int64_t b)
+{
+    return a >= 0 ? (a + b - 1) / b : -(-a / b);
+}
+
+// PD2 group deadline of a subtask of a heavy task (weight w = e/p, 1/2 <= w < 1):
+// ceil(ceil(ceil(i/w) * (1 - w)) / (1 - w)), relative to the task's phase
+int64_t groupDeadline(int64_t subtask, int64_t execution, int64_t period)
+{
+    int64_t slack = period - execution;
+    if (slack == 0)
+        return INT64_MAX / 2; // A weight-one task never leaves its cascade
+    int64_t window_end = ceilDiv(subtask * period, execution);
+    int64_t lead = ceilDiv(window_end * slack, period);
+    return ceilDiv(lead * period, slack);
+}
+
+// Key the task's next subtask for the policy; it runs no earlier than the
+// given quantum, after the previous subtask
+void setSubtask(Task *task, PolicyKind policy, int64_t earliest)
+{
+    int64_t i = task->subtask;
+    int64_t job_release = task->phase + (i - 1) / task->execution * task->period;
+
+    if (policy == POLICY_GLOBAL_EDF)
+    {
+        task->eligible = job_release;
+        task->deadline = job_release + task->period;
+        task->b_bit = 0;
+        task->group_deadline = 0;
+    }
+    else
+    {
+        // Window of subtask i: [floor((i-1)/w), ceil(i/w)) after the phase
+        task->eligible = policy == POLICY_PD2 ? task->phase + floorDiv((i - 1) * task->period, task->execution)
+                                              : job_release;
+        task->deadline = task->phase + ceilDiv(i * task->period, task->execution);
+        task->b_bit = (i * task->period) % task->execution != 0;
+        task->group_deadline = 2 * task->execution >= task->period
+                                   ? task->phase + groupDeadline(i, task->execution, task->period)
+                                   : 0;
+    }
+
+    if (task->eligible < earliest)
+        task->eligible = earliest;
+}
+
+// Order of the pending heap: release time, then task id
+bool eligibleBefore(Task *a, Task *b)
+{
+    if (a->eligible != b->eligible)
+        return a->eligible < b->eligible;
+    return a->id < b->id;
+}
+
+// PD2 priority: earlier deadline, then a set b-bit, then (for a set b-bit)
+// the later group deadline, then task id. EDF subtasks have no b-bit, which
+// leaves plain deadline order.
+bool priorityBefore(Task *a, Task *b)
+{
+    if (a->deadline != b->deadline)
+        return a->deadline < b->deadline;
+    if (a->b_bit != b->b_bit)
+        return a->b_bit > b->b_bit;
+    if (a->b_bit && a->group_deadline != b->group_deadline)
+        return a->group_deadline > b->group_deadline;
+    return a->id < b->id;
+}
+
+void pushTask(TaskHeap *heap, Task *task)
+{
+    int slot = heap->size++;
+    while (slot > 0 && heap->before(task, heap->items[(slot - 1) / 2]))
+    {
+        heap->items[slot] = heap->items[(slot - 1) / 2];
+        slot = (slot - 1) / 2;
+    }
+    heap->items[slot] = task;
+}
+
+Task *popTask(TaskHeap *heap)
+{
+    Task *top = heap->items[0];
+    Task *last = heap->items[--heap->size];
+    int slot = 0;
+    while (2 * slot + 1 < heap->size)
+    {
+        int child = 2 * slot + 1;
+        if (child + 1 < heap->size && heap->before(heap->items[child + 1], heap->items[child]))
+            child++;
+        if (!heap->before(heap->items[child], last))
+            break;
+        heap->items[slot] = heap->items[child];
+        slot = child;
+    }
+    if (heap->size > 0)
+        heap->items[slot] = last;
+    return top;
+}
+
+// Read the periodic processes of a text trace as tasks: the arrival is the
+// phase, the burst the execution per job and the period also the relative
+// deadline, all rounded to whole quanta. Returns the number of tasks.
+int readPeriodicTasks(const char *filename, int64_t quantum, Task **tasks, int *aperiodic, int *overweight)
+{
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", filename);
+        return -1;
+    }
+
+    int n;
+    if (fscanf(file, "%d", &n) != 1 || n < 0)
+    {
+        printf("Error reading number of processes from file.\n");
+        fclose(file);
+        return -1;
+    }
+
+    *tasks = (Task *)malloc(sizeof(Task) * (n > 0 ? n : 1));
+    if (*tasks == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        fclose(file);
+        return -1;
+    }
+
+    int count = 0;
+    *aperiodic = 0;
+    *overweight = 0;
+    long long id, arrival, burst, deadline, criticality, period, priority;
+    for (int read = 0; read < n; read++)
+    {
+        if (fscanf(file, "%lld %lld %lld %lld %lld %lld %lld",
+                   &id, &arrival, &burst, &deadline, &criticality, &period, &priority) != 7)
+        {
+            printf("Warning: expected %d processes, read %d\n", n, read);
+            break;
+        }
+
+        if (period <= 0)
+        {
+            (*aperiodic)++;
+            continue;
+        }
+
+        Task *task = &(*tasks)[count];
+        task->id = (int)id;
+        task->phase = ceilDiv(arrival, quantum);
+        task->execution = ceilDiv(burst, quantum);
+        task->period = period / quantum;
+        if (task->execution < 1 || task->execution > task->period)
+        {
+            (*overweight)++;
+            continue;
+        }
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+// Hyperperiod of the tasks after the last phase, or DEFAULT_MAX_HORIZON
+// quanta if that is shorter
+int64_t defaultHorizon(Task *tasks, int n)
+{
+    int64_t hyperperiod = 1;
+    int64_t last_phase = 0;
+    for (int i = 0; i < n; i++)
+    {
+        int64_t a = hyperperiod, b = tasks[i].period;
+        while (b != 0)
+        {
+            int64_t r = a % b;
+            a = b;
+            b = r;
+        }
+        hyperperiod = hyperperiod / a * tasks[i].period;
+        if (hyperperiod > DEFAULT_MAX_HORIZON)
+            return DEFAULT_MAX_HORIZON;
+        if (tasks[i].phase > last_phase)
+            last_phase = tasks[i].phase;
+    }
+    int64_t horizon = last_phase + hyperperiod;
+    return horizon < DEFAULT_MAX_HORIZON ? horizon : DEFAULT_MAX_HORIZON;
+}
+
+// Run the tasks on the given number of cores for the horizon, one quantum at
+// a time. Waiting subtasks sit in a heap by release and ready ones in a heap
+// by priority, so a quantum costs O(cores log n) and idle stretches are
+// skipped, whatever the number of tasks.
+void simulate(Task *tasks, int n, int cores, int64_t horizon, PolicyKind policy, ScheduleStats *stats)
+{
+    TaskHeap pending = {(Task **)malloc(sizeof(Task *) * (n > 0 ? n : 1)), 0, eligibleBefore};
+    TaskHeap ready = {(Task **)malloc(sizeof(Task *) * (n > 0 ? n : 1)), 0, priorityBefore};
+    Task **running = (Task **)calloc(cores, sizeof(Task *)); // Task on each core in the last quantum
+    Task **owner = (Task **)calloc(cores, sizeof(Task *));
+    Task **selected = (Task **)malloc(sizeof(Task *) * cores);
+    if (pending.items == NULL || ready.items == NULL || running == NULL || owner == NULL || selected == NULL)
+    {
+        printf("Not enough memory for %d tasks on %d cores\n", n, cores);
+        exit(1);
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < n; i++)
+    {
+        Task *task = &tasks[i];
+        task->subtask = 1;
+        task->last_slot = -1;
+        task->cpu = -1;
+        setSubtask(task, policy, 0);
+        if (task->eligible < horizon)
+            pushTask(&pending, task);
+        if (horizon >= task->phase)
+            stats->jobs += (horizon - task->phase) / task->period;
+    }
+
+    int64_t t = 0;
+    while (t < horizon)
+    {
+        while (pending.size > 0 && pending.items[0]->eligible <= t)
+            pushTask(&ready, popTask(&pending));
+
+        int count = 0;
+        while (count < cores && ready.size > 0)
+            selected[count++] = popTask(&ready);
+        for (int k = 0; k < count; k++)
+            selected[k]->last_slot = t;
+
+        // A task that ran in the last quantum and not in this one is preempted
+        // unless its job has completed
+        for (int c = 0; c < cores; c++)
+        {
+            Task *task = running[c];
+            if (task != NULL && task->last_slot == t - 1 && (task->subtask - 1) % task->execution != 0)
+                stats->preemptions++;
+            owner[c] = NULL;
+        }
+
+        // Tasks that keep running stay on their core, and tasks that resume take
+        // the core they ran on last when it is free; the others take the free
+        // cores in order. A job moving to another core migrates.
+        int next_free = 0;
+        for (int pass = 0; pass < 3; pass++)
+        {
+            for (int k = 0; k < count; k++)
+            {
+                Task *task = selected[k];
+                if (task->cpu >= 0 && owner[task->cpu] == task)
+                    continue;
+                if (pass < 2)
+                {
+                    if (task->cpu >= 0 && owner[task->cpu] == NULL && (pass == 1 || running[task->cpu] == task))
+                        owner[task->cpu] = task;
+                    continue;
+                }
+                while (owner[next_free] != NULL)
+                    next_free++;
+                owner[next_free] = task;
+                if (task->cpu >= 0 && (task->subtask - 1) % task->execution != 0)
+                    stats->migrations++;
+                task->cpu = next_free;
+            }
+        }
+
+        for (int k = 0; k < count; k++)
+        {
+            Task *task = selected[k];
+            int64_t i = task->subtask;
+
+            // Lag against the fluid schedule just before and just after the quantum
+            double before = ((double)(t - task->phase) * task->execution - (double)(i - 1) * task->period) / task->period;
+            double after = before + (double)task->execution / task->period - 1.0;
+            if (before > stats->max_lag)
+                stats->max_lag = before;
+            if (after < stats->min_lag)
+                stats->min_lag = after;
+
+            if (i % task->execution == 0)
+            {
+                int64_t job_deadline = task->phase + i / task->execution * task->period;
+                if (job_deadline <= horizon && t + 1 <= job_deadline)
+                    stats->on_time++;
+                else if (job_deadline <= horizon && t + 1 - job_deadline > stats->max_tardiness)
+                    stats->max_tardiness = t + 1 - job_deadline;
+            }
+
+            task->subtask++;
+            setSubtask(task, policy, t + 1);
+            if (task->eligible < horizon)
+                pushTask(&pending, task);
+        }
+        stats->busy += count;
+        memcpy(running, owner, sizeof(Task *) * cores);
+
+        // With nothing ready, skip to the next release
+        if (ready.size == 0 && count == 0)
+        {
+            if (pending.size == 0)
+                break;
+            t = pending.items[0]->eligible;
+            continue;
+        }
+        t++;
+    }
+
+    // Tasks left behind at the end of the horizon
+    for (int i = 0; i < n; i++)
+    {
+        Task *task = &tasks[i];
+        if (horizon <= task->phase)
+            continue;
+        double lag = ((double)(horizon - task->phase) * task->execution - (double)(task->subtask - 1) * task->period) / task->period;
+        if (lag > stats->max_lag)
+            stats->max_lag = lag;
+    }
+
+    free(pending.items);
+    free(ready.items);
+    free(running);
+    free(owner);
+    free(selected);
+}
+
+// Write the policies side by side as CSV rows
+void displayComparison(ScheduleStats stats[POLICIES])
+{
+    printf("Metric,Global EDF,PD2,ER-PD2\n");
+    printf("Jobs Due,%lld,%lld,%lld\n", stats[0].jobs, stats[1].jobs, stats[2].jobs);
+    printf("Deadline Misses,%lld,%lld,%lld\n",
+           stats[0].jobs - stats[0].on_time, stats[1].jobs - stats[1].on_time, stats[2].jobs - stats[2].on_time);
+    printf("Max Tardiness,%lld,%lld,%lld\n",
+           (long long)stats[0].max_tardiness, (long long)stats[1].max_tardiness, (long long)stats[2].max_tardiness);
+    printf("Preemptions,%lld,%lld,%lld\n", stats[0].preemptions, stats[1].preemptions, stats[2].preemptions);
+    printf("Migrations,%lld,%lld,%lld\n", stats[0].migrations, stats[1].migrations, stats[2].migrations);
+    printf("Max Lag,%.2f,%.2f,%.2f\n", stats[0].max_lag, stats[1].max_lag, stats[2].max_lag);
+    printf("Min Lag,%.2f,%.2f,%.2f\n", stats[0].min_lag, stats[1].min_lag, stats[2].min_lag);
+    printf("Busy Quanta,%lld,%lld,%lld\n", stats[0].busy, stats[1].busy, stats[2].busy);
+}
+
+// Schedule the periodic tasks of a trace on several cores under global EDF,
+// PD2 and early-release PD2, and compare them
+int main(int argc, char *argv[])
+{
+    char filename[MAX_FILENAME_LENGTH] = "";
+    int cores = DEFAULT_CORES;
+    int64_t quantum = 1;
+    int64_t horizon = -1; // The hyperperiod unless given
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc)
+            cores = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc)
+            quantum = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc)
+            horizon = strtoll(argv[++i], NULL, 10);
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        else
+        {
+            strncpy(filename, argv[i], MAX_FILENAME_LENGTH - 1);
+            filename[MAX_FILENAME_LENGTH - 1] = '\0';
+        }
+    }
+
+    if (filename[0] == '\0')
+    {
+        printf("Usage: %s <input_file> [--cores M] [--quantum Q] [--horizon H]\n", argv[0]);
+        return 1;
+    }
+    if (cores < 1 || quantum < 1 || horizon == 0 || horizon < -1)
+    {
+        printf("Invalid schedule: %d cores, quantum %lld, horizon %lld\n", cores, (long long)quantum, (long long)horizon);
+        return 1;
+    }
+
+    Task *tasks;
+    int aperiodic, overweight;
+    int n = readPeriodicTasks(filename, quantum, &tasks, &aperiodic, &overweight);
+    if (n < 0)
+        return 1;
+
+    horizon = horizon > 0 ? ceilDiv(horizon, quantum) : defaultHorizon(tasks, n);
+
+    double utilization = 0.0;
+    for (int i = 0; i < n; i++)
+        utilization += (double)tasks[i].execution / tasks[i].period;
+
+    printf("Metric,Value\n");
+    printf("Periodic Tasks,%d\n", n);
+    printf("Aperiodic Processes Skipped,%d\n", aperiodic);
+    printf("Overweight Tasks Skipped,%d\n", overweight);
+    printf("Cores,%d\n", cores);
+    printf("Total Utilization,%.4f\n", utilization);
+    printf("Horizon (quanta),%lld\n", (long long)horizon);
+
+    ScheduleStats stats[POLICIES];
+    for (int p = 0; p < POLICIES; p++)
+        simulate(tasks, n, cores, horizon, (PolicyKind)p, &stats[p]);
+    displayComparison(stats);
+
+    free(tasks);
+    return 0;
+}
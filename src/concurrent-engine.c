@@ -0,0 +1,567 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define MAX_FILENAME_LENGTH 256
+#define MAX_THREADS 64
+#define QUEUES_PER_WORKER 2   // MultiQueue factor: local heaps per worker
+#define POP_ATTEMPTS 4        // Sampled pops before a worker counts as idle
+#define INBOX_BATCH 64        // Arrivals a worker moves from its inbox per round
+#define INITIAL_HEAP_CAPACITY 64
+#define NO_DEADLINE (INT64_MAX / 4) // Key of jobs without a deadline, before their arrival time
+#define EMPTY_KEY INT64_MAX
+
+// One job of the trace; ordered by key, the smaller first
+typedef struct Job
+{
+    int id;
+    int64_t key;             // Deadline, or NO_DEADLINE + arrival without one
+    int64_t burst;
+    _Atomic(struct Job *) next; // Link in an MPSC inbox
+    atomic_int runs;         // Times a worker ran it, checked after each benchmark
+} Job;
+
+// Vyukov's intrusive multi-producer single-consumer queue: producers swap
+// themselves in at the head with one atomic exchange, and the owner consumes
+// from the tail without atomics read-modify-writes
+typedef struct
+{
+    _Atomic(Job *) head;
+    Job *tail;
+    Job stub;
+} MpscQueue;
+
+// Binary heap of jobs behind a spinlock, with its top key cached so other
+// workers can sample it without taking the lock
+typedef struct
+{
+    atomic_flag lock;
+    _Atomic int64_t top;
+    Job **items;
+    int size;
+    int capacity;
+} LockedHeap;
+
+// State of one worker of the concurrent engine
+typedef struct
+{
+    int index;
+    MpscQueue inbox;
+    LockedHeap queues[QUEUES_PER_WORKER];
+    uint64_t rng;
+    long long steals;      // Jobs taken from another worker's queue
+    long long empty_polls; // Rounds without a job
+} Worker;
+
+// Engines compared by the benchmark
+typedef enum
+{
+    ENGINE_MUTEX,     // One heap behind a pthread mutex
+    ENGINE_CONCURRENT // MPSC inboxes, per-worker MultiQueue heaps, sampling and stealing
+} EngineKind;
+
+// Everything the threads of one benchmark run share
+typedef struct
+{
+    EngineKind kind;
+    Job *jobs;
+    int total;
+    int producers;
+    int workers;
+    int work_iterations;
+    Worker *worker;          // Concurrent engine
+    pthread_mutex_t mutex;   // Mutex engine
+    Job **heap;
+    int heap_size;
+    int heap_capacity;
+    atomic_int completed;
+    pthread_barrier_t start;
+} Engine;
+
+// Thread argument: the engine and the thread's index
+typedef struct
+{
+    Engine *engine;
+    int index;
+} ThreadArgument;
+
+// Function prototypes
+void mpscInit(MpscQueue *queue);
+void mpscPush(MpscQueue *queue, Job *job);
+Job *mpscPop(MpscQueue *queue);
+void heapPush(Job ***items, int *size, int *capacity, Job *job);
+Job *heapPop(Job **items, int *size);
+void lockHeap(LockedHeap *heap);
+void unlockHeap(LockedHeap *heap);
+uint64_t nextRandom(uint64_t *state);
+void insertLocal(Worker *worker, Job *job);
+Job *popRelaxed(Engine *engine, Worker *worker);
+void runJob(Engine *engine, Job *job);
+void *runProducer(void *argument);
+void *runWorker(void *argument);
+int readJobs(const char *filename, Job **jobs);
+double runBenchmark(Engine *engine, long long *steals);
+double elapsedSeconds(struct timespec *start, struct timespec *end);
+
+void mpscInit(MpscQueue *queue)
+{
+    atomic_store(&queue->stub.next, NULL);
+    atomic_store(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+}
+
+void mpscPush(MpscQueue *queue, Job *job)
+{
+    atomic_store_explicit(&job->next, NULL, memory_order_relaxed);
+    Job *previous = atomic_exchange_explicit(&queue->head, job, memory_order_acq_rel);
+    atomic_store_explicit(&previous->next, job, memory_order_release);
+}
+
+// Next job of the inbox, or NULL if it is empty or a producer is halfway
+// through a push (the job then shows up on a later call)
+Job *mpscPop(MpscQueue *queue)
+{
+    Job *tail = queue->tail;
+    Job *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &queue->stub)
+    {
+        if (next == NULL)
+            return NULL;
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+    if (next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire))
+        return NULL;
+    mpscPush(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+void heapPush(Job ***items, int *size, int *capacity, Job *job)
+{
+    if (*size == *capacity)
+    {
+        *capacity = *capacity > 0 ? *capacity * 2 : INITIAL_HEAP_CAPACITY;
+        *items = (Job **)realloc(*items, sizeof(Job *) * *capacity);
+        if (*items == NULL)
+        {
+            printf("Not enough memory for %d queued jobs\n", *capacity);
+            exit(1);
+        }
+    }
+
+    Job **h = *items;
+    int slot = (*size)++;
+    while (slot > 0 && job->key < h[(slot - 1) / 2]->key)
+    {
+        h[slot] = h[(slot - 1) / 2];
+        slot = (slot - 1) / 2;
+    }
+    h[slot] = job;
+}
+
+Job *heapPop(Job **items, int *size)
+{
+    if (*size == 0)
+        return NULL;
+
+    Job *top = items[0];
+    Job *last = items[--(*size)];
+    int slot = 0;
+    while (2 * slot + 1 < *size)
+    {
+        int child = 2 * slot + 1;
+        if (child + 1 < *size && items[child + 1]->key < items[child]->key)
+            child++;
+        if (items[child]->key >= last->key)
+            break;
+        items[slot] = items[child];
+        slot = child;
+    }
+    if (*size > 0)
+        items[slot] = last;
+    return top;
+}
+
+void lockHeap(LockedHeap *heap)
+{
+    while (atomic_flag_test_and_set_explicit(&heap->lock, memory_order_acquire))
+        sched_yield();
+}
+
+void unlockHeap(LockedHeap *heap)
+{
+    atomic_store_explicit(&heap->top, heap->size > 0 ? heap->items[0]->key : EMPTY_KEY, memory_order_relaxed);
+    atomic_flag_clear_explicit(&heap->lock, memory_order_release);
+}
+
+// xorshift64*
+uint64_t nextRandom(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+// Queue an arrival in one of the worker's own heaps, picked at random
+void insertLocal(Worker *worker, Job *job)
+{
+    LockedHeap *heap = &worker->queues[nextRandom(&worker->rng) % QUEUES_PER_WORKER];
+    lockHeap(heap);
+    heapPush(&heap->items, &heap->size, &heap->capacity, job);
+    unlockHeap(heap);
+}
+
+// MultiQueue-style pop: compare the cached tops of the worker's best heap and
+// of a heap sampled from all workers, and take from the better one. The global
+// order is only approximate, but no lock is ever waited for; a worker whose
+// own heaps are empty steals whatever the sample finds.
+Job *popRelaxed(Engine *engine, Worker *worker)
+{
+    int queue_count = engine->workers * QUEUES_PER_WORKER;
+    for (int attempt = 0; attempt < POP_ATTEMPTS; attempt++)
+    {
+        LockedHeap *own = &worker->queues[0];
+        for (int q = 1; q < QUEUES_PER_WORKER; q++)
+        {
+            if (atomic_load_explicit(&worker->queues[q].top, memory_order_relaxed) <
+                atomic_load_explicit(&own->top, memory_order_relaxed))
+                own = &worker->queues[q];
+        }
+        int sampled = (int)(nextRandom(&worker->rng) % queue_count);
+        LockedHeap *other = &engine->worker[sampled / QUEUES_PER_WORKER].queues[sampled % QUEUES_PER_WORKER];
+
+        LockedHeap *pick = own;
+        if (atomic_load_explicit(&other->top, memory_order_relaxed) < atomic_load_explicit(&own->top, memory_order_relaxed))
+            pick = other;
+        if (atomic_load_explicit(&pick->top, memory_order_relaxed) == EMPTY_KEY)
+            continue;
+        if (atomic_flag_test_and_set_explicit(&pick->lock, memory_order_acquire))
+            continue;
+
+        Job *job = heapPop(pick->items, &pick->size);
+        unlockHeap(pick);
+        if (job == NULL)
+            continue;
+        if (sampled / QUEUES_PER_WORKER != worker->index && pick == other)
+            worker->steals++;
+        return job;
+    }
+    return NULL;
+}
+
+// Execute a job: the configured busy work, then count it done
+void runJob(Engine *engine, Job *job)
+{
+    volatile int sink = 0;
+    for (int i = 0; i < engine->work_iterations; i++)
+        sink += i;
+    atomic_fetch_add_explicit(&job->runs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&engine->completed, 1, memory_order_release);
+}
+
+// Submit every producer-th job, spreading them over the workers' inboxes
+void *runProducer(void *argument)
+{
+    ThreadArgument *thread = (ThreadArgument *)argument;
+    Engine *engine = thread->engine;
+    pthread_barrier_wait(&engine->start);
+
+    for (int j = thread->index; j < engine->total; j += engine->producers)
+    {
+        Job *job = &engine->jobs[j];
+        if (engine->kind == ENGINE_MUTEX)
+        {
+            pthread_mutex_lock(&engine->mutex);
+            heapPush(&engine->heap, &engine->heap_size, &engine->heap_capacity, job);
+            pthread_mutex_unlock(&engine->mutex);
+        }
+        else
+        {
+            mpscPush(&engine->worker[j % engine->workers].inbox, job);
+        }
+    }
+    return NULL;
+}
+
+// Run jobs until all of them are done
+void *runWorker(void *argument)
+{
+    ThreadArgument *thread = (ThreadArgument *)argument;
+    Engine *engine = thread->engine;
+    Worker *worker = engine->kind == ENGINE_CONCURRENT ? &engine->worker[thread->index] : NULL;
+    pthread_barrier_wait(&engine->start);
+
+    while (atomic_load_explicit(&engine->completed, memory_order_acquire) < engine->total)
+    {
+        Job *job;
+        if (worker == NULL)
+        {
+            pthread_mutex_lock(&engine->mutex);
+            job = heapPop(engine->heap, &engine->heap_size);
+            pthread_mutex_unlock(&engine->mutex);
+        }
+        else
+        {
+            Job *arrival;
+            for (int k = 0; k < INBOX_BATCH && (arrival = mpscPop(&worker->inbox)) != NULL; k++)
+                insertLocal(worker, arrival);
+            job = popRelaxed(engine, worker);
+            if (job == NULL)
+                worker->empty_polls++;
+        }
+
+        if (job != NULL)
+            runJob(engine, job);
+        else
+            sched_yield();
+    }
+    return NULL;
+}
+
+// Read the jobs of a text trace: count, then one process per line
+int readJobs(const char *filename, Job **jobs)
+{
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", filename);
+        return -1;
+    }
+
+    int n;
+    if (fscanf(file, "%d", &n) != 1 || n < 1)
+    {
+        printf("Error reading number of processes from file.\n");
+        fclose(file);
+        return -1;
+    }
+
+    *jobs = (Job *)calloc(n, sizeof(Job));
+    if (*jobs == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        fclose(file);
+        return -1;
+    }
+
+    long long id, arrival, burst, deadline, criticality, period, priority;
+    int read = 0;
+    while (read < n && fscanf(file, "%lld %lld %lld %lld %lld %lld %lld",
+                              &id, &arrival, &burst, &deadline, &criticality, &period, &priority) == 7)
+    {
+        Job *job = &(*jobs)[read++];
+        job->id = (int)id;
+        job->key = deadline > 0 ? deadline : NO_DEADLINE + arrival;
+        job->burst = burst;
+    }
+    fclose(file);
+
+    if (read < n)
+        printf("Warning: expected %d processes, read %d\n", n, read);
+    return read;
+}
+
+double elapsedSeconds(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Run all jobs through the engine with its producers and workers; returns the
+// wall-clock seconds from the common start until the last worker is done
+double runBenchmark(Engine *engine, long long *steals)
+{
+    int threads = engine->producers + engine->workers;
+    pthread_t *thread = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    ThreadArgument *arguments = (ThreadArgument *)malloc(sizeof(ThreadArgument) * threads);
+    if (thread == NULL || arguments == NULL)
+    {
+        printf("Not enough memory for %d threads\n", threads);
+        exit(1);
+    }
+
+    for (int j = 0; j < engine->total; j++)
+        atomic_store(&engine->jobs[j].runs, 0);
+    atomic_store(&engine->completed, 0);
+    engine->heap = NULL;
+    engine->heap_size = 0;
+    engine->heap_capacity = 0;
+    engine->worker = NULL;
+    if (engine->kind == ENGINE_MUTEX)
+    {
+        pthread_mutex_init(&engine->mutex, NULL);
+    }
+    else
+    {
+        engine->worker = (Worker *)calloc(engine->workers, sizeof(Worker));
+        if (engine->worker == NULL)
+        {
+            printf("Not enough memory for %d workers\n", engine->workers);
+            exit(1);
+        }
+        for (int w = 0; w < engine->workers; w++)
+        {
+            Worker *worker = &engine->worker[w];
+            worker->index = w;
+            worker->rng = 0x9E3779B97F4A7C15ULL * (w + 1);
+            mpscInit(&worker->inbox);
+            for (int q = 0; q < QUEUES_PER_WORKER; q++)
+            {
+                atomic_flag_clear(&worker->queues[q].lock);
+                atomic_store(&worker->queues[q].top, EMPTY_KEY);
+            }
+        }
+    }
+    pthread_barrier_init(&engine->start, NULL, threads + 1);
+
+    for (int t = 0; t < threads; t++)
+    {
+        arguments[t].engine = engine;
+        arguments[t].index = t < engine->producers ? t : t - engine->producers;
+        if (pthread_create(&thread[t], NULL, t < engine->producers ? runProducer : runWorker, &arguments[t]) != 0)
+        {
+            printf("Error starting thread %d\n", t);
+            exit(1);
+        }
+    }
+
+    // The clock starts before the threads are released, which on few cores
+    // may run them before this thread is scheduled again
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_barrier_wait(&engine->start);
+    for (int t = engine->producers; t < threads; t++)
+        pthread_join(thread[t], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    for (int t = 0; t < engine->producers; t++)
+        pthread_join(thread[t], NULL);
+
+    *steals = 0;
+    if (engine->kind == ENGINE_MUTEX)
+    {
+        pthread_mutex_destroy(&engine->mutex);
+        free(engine->heap);
+    }
+    else
+    {
+        for (int w = 0; w < engine->workers; w++)
+        {
+            *steals += engine->worker[w].steals;
+            for (int q = 0; q < QUEUES_PER_WORKER; q++)
+                free(engine->worker[w].queues[q].items);
+        }
+        free(engine->worker);
+    }
+    pthread_barrier_destroy(&engine->start);
+    free(thread);
+    free(arguments);
+    return elapsedSeconds(&start, &end);
+}
+
+// Benchmark the concurrent engine against a mutex-wrapped single heap with
+// 1, 2, 4, ... up to --max-threads producers and as many workers
+int main(int argc, char *argv[])
+{
+    static const char *engine_names[] = {"mutex", "concurrent"};
+    char filename[MAX_FILENAME_LENGTH] = "";
+    int max_threads = MAX_THREADS;
+    int producers = 0; // As many as workers unless given
+    int work_iterations = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc)
+            max_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--producers") == 0 && i + 1 < argc)
+            producers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--work-iterations") == 0 && i + 1 < argc)
+            work_iterations = atoi(argv[++i]);
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        else
+        {
+            strncpy(filename, argv[i], MAX_FILENAME_LENGTH - 1);
+            filename[MAX_FILENAME_LENGTH - 1] = '\0';
+        }
+    }
+
+    if (filename[0] == '\0')
+    {
+        printf("Usage: %s <input_file> [--max-threads T] [--producers P] [--work-iterations K]\n", argv[0]);
+        return 1;
+    }
+    if (max_threads < 1 || max_threads > MAX_THREADS || producers < 0 || producers > MAX_THREADS || work_iterations < 0)
+    {
+        printf("Invalid benchmark: %d threads, %d producers, %d work iterations\n", max_threads, producers, work_iterations);
+        return 1;
+    }
+
+    Job *jobs;
+    int n = readJobs(filename, &jobs);
+    if (n < 0)
+        return 1;
+
+    printf("Threads,Engine,Seconds,Throughput (jobs/s),Scaling,Steals\n");
+    double base_throughput[2] = {0.0, 0.0};
+    for (int threads = 1;; threads = threads * 2 < max_threads ? threads * 2 : max_threads)
+    {
+        for (int kind = 0; kind < 2; kind++)
+        {
+            Engine engine;
+            memset(&engine, 0, sizeof(engine));
+            engine.kind = (EngineKind)kind;
+            engine.jobs = jobs;
+            engine.total = n;
+            engine.workers = threads;
+            engine.producers = producers > 0 ? producers : threads;
+            engine.work_iterations = work_iterations;
+
+            long long steals;
+            double seconds = runBenchmark(&engine, &steals);
+
+            // Every job must have run exactly once
+            for (int j = 0; j < n; j++)
+            {
+                if (atomic_load(&jobs[j].runs) != 1)
+                {
+                    printf("Error: job %d ran %d times under the %s engine with %d threads\n",
+                           jobs[j].id, atomic_load(&jobs[j].runs), engine_names[kind], threads);
+                    free(jobs);
+                    return 1;
+                }
+            }
+
+            double throughput = seconds > 0 ? n / seconds : 0.0;
+            if (threads == 1)
+                base_throughput[kind] = throughput;
+            printf("%d,%s,%.4f,%.0f,%.2f,%lld\n", threads, engine_names[kind], seconds, throughput,
+                   base_throughput[kind] > 0 ? throughput / base_throughput[kind] : 0.0, steals);
+        }
+        if (threads == max_threads)
+            break;
+    }
+
+    free(jobs);
+    return 0;
+}
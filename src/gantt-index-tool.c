@@ -0,0 +1,530 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "gantt-index.h"
+
+#define INITIAL_SEGMENT_CAPACITY 4096
+#define INITIAL_PID_TABLE_SIZE 1024
+#define MAX_LINE_LENGTH 256
+
+// Chain state of one pid while the index is built
+typedef struct
+{
+    PidEntry entry;
+    int64_t last_segment;
+    bool used;
+} PidSlot;
+
+// Open-addressing pid table (size is a power of two)
+typedef struct
+{
+    PidSlot *slots;
+    int64_t size;
+    int64_t count;
+} PidTable;
+
+// Function prototypes
+int compareByCpuAndStart(const void *a, const void *b);
+int compareByPid(const void *a, const void *b);
+PidSlot *findPidSlot(PidTable *table, int32_t pid);
+int linkPidChains(Segment *segments, CpuEntry *cpus, int64_t cpu_count, PidTable *table);
+int64_t readSegments(const char *filename, Segment **out);
+int buildIndex(const char *segments_file, const char *index_file);
+void queryWindow(GanttIndex *index, int64_t t1, int64_t t2);
+void queryUtilization(GanttIndex *index, int64_t cpu, int64_t t1, int64_t t2);
+void queryPid(GanttIndex *index, int64_t pid);
+void displayInfo(GanttIndex *index);
+void printUsage(const char *program);
+
+// Order segments by cpu, then by start time
+int compareByCpuAndStart(const void *a, const void *b)
+{
+    const Segment *s1 = (const Segment *)a;
+    const Segment *s2 = (const Segment *)b;
+    if (s1->cpu != s2->cpu)
+        return s1->cpu < s2->cpu ? -1 : 1;
+    if (s1->start != s2->start)
+        return s1->start < s2->start ? -1 : 1;
+    return 0;
+}
+
+// Order pid table entries by pid
+int compareByPid(const void *a, const void *b)
+{
+    const PidEntry *p1 = (const PidEntry *)a;
+    const PidEntry *p2 = (const PidEntry *)b;
+    if (p1->pid != p2->pid)
+        return p1->pid < p2->pid ? -1 : 1;
+    return 0;
+}
+
+// Find (or claim) the slot of a pid, doubling the table at half load.
+// Returns NULL, with the table unchanged, when it cannot grow.
+PidSlot *findPidSlot(PidTable *table, int32_t pid)
+{
+    if (2 * (table->count + 1) > table->size)
+    {
+        PidSlot *old = table->slots;
+        int64_t old_size = table->size;
+        table->size = old_size ? old_size * 2 : INITIAL_PID_TABLE_SIZE;
+        table->slots = (PidSlot *)calloc(table->size, sizeof(PidSlot));
+        if (table->slots == NULL)
+        {
+            table->slots = old;
+            table->size = old_size;
+            return NULL;
+        }
+        table->count = 0;
+        for (int64_t i = 0; i < old_size; i++)
+        {
+            if (old[i].used)
+                *findPidSlot(table, (int32_t)old[i].entry.pid) = old[i];
+        }
+        free(old);
+    }
+
+    uint64_t mask = (uint64_t)table->size - 1;
+    uint64_t i = ((uint32_t)pid * 2654435761u) & mask;
+    while (table->slots[i].used && table->slots[i].entry.pid != pid)
+    {
+        i = (i + 1) & mask;
+    }
+
+    if (!table->slots[i].used)
+    {
+        table->slots[i].used = true;
+        table->slots[i].entry.pid = pid;
+        table->slots[i].entry.first_segment = -1;
+        table->slots[i].last_segment = -1;
+        table->count++;
+    }
+    return &table->slots[i];
+}
+
+// Link the segments of each pid in time order. The per-cpu runs are already
+// time-sorted, so they are merged through a min-heap of cpu cursors.
+// Returns 1 when memory runs out.
+int linkPidChains(Segment *segments, CpuEntry *cpus, int64_t cpu_count, PidTable *table)
+{
+    int64_t *heap = (int64_t *)malloc(sizeof(int64_t) * (cpu_count > 0 ? cpu_count : 1));
+    int64_t *cursor = (int64_t *)malloc(sizeof(int64_t) * (cpu_count > 0 ? cpu_count : 1));
+    int64_t heap_size = 0;
+    if (heap == NULL || cursor == NULL)
+    {
+        free(cursor);
+        free(heap);
+        return 1;
+    }
+
+    for (int64_t c = 0; c < cpu_count; c++)
+    {
+        cursor[c] = cpus[c].first_segment;
+        if (cpus[c].segment_count > 0)
+            heap[heap_size++] = c;
+    }
+
+    // Heap order: earliest current segment start first, ties by cpu
+    #define CURSOR_BEFORE(a, b) (segments[cursor[a]].start < segments[cursor[b]].start || \
+                                 (segments[cursor[a]].start == segments[cursor[b]].start && (a) < (b)))
+    for (int64_t i = heap_size / 2 - 1; i >= 0; i--)
+    {
+        for (int64_t parent = i;;)
+        {
+            int64_t child = 2 * parent + 1;
+            if (child >= heap_size)
+                break;
+            if (child + 1 < heap_size && CURSOR_BEFORE(heap[child + 1], heap[child]))
+                child++;
+            if (!CURSOR_BEFORE(heap[child], heap[parent]))
+                break;
+            int64_t temp = heap[parent];
+            heap[parent] = heap[child];
+            heap[child] = temp;
+            parent = child;
+        }
+    }
+
+    while (heap_size > 0)
+    {
+        int64_t c = heap[0];
+        int64_t i = cursor[c]++;
+        Segment *segment = &segments[i];
+
+        PidSlot *slot = findPidSlot(table, segment->pid);
+        if (slot == NULL)
+        {
+            free(cursor);
+            free(heap);
+            return 1;
+        }
+        if (slot->last_segment < 0)
+            slot->entry.first_segment = i;
+        else
+            segments[slot->last_segment].next_same_pid = i;
+        slot->last_segment = i;
+        slot->entry.segment_count++;
+        slot->entry.total_time += segment->end - segment->start;
+
+        // Advance this cpu's cursor and restore the heap
+        if (cursor[c] == cpus[c].first_segment + cpus[c].segment_count)
+            heap[0] = heap[--heap_size];
+        for (int64_t parent = 0;;)
+        {
+            int64_t child = 2 * parent + 1;
+            if (child >= heap_size)
+                break;
+            if (child + 1 < heap_size && CURSOR_BEFORE(heap[child + 1], heap[child]))
+                child++;
+            if (!CURSOR_BEFORE(heap[child], heap[parent]))
+                break;
+            int64_t temp = heap[parent];
+            heap[parent] = heap[child];
+            heap[child] = temp;
+            parent = child;
+        }
+    }
+    #undef CURSOR_BEFORE
+
+    free(cursor);
+    free(heap);
+    return 0;
+}
+
+// Read busy segments from a Gantt CSV (CPU,ProcessID,StartTime,EndTime).
+// Idle (-1) and empty segments are skipped. Returns the segment count.
+int64_t readSegments(const char *filename, Segment **out)
+{
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", filename);
+        return -1;
+    }
+
+    int64_t count = 0;
+    int64_t capacity = INITIAL_SEGMENT_CAPACITY;
+    Segment *segments = (Segment *)malloc(sizeof(Segment) * capacity);
+    char line[MAX_LINE_LENGTH];
+
+    while (segments != NULL && fgets(line, sizeof(line), file) != NULL)
+    {
+        long long cpu, pid, start, end;
+        if (sscanf(line, "%lld,%lld,%lld,%lld", &cpu, &pid, &start, &end) != 4)
+            continue; // Header or blank line
+
+        if (pid < 0 || end <= start)
+            continue;
+
+        if (count == capacity)
+        {
+            capacity *= 2;
+            Segment *grown = (Segment *)realloc(segments, sizeof(Segment) * capacity);
+            if (grown == NULL)
+            {
+                free(segments);
+                segments = NULL;
+                break;
+            }
+            segments = grown;
+        }
+
+        segments[count].cpu = (int32_t)cpu;
+        segments[count].pid = (int32_t)pid;
+        segments[count].start = start;
+        segments[count].end = end;
+        segments[count].next_same_pid = -1;
+        count++;
+    }
+
+    fclose(file);
+    if (segments == NULL)
+    {
+        printf("Not enough memory for %lld segments\n", (long long)capacity);
+        return -1;
+    }
+
+    *out = segments;
+    return count;
+}
+
+// Build an index file from a Gantt CSV
+int buildIndex(const char *segments_file, const char *index_file)
+{
+    Segment *segments;
+    int64_t n = readSegments(segments_file, &segments);
+    if (n < 0)
+        return 1;
+
+    qsort(segments, n, sizeof(Segment), compareByCpuAndStart);
+
+    // A cpu runs one segment at a time. Overlaps would leave the end times
+    // of a cpu unsorted, which the window queries rely on.
+    for (int64_t i = 1; i < n; i++)
+    {
+        if (segments[i].cpu == segments[i - 1].cpu && segments[i].start < segments[i - 1].end)
+        {
+            printf("Invalid Gantt chart: segments overlap on CPU %d at time %lld\n", segments[i].cpu,
+                   (long long)segments[i].start);
+            free(segments);
+            return 1;
+        }
+    }
+
+    // Count cpus and blocks
+    int64_t cpu_count = 0;
+    int64_t block_count = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+        if (i == 0 || segments[i].cpu != segments[i - 1].cpu)
+            cpu_count++;
+    }
+
+    CpuEntry *cpus = (CpuEntry *)calloc(cpu_count > 0 ? cpu_count : 1, sizeof(CpuEntry));
+    int64_t *busy_before = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    if (cpus == NULL || busy_before == NULL)
+    {
+        printf("Not enough memory for an index of %lld segments\n", (long long)n);
+        free(busy_before);
+        free(cpus);
+        free(segments);
+        return 1;
+    }
+
+    int64_t c = -1;
+    int64_t busy = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+        if (i == 0 || segments[i].cpu != segments[i - 1].cpu)
+        {
+            c++;
+            cpus[c].cpu = segments[i].cpu;
+            cpus[c].first_segment = i;
+            busy = 0;
+        }
+        busy_before[i] = busy;
+        busy += segments[i].end - segments[i].start;
+        cpus[c].segment_count++;
+        cpus[c].total_busy = busy;
+    }
+
+    for (c = 0; c < cpu_count; c++)
+    {
+        cpus[c].first_block = block_count;
+        cpus[c].block_count = (cpus[c].segment_count + INDEX_BLOCK_SIZE - 1) / INDEX_BLOCK_SIZE;
+        block_count += cpus[c].block_count;
+    }
+
+    int64_t *block_end = (int64_t *)malloc(sizeof(int64_t) * (block_count > 0 ? block_count : 1));
+    if (block_end == NULL)
+    {
+        printf("Not enough memory for an index of %lld segments\n", (long long)n);
+        free(busy_before);
+        free(cpus);
+        free(segments);
+        return 1;
+    }
+    for (c = 0; c < cpu_count; c++)
+    {
+        for (int64_t b = 0; b < cpus[c].block_count; b++)
+        {
+            int64_t last = (b + 1) * INDEX_BLOCK_SIZE - 1;
+            if (last >= cpus[c].segment_count)
+                last = cpus[c].segment_count - 1;
+            block_end[cpus[c].first_block + b] = segments[cpus[c].first_segment + last].end;
+        }
+    }
+
+    PidTable table;
+    memset(&table, 0, sizeof(table));
+    PidEntry *pids = NULL;
+    if (linkPidChains(segments, cpus, cpu_count, &table) == 0)
+        pids = (PidEntry *)malloc(sizeof(PidEntry) * (table.count > 0 ? table.count : 1));
+    if (pids == NULL)
+    {
+        printf("Not enough memory for an index of %lld segments\n", (long long)n);
+        free(table.slots);
+        free(block_end);
+        free(busy_before);
+        free(cpus);
+        free(segments);
+        return 1;
+    }
+
+    int64_t pid_count = 0;
+    for (int64_t i = 0; i < table.size; i++)
+    {
+        if (table.slots[i].used)
+            pids[pid_count++] = table.slots[i].entry;
+    }
+    free(table.slots);
+    qsort(pids, pid_count, sizeof(PidEntry), compareByPid);
+
+    IndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.block_size = INDEX_BLOCK_SIZE;
+    header.segment_count = n;
+    header.cpu_count = cpu_count;
+    header.pid_count = pid_count;
+    header.block_count = block_count;
+    header.min_time = 0;
+    header.max_time = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+        if (i == 0 || segments[i].start < header.min_time)
+            header.min_time = segments[i].start;
+        if (i == 0 || segments[i].end > header.max_time)
+            header.max_time = segments[i].end;
+    }
+    header.cpu_offset = sizeof(IndexHeader);
+    header.segment_offset = header.cpu_offset + sizeof(CpuEntry) * cpu_count;
+    header.prefix_offset = header.segment_offset + sizeof(Segment) * n;
+    header.block_offset = header.prefix_offset + sizeof(int64_t) * n;
+    header.pid_offset = header.block_offset + sizeof(int64_t) * block_count;
+
+    FILE *file = fopen(index_file, "wb");
+    int status = 0;
+    if (file == NULL)
+    {
+        printf("Error creating index file: %s\n", index_file);
+        status = 1;
+    }
+    else
+    {
+        if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+            fwrite(cpus, sizeof(CpuEntry), cpu_count, file) != (size_t)cpu_count ||
+            fwrite(segments, sizeof(Segment), n, file) != (size_t)n ||
+            fwrite(busy_before, sizeof(int64_t), n, file) != (size_t)n ||
+            fwrite(block_end, sizeof(int64_t), block_count, file) != (size_t)block_count ||
+            fwrite(pids, sizeof(PidEntry), pid_count, file) != (size_t)pid_count)
+        {
+            printf("Error writing index file: %s\n", index_file);
+            status = 1;
+        }
+        fclose(file);
+    }
+
+    if (status == 0)
+        printf("Indexed %lld segments on %lld CPUs for %lld processes\n",
+               (long long)n, (long long)cpu_count, (long long)pid_count);
+
+    free(pids);
+    free(block_end);
+    free(busy_before);
+    free(cpus);
+    free(segments);
+    return status;
+}
+
+// Print every segment overlapping [t1, t2)
+void queryWindow(GanttIndex *index, int64_t t1, int64_t t2)
+{
+    printf("CPU,ProcessID,StartTime,EndTime\n");
+    for (int64_t c = 0; c < index->header->cpu_count; c++)
+    {
+        CpuEntry *cpu = &index->cpus[c];
+        int64_t end = cpu->first_segment + cpu->segment_count;
+        for (int64_t i = firstSegmentEndingAfter(index, cpu, t1); i < end && index->segments[i].start < t2; i++)
+        {
+            Segment *segment = &index->segments[i];
+            printf("%d,%d,%lld,%lld\n", segment->cpu, segment->pid, (long long)segment->start, (long long)segment->end);
+        }
+    }
+}
+
+// Print the utilization of one cpu inside [t1, t2)
+void queryUtilization(GanttIndex *index, int64_t cpu_id, int64_t t1, int64_t t2)
+{
+    CpuEntry *cpu = findCpu(index, cpu_id);
+    int64_t busy = cpu != NULL && t2 > t1 ? busyTime(index, cpu, t1, t2) : 0;
+
+    printf("CPU,WindowStart,WindowEnd,BusyTime,Utilization\n");
+    printf("%lld,%lld,%lld,%lld,%.4f\n", (long long)cpu_id, (long long)t1, (long long)t2, (long long)busy,
+           t2 > t1 ? (double)busy / (t2 - t1) : 0.0);
+}
+
+// Print every slice of one pid by following its chain
+void queryPid(GanttIndex *index, int64_t pid)
+{
+    printf("CPU,ProcessID,StartTime,EndTime\n");
+    PidEntry *entry = findPid(index, pid);
+    if (entry == NULL)
+        return;
+
+    for (int64_t i = entry->first_segment; i >= 0; i = index->segments[i].next_same_pid)
+    {
+        Segment *segment = &index->segments[i];
+        printf("%d,%d,%lld,%lld\n", segment->cpu, segment->pid, (long long)segment->start, (long long)segment->end);
+    }
+}
+
+// Print a summary of the index
+void displayInfo(GanttIndex *index)
+{
+    printf("Metric,Value\n");
+    printf("Segments,%lld\n", (long long)index->header->segment_count);
+    printf("CPUs,%lld\n", (long long)index->header->cpu_count);
+    printf("Processes,%lld\n", (long long)index->header->pid_count);
+    printf("Blocks,%lld\n", (long long)index->header->block_count);
+    printf("Start Time,%lld\n", (long long)index->header->min_time);
+    printf("End Time,%lld\n", (long long)index->header->max_time);
+    for (int64_t c = 0; c < index->header->cpu_count; c++)
+    {
+        printf("CPU %lld Busy Time,%lld\n", (long long)index->cpus[c].cpu, (long long)index->cpus[c].total_busy);
+    }
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s build <gantt.csv> <index>\n", program);
+    printf("       %s info <index>\n", program);
+    printf("       %s window <index> <t1> <t2>\n", program);
+    printf("       %s utilization <index> <cpu> <t1> <t2>\n", program);
+    printf("       %s pid <index> <pid>\n", program);
+}
+
+// Build or query a Gantt interval index
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "build") == 0)
+    {
+        if (argc != 4)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        return buildIndex(argv[2], argv[3]);
+    }
+
+    GanttIndex index;
+    if (openIndex(argv[2], &index) != 0)
+        return 1;
+
+    int status = 0;
+    if (strcmp(argv[1], "info") == 0 && argc == 3)
+        displayInfo(&index);
+    else if (strcmp(argv[1], "window") == 0 && argc == 5)
+        queryWindow(&index, atoll(argv[3]), atoll(argv[4]));
+    else if (strcmp(argv[1], "utilization") == 0 && argc == 6)
+        queryUtilization(&index, atoll(argv[3]), atoll(argv[4]), atoll(argv[5]));
+    else if (strcmp(argv[1], "pid") == 0 && argc == 4)
+        queryPid(&index, atoll(argv[3]));
+    else
+    {
+        printUsage(argv[0]);
+        status = 1;
+    }
+
+    closeIndex(&index);
+    return status;
+}
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "gantt-index.h"
+
+// Map an index file read-only
+int openIndex(const char *filename, GanttIndex *index)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Error opening index: %s\n", filename);
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(IndexHeader))
+    {
+        printf("Invalid index file: %s\n", filename);
+        close(fd);
+        return 1;
+    }
+
+    index->size = st.st_size;
+    index->base = mmap(NULL, index->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (index->base == MAP_FAILED)
+    {
+        printf("Error mapping index: %s\n", filename);
+        return 1;
+    }
+
+    char *base = (char *)index->base;
+    index->header = (IndexHeader *)base;
+    if (memcmp(index->header->magic, INDEX_MAGIC, sizeof(index->header->magic)) != 0 ||
+        index->header->version != INDEX_VERSION ||
+        (size_t)index->header->pid_offset + sizeof(PidEntry) * index->header->pid_count > index->size)
+    {
+        printf("Invalid index file: %s\n", filename);
+        munmap(index->base, index->size);
+        return 1;
+    }
+
+    index->cpus = (CpuEntry *)(base + index->header->cpu_offset);
+    index->segments = (Segment *)(base + index->header->segment_offset);
+    index->busy_before = (int64_t *)(base + index->header->prefix_offset);
+    index->block_end = (int64_t *)(base + index->header->block_offset);
+    index->pids = (PidEntry *)(base + index->header->pid_offset);
+    return 0;
+}
+
+
+// Unmap an index
+void closeIndex(GanttIndex *index)
+{
+    munmap(index->base, index->size);
+}
+
+
+// Binary search the cpu table
+CpuEntry *findCpu(GanttIndex *index, int64_t cpu)
+{
+    int64_t low = 0;
+    int64_t high = index->header->cpu_count;
+    while (low < high)
+    {
+        int64_t mid = low + (high - low) / 2;
+        if (index->cpus[mid].cpu < cpu)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low < index->header->cpu_count && index->cpus[low].cpu == cpu)
+        return &index->cpus[low];
+    return NULL;
+}
+
+
+// Binary search the pid table
+PidEntry *findPid(GanttIndex *index, int64_t pid)
+{
+    int64_t low = 0;
+    int64_t high = index->header->pid_count;
+    while (low < high)
+    {
+        int64_t mid = low + (high - low) / 2;
+        if (index->pids[mid].pid < pid)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low < index->header->pid_count && index->pids[low].pid == pid)
+        return &index->pids[low];
+    return NULL;
+}
+
+
+// Global index of the first segment of a cpu that ends after the given time.
+// The block directory narrows the search to one block first.
+int64_t firstSegmentEndingAfter(GanttIndex *index, CpuEntry *cpu, int64_t time)
+{
+    int64_t low = 0;
+    int64_t high = cpu->block_count;
+    while (low < high)
+    {
+        int64_t mid = low + (high - low) / 2;
+        if (index->block_end[cpu->first_block + mid] <= time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == cpu->block_count)
+        return cpu->first_segment + cpu->segment_count;
+
+    int64_t first = cpu->first_segment + low * INDEX_BLOCK_SIZE;
+    int64_t last = cpu->first_segment + cpu->segment_count;
+    if (first + INDEX_BLOCK_SIZE < last)
+        last = first + INDEX_BLOCK_SIZE;
+    while (first < last)
+    {
+        int64_t mid = first + (last - first) / 2;
+        if (index->segments[mid].end <= time)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return first;
+}
+
+
+// Global index of the first segment of a cpu at or after `from` that starts
+// at or after the given time
+int64_t firstSegmentStartingAtOrAfter(GanttIndex *index, CpuEntry *cpu, int64_t from, int64_t time)
+{
+    int64_t low = from;
+    int64_t high = cpu->first_segment + cpu->segment_count;
+    while (low < high)
+    {
+        int64_t mid = low + (high - low) / 2;
+        if (index->segments[mid].start < time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+
+// Busy time of a cpu inside [t1, t2) from the prefix sums, in O(log n)
+int64_t busyTime(GanttIndex *index, CpuEntry *cpu, int64_t t1, int64_t t2)
+{
+    int64_t first = firstSegmentEndingAfter(index, cpu, t1);
+    int64_t last = firstSegmentStartingAtOrAfter(index, cpu, first, t2);
+    if (first >= last)
+        return 0;
+
+    int64_t end = cpu->first_segment + cpu->segment_count;
+    int64_t busy = (last < end ? index->busy_before[last] : cpu->total_busy) - index->busy_before[first];
+
+    // Clip the segments that straddle the window edges
+    if (index->segments[first].start < t1)
+        busy -= t1 - index->segments[first].start;
+    if (index->segments[last - 1].end > t2)
+        busy -= index->segments[last - 1].end - t2;
+    return busy;
+}
+
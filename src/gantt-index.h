@@ -0,0 +1,95 @@
+#ifndef GANTT_INDEX_H
+#define GANTT_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDEX_MAGIC "GANTTIDX"
+#define INDEX_VERSION 1
+#define INDEX_BLOCK_SIZE 256
+
+// On-disk layout written by gantt-index and mapped by the Gantt tools
+// (native endianness, every section 8-byte aligned):
+//   IndexHeader
+//   CpuEntry[cpu_count]          sorted by cpu
+//   Segment[segment_count]       grouped by cpu, time-sorted within a cpu
+//   int64_t busy_before[segment_count]
+//                                busy time of the cpu before each segment
+//   int64_t block_end[block_count]
+//                                end time of the last segment of each block
+//   PidEntry[pid_count]          sorted by pid
+// Segments of one cpu never overlap, so within a cpu both start and end
+// times are sorted and a window is found with two binary searches.
+
+// File header
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t block_size;
+    int64_t segment_count;
+    int64_t cpu_count;
+    int64_t pid_count;
+    int64_t block_count;
+    int64_t min_time;
+    int64_t max_time;
+    int64_t cpu_offset;
+    int64_t segment_offset;
+    int64_t prefix_offset;
+    int64_t block_offset;
+    int64_t pid_offset;
+} IndexHeader;
+
+// One busy interval of a process on a cpu
+typedef struct
+{
+    int64_t start;
+    int64_t end;
+    int64_t next_same_pid; // Next segment of the same pid in time order (-1 = last)
+    int32_t cpu;
+    int32_t pid;
+} Segment;
+
+// Segment range and block directory of one cpu
+typedef struct
+{
+    int64_t cpu;
+    int64_t first_segment;
+    int64_t segment_count;
+    int64_t first_block;
+    int64_t block_count;
+    int64_t total_busy;
+} CpuEntry;
+
+// Head of the segment chain of one pid
+typedef struct
+{
+    int64_t pid;
+    int64_t first_segment;
+    int64_t segment_count;
+    int64_t total_time;
+} PidEntry;
+
+// A mapped index
+typedef struct
+{
+    void *base;
+    size_t size;
+    IndexHeader *header;
+    CpuEntry *cpus;
+    Segment *segments;
+    int64_t *busy_before;
+    int64_t *block_end;
+    PidEntry *pids;
+} GanttIndex;
+
+// Function prototypes
+int openIndex(const char *filename, GanttIndex *index);
+void closeIndex(GanttIndex *index);
+CpuEntry *findCpu(GanttIndex *index, int64_t cpu);
+PidEntry *findPid(GanttIndex *index, int64_t pid);
+int64_t firstSegmentEndingAfter(GanttIndex *index, CpuEntry *cpu, int64_t time);
+int64_t firstSegmentStartingAtOrAfter(GanttIndex *index, CpuEntry *cpu, int64_t from, int64_t time);
+int64_t busyTime(GanttIndex *index, CpuEntry *cpu, int64_t t1, int64_t t2);
+
+#endif
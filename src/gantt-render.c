@@ -0,0 +1,524 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "gantt-index.h"
+
+#define DEFAULT_WIDTH 1600
+#define MAX_WIDTH 20000
+#define DOMINANT_COUNTERS 4 // Misra-Gries counters kept per pixel
+#define OPACITY_LEVELS 10
+#define ROW_HEIGHT 24
+#define ROW_GAP 4
+#define LEFT_MARGIN 70
+#define TOP_MARGIN 30
+#define AXIS_HEIGHT 30
+#define AXIS_TICKS 10
+#define READ_BUFFER_SIZE (1 << 20)
+
+// Aggregated contents of one pixel column of one cpu row. The dominant
+// process is tracked with a weighted Misra-Gries summary, which is exact
+// for up to DOMINANT_COUNTERS processes and otherwise still finds any
+// process holding more than 1/(DOMINANT_COUNTERS + 1) of the pixel.
+typedef struct
+{
+    double busy;
+    int32_t pid[DOMINANT_COUNTERS];
+    double weight[DOMINANT_COUNTERS];
+} PixelBucket;
+
+// Render target: a grid of pixel buckets for the time range [from, to)
+typedef struct
+{
+    int width;
+    int64_t from;
+    int64_t to;
+    double bucket_time;
+    int rows;
+    int row_capacity;
+    int64_t *cpu_ids;
+    PixelBucket *buckets; // rows x width, row-major
+    bool out_of_memory;   // A cpu row could not be added
+} Canvas;
+
+// Function prototypes
+bool reserveRows(Canvas *canvas, int rows);
+int canvasRow(Canvas *canvas, int64_t cpu);
+void addToBucket(PixelBucket *bucket, int32_t pid, double weight);
+void addSegment(Canvas *canvas, int64_t cpu, int32_t pid, int64_t start, int64_t end);
+bool parseSegmentLine(char *line, int64_t *fields);
+void handleSegmentLine(Canvas *canvas, char *line, bool find_range, bool *first_segment);
+int scanCsv(const char *filename, Canvas *canvas, bool find_range);
+int renderFromIndex(GanttIndex *index, Canvas *canvas);
+int32_t dominantPid(PixelBucket *bucket);
+void pidColor(int32_t pid, char *buffer, size_t size);
+void writeSvg(FILE *file, Canvas *canvas);
+int writeOutput(const char *filename, Canvas *canvas, bool html);
+
+// Make room for at least the given number of cpu rows; new rows are idle
+bool reserveRows(Canvas *canvas, int rows)
+{
+    if (rows <= canvas->row_capacity)
+        return true;
+
+    int64_t *cpu_ids = (int64_t *)realloc(canvas->cpu_ids, sizeof(int64_t) * rows);
+    if (cpu_ids == NULL)
+        return false;
+    canvas->cpu_ids = cpu_ids;
+
+    PixelBucket *buckets = (PixelBucket *)realloc(canvas->buckets, sizeof(PixelBucket) * (size_t)rows * canvas->width);
+    if (buckets == NULL)
+        return false;
+    memset(&buckets[(size_t)canvas->row_capacity * canvas->width], 0,
+           sizeof(PixelBucket) * (size_t)(rows - canvas->row_capacity) * canvas->width);
+    canvas->buckets = buckets;
+    canvas->row_capacity = rows;
+    return true;
+}
+
+// Row of a cpu on the canvas, adding it on first use (-1 when out of memory)
+int canvasRow(Canvas *canvas, int64_t cpu)
+{
+    for (int r = 0; r < canvas->rows; r++)
+    {
+        if (canvas->cpu_ids[r] == cpu)
+            return r;
+    }
+    if (canvas->rows == canvas->row_capacity && !reserveRows(canvas, canvas->rows > 0 ? 2 * canvas->rows : 1))
+    {
+        canvas->out_of_memory = true;
+        return -1;
+    }
+    canvas->cpu_ids[canvas->rows] = cpu;
+    return canvas->rows++;
+}
+
+// Weighted Misra-Gries update of a pixel's dominant-process summary
+void addToBucket(PixelBucket *bucket, int32_t pid, double weight)
+{
+    bucket->busy += weight;
+
+    int free_slot = -1;
+    for (int k = 0; k < DOMINANT_COUNTERS; k++)
+    {
+        if (bucket->weight[k] > 0 && bucket->pid[k] == pid)
+        {
+            bucket->weight[k] += weight;
+            return;
+        }
+        if (bucket->weight[k] <= 0 && free_slot < 0)
+            free_slot = k;
+    }
+
+    if (free_slot < 0)
+    {
+        double smallest = weight;
+        for (int k = 0; k < DOMINANT_COUNTERS; k++)
+        {
+            if (bucket->weight[k] < smallest)
+                smallest = bucket->weight[k];
+        }
+        for (int k = 0; k < DOMINANT_COUNTERS; k++)
+        {
+            bucket->weight[k] -= smallest;
+            if (bucket->weight[k] <= 0 && free_slot < 0)
+                free_slot = k;
+        }
+        weight -= smallest;
+    }
+
+    if (weight > 0 && free_slot >= 0)
+    {
+        bucket->pid[free_slot] = pid;
+        bucket->weight[free_slot] = weight;
+    }
+}
+
+// Spread a segment over the pixel buckets it covers
+void addSegment(Canvas *canvas, int64_t cpu, int32_t pid, int64_t start, int64_t end)
+{
+    if (pid < 0 || end <= canvas->from || start >= canvas->to)
+        return;
+
+    int row = canvasRow(canvas, cpu);
+    if (row < 0)
+        return;
+
+    if (start < canvas->from)
+        start = canvas->from;
+    if (end > canvas->to)
+        end = canvas->to;
+
+    int first = (int)((start - canvas->from) / canvas->bucket_time);
+    int last = (int)((end - canvas->from) / canvas->bucket_time);
+    if (last >= canvas->width)
+        last = canvas->width - 1;
+
+    PixelBucket *buckets = &canvas->buckets[(size_t)row * canvas->width];
+    for (int b = first; b <= last; b++)
+    {
+        double bucket_start = canvas->from + b * canvas->bucket_time;
+        double bucket_end = bucket_start + canvas->bucket_time;
+        double overlap = fmin((double)end, bucket_end) - fmax((double)start, bucket_start);
+        if (overlap > 0)
+            addToBucket(&buckets[b], pid, overlap);
+    }
+}
+
+// Parse "cpu,pid,start,end" without sscanf (the hot loop for large CSVs)
+bool parseSegmentLine(char *line, int64_t *fields)
+{
+    char *p = line;
+    for (int f = 0; f < 4; f++)
+    {
+        bool negative = false;
+        if (*p == '-')
+        {
+            negative = true;
+            p++;
+        }
+        if (*p < '0' || *p > '9')
+            return false;
+
+        int64_t value = 0;
+        while (*p >= '0' && *p <= '9')
+        {
+            value = value * 10 + (*p - '0');
+            p++;
+        }
+        fields[f] = negative ? -value : value;
+
+        if (f < 3)
+        {
+            if (*p != ',')
+                return false;
+            p++;
+        }
+    }
+    return true;
+}
+
+// Handle one CSV line: record the time range, or draw the segment
+void handleSegmentLine(Canvas *canvas, char *line, bool find_range, bool *first_segment)
+{
+    int64_t fields[4];
+    if (!parseSegmentLine(line, fields) || fields[1] < 0 || fields[3] <= fields[2])
+        return; // Header, idle or empty segment
+
+    if (!find_range)
+    {
+        addSegment(canvas, fields[0], (int32_t)fields[1], fields[2], fields[3]);
+    }
+    else if (*first_segment)
+    {
+        canvas->from = fields[2];
+        canvas->to = fields[3];
+        *first_segment = false;
+    }
+    else
+    {
+        if (fields[2] < canvas->from)
+            canvas->from = fields[2];
+        if (fields[3] > canvas->to)
+            canvas->to = fields[3];
+    }
+}
+
+// Stream a Gantt CSV (CPU,ProcessID,StartTime,EndTime). With find_range the
+// pass only records the time range; otherwise segments go onto the canvas.
+int scanCsv(const char *filename, Canvas *canvas, bool find_range)
+{
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", filename);
+        return 1;
+    }
+
+    char *buffer = (char *)malloc(READ_BUFFER_SIZE + 1);
+    size_t carry = 0;
+    bool first_segment = true;
+    int status = 0;
+
+    for (;;)
+    {
+        size_t got = fread(buffer + carry, 1, READ_BUFFER_SIZE - carry, file);
+        if (got == 0)
+        {
+            // Last line without a trailing newline
+            buffer[carry] = '\0';
+            handleSegmentLine(canvas, buffer, find_range, &first_segment);
+            break;
+        }
+
+        size_t length = carry + got;
+        size_t line_start = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            if (buffer[i] == '\n')
+            {
+                buffer[i] = '\0';
+                handleSegmentLine(canvas, buffer + line_start, find_range, &first_segment);
+                line_start = i + 1;
+            }
+        }
+
+        // Keep a partial last line for the next read
+        carry = length - line_start;
+        if (carry == READ_BUFFER_SIZE)
+        {
+            printf("Line too long in %s\n", filename);
+            status = 1;
+            break;
+        }
+        memmove(buffer, buffer + line_start, carry);
+    }
+
+    free(buffer);
+    fclose(file);
+    return status;
+}
+
+// Add every indexed segment overlapping the canvas range; each cpu starts
+// from a binary search, so zoomed renders touch only the visible segments
+int renderFromIndex(GanttIndex *index, Canvas *canvas)
+{
+    if (!reserveRows(canvas, (int)index->header->cpu_count))
+    {
+        canvas->out_of_memory = true;
+        return 1;
+    }
+
+    for (int64_t c = 0; c < index->header->cpu_count; c++)
+    {
+        CpuEntry *cpu = &index->cpus[c];
+        int64_t end = cpu->first_segment + cpu->segment_count;
+        canvasRow(canvas, cpu->cpu);
+        for (int64_t i = firstSegmentEndingAfter(index, cpu, canvas->from);
+             i < end && index->segments[i].start < canvas->to; i++)
+        {
+            Segment *segment = &index->segments[i];
+            addSegment(canvas, segment->cpu, segment->pid, segment->start, segment->end);
+        }
+    }
+    return 0;
+}
+
+// Process holding the most time in a pixel (-1 when idle)
+int32_t dominantPid(PixelBucket *bucket)
+{
+    int32_t pid = -1;
+    double best = 0.0;
+    for (int k = 0; k < DOMINANT_COUNTERS; k++)
+    {
+        if (bucket->weight[k] > best)
+        {
+            best = bucket->weight[k];
+            pid = bucket->pid[k];
+        }
+    }
+    return pid;
+}
+
+// Stable colour per pid, spreading hues by the golden angle
+void pidColor(int32_t pid, char *buffer, size_t size)
+{
+    double hue = fmod(pid * 137.508, 360.0);
+    snprintf(buffer, size, "hsl(%.0f,65%%,50%%)", hue);
+}
+
+// Write the canvas as SVG. Neighbouring pixels with the same dominant process
+// and shading are merged into one rectangle to keep the output small.
+void writeSvg(FILE *file, Canvas *canvas)
+{
+    int height = TOP_MARGIN + canvas->rows * (ROW_HEIGHT + ROW_GAP) + AXIS_HEIGHT;
+    int total_width = LEFT_MARGIN + canvas->width + 20;
+
+    fprintf(file, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" font-family=\"monospace\" font-size=\"11\">\n",
+            total_width, height);
+    fprintf(file, "<text x=\"%d\" y=\"18\">Gantt chart %lld-%lld (%.2f time units per pixel)</text>\n",
+            LEFT_MARGIN, (long long)canvas->from, (long long)canvas->to, canvas->bucket_time);
+
+    for (int r = 0; r < canvas->rows; r++)
+    {
+        int y = TOP_MARGIN + r * (ROW_HEIGHT + ROW_GAP);
+        PixelBucket *buckets = &canvas->buckets[(size_t)r * canvas->width];
+
+        fprintf(file, "<text x=\"4\" y=\"%d\">CPU %lld</text>\n", y + ROW_HEIGHT / 2 + 4, (long long)canvas->cpu_ids[r]);
+        fprintf(file, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#eee\"/>\n",
+                LEFT_MARGIN, y, canvas->width, ROW_HEIGHT);
+
+        int b = 0;
+        while (b < canvas->width)
+        {
+            int32_t pid = dominantPid(&buckets[b]);
+            int level = (int)ceil(OPACITY_LEVELS * buckets[b].busy / canvas->bucket_time);
+            if (level > OPACITY_LEVELS)
+                level = OPACITY_LEVELS;
+
+            int run = 1;
+            while (b + run < canvas->width && dominantPid(&buckets[b + run]) == pid &&
+                   (int)fmin(OPACITY_LEVELS, ceil(OPACITY_LEVELS * buckets[b + run].busy / canvas->bucket_time)) == level)
+            {
+                run++;
+            }
+
+            if (pid >= 0 && level > 0)
+            {
+                char color[32];
+                pidColor(pid, color, sizeof(color));
+                fprintf(file, "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"%s\" fill-opacity=\"%.1f\"><title>P%d</title></rect>\n",
+                        LEFT_MARGIN + b, y, run, ROW_HEIGHT, color, (double)level / OPACITY_LEVELS, pid);
+            }
+            b += run;
+        }
+    }
+
+    int axis_y = TOP_MARGIN + canvas->rows * (ROW_HEIGHT + ROW_GAP);
+    fprintf(file, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"#000\"/>\n",
+            LEFT_MARGIN, axis_y, LEFT_MARGIN + canvas->width, axis_y);
+    for (int t = 0; t <= AXIS_TICKS; t++)
+    {
+        int x = LEFT_MARGIN + t * canvas->width / AXIS_TICKS;
+        long long time = canvas->from + (long long)((canvas->to - canvas->from) * (double)t / AXIS_TICKS);
+        fprintf(file, "<line x1=\"%d\" y1=\"%d\" x2=\"%d\" y2=\"%d\" stroke=\"#000\"/>\n", x, axis_y, x, axis_y + 5);
+        fprintf(file, "<text x=\"%d\" y=\"%d\" text-anchor=\"middle\">%lld</text>\n", x, axis_y + 18, time);
+    }
+    fprintf(file, "</svg>\n");
+}
+
+// Write the canvas as a standalone SVG, or wrapped in a minimal HTML page
+int writeOutput(const char *filename, Canvas *canvas, bool html)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("Error creating output file: %s\n", filename);
+        return 1;
+    }
+
+    if (html)
+        fprintf(file, "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>Gantt chart</title></head><body>\n");
+    writeSvg(file, canvas);
+    if (html)
+        fprintf(file, "</body></html>\n");
+
+    fclose(file);
+    return 0;
+}
+
+// Render a Gantt chart of any size at a fixed pixel width
+int main(int argc, char *argv[])
+{
+    const char *positional[2] = {NULL, NULL};
+    int positional_count = 0;
+    const char *input = NULL;
+    const char *output = NULL;
+    const char *index_file = NULL;
+    bool html = false;
+    bool has_from = false;
+    bool has_to = false;
+    Canvas canvas;
+
+    memset(&canvas, 0, sizeof(canvas));
+    canvas.width = DEFAULT_WIDTH;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+            canvas.width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc)
+        {
+            canvas.from = atoll(argv[++i]);
+            has_from = true;
+        }
+        else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc)
+        {
+            canvas.to = atoll(argv[++i]);
+            has_to = true;
+        }
+        else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc)
+            index_file = argv[++i];
+        else if (strcmp(argv[i], "--html") == 0)
+            html = true;
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        else if (positional_count < 2)
+            positional[positional_count++] = argv[i];
+        else
+        {
+            printf("Unexpected argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // The index replaces the CSV input, leaving only the output file
+    if (index_file != NULL)
+        output = positional[0];
+    else
+    {
+        input = positional[0];
+        output = positional[1];
+    }
+
+    if (output == NULL || (input == NULL && index_file == NULL) || canvas.width < 1 || canvas.width > MAX_WIDTH)
+    {
+        printf("Usage: %s <gantt.csv> <output.svg> [--width W] [--from T1] [--to T2] [--html]\n", argv[0]);
+        printf("       %s --index <index> <output.svg> [--width W] [--from T1] [--to T2] [--html]\n", argv[0]);
+        return 1;
+    }
+
+    GanttIndex index;
+    if (index_file != NULL && openIndex(index_file, &index) != 0)
+        return 1;
+
+    // Default to the full schedule
+    Canvas range = canvas;
+    if (!has_from || !has_to)
+    {
+        if (index_file != NULL)
+        {
+            range.from = index.header->min_time;
+            range.to = index.header->max_time;
+        }
+        else if (scanCsv(input, &range, true) != 0)
+            return 1;
+    }
+    if (!has_from)
+        canvas.from = range.from;
+    if (!has_to)
+        canvas.to = range.to;
+    if (canvas.to <= canvas.from)
+        canvas.to = canvas.from + 1;
+
+    // Rows are added as cpus appear, so the canvas is sized by the cpu count
+    canvas.bucket_time = (double)(canvas.to - canvas.from) / canvas.width;
+
+    int status;
+    if (index_file != NULL)
+    {
+        status = renderFromIndex(&index, &canvas);
+        closeIndex(&index);
+    }
+    else
+        status = scanCsv(input, &canvas, false);
+
+    if (canvas.out_of_memory)
+    {
+        printf("Not enough memory for a %d pixel canvas\n", canvas.width);
+        status = 1;
+    }
+
+    if (status == 0)
+        status = writeOutput(output, &canvas, html);
+
+    free(canvas.buckets);
+    free(canvas.cpu_ids);
+    return status;
+}
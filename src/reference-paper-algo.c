@@ -1,25 +1,37 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 
+#include "sim-common.h"
+
+#define SMALL_QUEUE_CAPACITY 32
+#define SMALL_QUEUE_NETWORK_SIZE 4096 // Comparators of the networks for all lengths up to SMALL_QUEUE_CAPACITY
+#define DEFAULT_SMALL_QUEUE 16 // Queues up to this length are ordered by the sorting network
+#define METRICS_SCHEDULER "reference"
+
 // Define the process structure
-typedef struct
+struct Process
 {
     int pid;
-    int arrival_time;
-    int burst_time;
-    int deadline;
+    int64_t arrival_time; // All times are in nanoseconds
+    int64_t burst_time;      // Actual execution time
+    int64_t estimated_burst; // Execution time given by the trace
+    int64_t predicted_burst; // Execution time the policy sees
+    int64_t deadline;
     int criticality;
-    int period;
+    int64_t period;
     int nice;
-    int remaining_time;
+    int64_t remaining_time;
     int completed;
-    int start_time;      // When process starts execution for the first time
-    int completion_time; // When process completes execution
+    int64_t start_time;      // When process starts execution for the first time
+    int64_t completion_time; // When process completes execution
     int in_ready_queue;  // Flag to track if process is in ready queue
-} Process;
+    int rejected;        // Shed by admission control
+    SchedStat stat;
+};
 
 // Define the ready queue
 typedef struct
@@ -29,6 +41,21 @@ typedef struct
     int capacity;
 } ReadyQueue;
 
+// Aggregate metrics reported by the simulator
+typedef struct
+{
+    double avg_turnaround_time;
+    double avg_waiting_time;
+    double avg_response_time;
+    double throughput;
+    float fairness_index;
+    int starvation_count;
+    float load_balancing_efficiency;
+} Metrics;
+
+// Global variables
+int small_queue_max = DEFAULT_SMALL_QUEUE;
+
 // Function to create a new ready queue
 ReadyQueue *createReadyQueue(int capacity)
 {
@@ -68,19 +95,112 @@ Process removeFromReadyQueue(ReadyQueue *queue, int index)
     return process;
 }
 
+// Remaining time of a process as the policy sees it. A process that has run
+// past its predicted burst has its prediction doubled until it is ahead again.
+int64_t visibleRemaining(Process *process)
+{
+    if (burst_predictor == NULL)
+        return process->remaining_time;
+
+    int64_t executed = process->burst_time - process->remaining_time;
+    while (process->predicted_burst <= executed)
+        process->predicted_burst *= 2;
+    return process->predicted_burst - executed;
+}
+
 // Comparison function for sorting processes by remaining time (SRPT)
 int compareRemainingTime(const void *a, const void *b)
 {
     Process *p1 = (Process *)a;
     Process *p2 = (Process *)b;
-    return p1->remaining_time - p2->remaining_time;
+    int64_t r1 = visibleRemaining(p1);
+    int64_t r2 = visibleRemaining(p2);
+    if (r1 != r2)
+        return r1 < r2 ? -1 : 1;
+    return 0;
+}
+
+// Build the comparators of Batcher's odd-even merge sort network for every
+// queue length up to SMALL_QUEUE_CAPACITY, skipping the wires past the length
+int buildSortingNetworks(int pairs[][2], int *first)
+{
+    int total = 0;
+    for (int count = 0; count <= SMALL_QUEUE_CAPACITY; count++)
+    {
+        first[count] = total;
+        for (int p = 1; p < count; p += p)
+        {
+            for (int k = p; k >= 1; k /= 2)
+            {
+                for (int j = k % p; j + k < count; j += 2 * k)
+                {
+                    for (int i = 0; i < k && i + j + k < count; i++)
+                    {
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                        {
+                            pairs[total][0] = i + j;
+                            pairs[total][1] = i + j + k;
+                            total++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    first[SMALL_QUEUE_CAPACITY + 1] = total;
+    return total;
+}
+
+// Sort count distinct keys with the network for that length; each step is a
+// branch-free min/max
+void sortingNetwork(int64_t *keys, int count)
+{
+    static int pairs[SMALL_QUEUE_NETWORK_SIZE][2];
+    static int first[SMALL_QUEUE_CAPACITY + 2];
+    static int built = 0;
+    if (!built)
+    {
+        buildSortingNetworks(pairs, first);
+        built = 1;
+    }
+
+    for (int c = first[count]; c < first[count + 1]; c++)
+    {
+        int64_t a = keys[pairs[c][0]];
+        int64_t b = keys[pairs[c][1]];
+        keys[pairs[c][0]] = a < b ? a : b;
+        keys[pairs[c][1]] = a < b ? b : a;
+    }
+}
+
+// Sort the ready queue by remaining time (SRPT). Short queues go through the
+// sorting network, with each key carrying its queue slot in the low digits so
+// equal remaining times keep their order; long queues through qsort.
+void sortReadyQueue(ReadyQueue *queue)
+{
+    if (queue->size > small_queue_max)
+    {
+        qsort(queue->processes, queue->size, sizeof(Process), compareRemainingTime);
+        return;
+    }
+
+    int64_t keys[SMALL_QUEUE_CAPACITY];
+    Process sorted[SMALL_QUEUE_CAPACITY];
+    for (int i = 0; i < queue->size; i++)
+        keys[i] = visibleRemaining(&queue->processes[i]) * SMALL_QUEUE_CAPACITY + i;
+
+    sortingNetwork(keys, queue->size);
+
+    for (int i = 0; i < queue->size; i++)
+        sorted[i] = queue->processes[keys[i] % SMALL_QUEUE_CAPACITY];
+    memcpy(queue->processes, sorted, sizeof(Process) * queue->size);
 }
 
 // Function to calculate median of an array
-float median(int arr[], int n)
+double median(int64_t arr[], int n)
 {
     // Create a copy of the array to avoid modifying the original
-    int *temp = (int *)malloc(sizeof(int) * n);
+    int64_t *temp = (int64_t *)malloc(sizeof(int64_t) * n);
     for (int i = 0; i < n; i++)
     {
         temp[i] = arr[i];
@@ -93,14 +213,14 @@ float median(int arr[], int n)
         {
             if (temp[i] > temp[j])
             {
-                int t = temp[i];
+                int64_t t = temp[i];
                 temp[i] = temp[j];
                 temp[j] = t;
             }
         }
     }
 
-    float med;
+    double med;
     if (n % 2 == 0)
     {
         med = (temp[n / 2] + temp[n / 2 - 1]) / 2.0;
@@ -115,14 +235,14 @@ float median(int arr[], int n)
 }
 
 // Function to calculate mean of an array
-float mean(int arr[], int n)
+double mean(int64_t arr[], int n)
 {
-    int sum = 0;
+    int64_t sum = 0;
     for (int i = 0; i < n; i++)
     {
         sum += arr[i];
     }
-    return (float)sum / n;
+    return (double)sum / n;
 }
 
 // Function to calculate fairness index using Jain's fairness formula
@@ -133,7 +253,7 @@ float calculateFairnessIndex(Process processes[], int n)
 
     for (int i = 0; i < n; i++)
     {
-        int waiting_time = processes[i].completion_time - processes[i].arrival_time - processes[i].burst_time;
+        int64_t waiting_time = processes[i].completion_time - processes[i].arrival_time - processes[i].burst_time;
         float normalized_wait = (float)(waiting_time + 1) / (processes[i].burst_time + 1); // +1 to avoid divide by zero
 
         sum_squared += normalized_wait;
@@ -159,9 +279,9 @@ int calculateStarvationCount(Process processes[], int n)
 }
 
 // Function to calculate load balancing efficiency
-float calculateLoadBalancingEfficiency(Process processes[], int n, int total_time)
+float calculateLoadBalancingEfficiency(Process processes[], int n, int64_t total_time)
 {
-    int total_busy_time = 0;
+    int64_t total_busy_time = 0;
     for (int i = 0; i < n; i++)
     {
         total_busy_time += processes[i].burst_time;
@@ -170,78 +290,236 @@ float calculateLoadBalancingEfficiency(Process processes[], int n, int total_tim
     return (float)total_busy_time / total_time;
 }
 
-int main(int argc, char *argv[])
+// Earliest arrival after the given time, or time + 1 if nothing arrives later.
+// Idle periods jump straight to it instead of stepping through every ns.
+int64_t nextArrivalAfter(Process *processes, int n, int64_t time, int sorted)
 {
-    if (argc != 2)
+    if (sorted)
     {
-        printf("Usage: %s <input_file>\n", argv[0]);
-        return 1;
+        int next = firstArrivalAfter(processes, n, time);
+        return next < n ? processes[next].arrival_time : time + 1;
     }
 
-    // Open the input file
-    FILE *file = fopen(argv[1], "r");
-    if (file == NULL)
+    int64_t next_arrival = INT64_MAX;
+    for (int i = 0; i < n; i++)
     {
-        printf("Error opening file: %s\n", argv[1]);
-        return 1;
+        if (processes[i].arrival_time > time && processes[i].arrival_time < next_arrival)
+            next_arrival = processes[i].arrival_time;
     }
+    return next_arrival != INT64_MAX ? next_arrival : time + 1;
+}
+
+// Initialize the simulation fields of a freshly loaded process
+void resetProcessState(Process *process)
+{
+    process->remaining_time = process->burst_time;
+    process->estimated_burst = process->burst_time;
+    process->predicted_burst = process->burst_time;
+    process->completed = 0;
+    process->rejected = 0;
+    process->start_time = -1; // -1 indicates not started yet
+    process->completion_time = 0;
+    process->in_ready_queue = 0;
+    memset(&process->stat, 0, sizeof(process->stat));
+}
+
+// Size of a process record, for the shared models
+const size_t process_size = sizeof(Process);
+
+// Fill in what the shared models read from a process
+void viewProcess(Process *process, ProcessView *view)
+{
+    view->arrival_time = process->arrival_time;
+    view->burst_time = process->burst_time;
+    view->work = visibleRemaining(process);
+    view->deadline = process->deadline;
+    view->completion_time = process->completion_time;
+    view->turnaround_time = process->completion_time - process->arrival_time;
+    view->waiting_time = process->completion_time - process->arrival_time - process->burst_time;
+    view->response_time = process->start_time - process->arrival_time;
+    view->starved = process->completion_time > process->deadline + process->arrival_time;
+    view->completed = process->completed;
+    view->shed = process->rejected;
+}
+
+// Element of a process array, for the shared models
+Process *processAt(Process *processes, int index)
+{
+    return &processes[index];
+}
 
-    // Read the number of processes
-    int n;
-    if (fscanf(file, "%d", &n) != 1)
+// Shed a process for admission control: it counts as done but never runs
+void markShed(Process *process)
+{
+    process->completed = 1;
+    process->rejected = 1;
+}
+
+// Scheduling statistics of a process, for the shared accounting
+SchedStat *processStat(Process *process)
+{
+    return &process->stat;
+}
+
+// Move a process offset earlier, for a trace window simulated from zero
+void shiftProcess(Process *process, int64_t offset)
+{
+    process->arrival_time -= offset;
+}
+
+// Set the trace fields of a process and reset its simulation state; the
+// priority is its nice value
+void initializeProcess(Process *process, int id, int64_t arrival_time, int64_t burst_time, int64_t deadline,
+                       int criticality, int64_t period, int priority)
+{
+    process->pid = id;
+    process->arrival_time = arrival_time;
+    process->burst_time = burst_time;
+    process->deadline = deadline;
+    process->criticality = criticality;
+    process->period = period;
+    process->nice = priority;
+    resetProcessState(process);
+}
+
+// Draw the actual burst of every process around its trace burst, which is kept
+// as the estimate. sigma is the lognormal shape parameter.
+void sampleActualBursts(Process *processes, int n, BurstDistribution distribution, double sigma)
+{
+    for (int i = 0; i < n; i++)
     {
-        printf("Error reading number of processes\n");
-        fclose(file);
-        return 1;
+        processes[i].burst_time = drawActualBurst(distribution, sigma, processes[i].estimated_burst);
+        processes[i].remaining_time = processes[i].burst_time;
     }
+}
 
-    // Allocate memory for processes
-    Process *processes = (Process *)malloc(sizeof(Process) * n);
+// Predict the burst of an arriving process and keep it as what the policy sees
+void predictArrival(Process *process)
+{
+    if (burst_predictor != NULL)
+        process->predicted_burst = predictBurst(burst_predictor, process->estimated_burst, process->burst_time,
+                                                process->criticality);
+}
+
+// Let the predictor learn from a completed process
+void observeBurst(Process *process)
+{
+    if (burst_predictor != NULL)
+        learnBurst(burst_predictor, process->estimated_burst, process->burst_time, process->criticality);
+}
+
+// Pid and the first index holding it, for looking up pids that are not 1..n
+typedef struct
+{
+    int pid;
+    int index;
+} PidIndex;
 
-    // Read process information from file
+// Order the pid map by pid, then by index
+int comparePidIndex(const void *a, const void *b)
+{
+    const PidIndex *p1 = (const PidIndex *)a;
+    const PidIndex *p2 = (const PidIndex *)b;
+    if (p1->pid != p2->pid)
+        return p1->pid < p2->pid ? -1 : 1;
+    return p1->index < p2->index ? -1 : (p1->index > p2->index);
+}
+
+PidIndex *buildPidMap(Process *processes, int n)
+{
+    PidIndex *map = (PidIndex *)malloc(sizeof(PidIndex) * (n > 0 ? n : 1));
+    if (map == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
     for (int i = 0; i < n; i++)
     {
-        if (fscanf(file, "%d %d %d %d %d %d %d",
-                   &processes[i].pid,
-                   &processes[i].arrival_time,
-                   &processes[i].burst_time,
-                   &processes[i].deadline,
-                   &processes[i].criticality,
-                   &processes[i].period,
-                   &processes[i].nice) != 7)
-        {
-            printf("Error reading process information\n");
-            fclose(file);
-            free(processes);
-            return 1;
-        }
+        map[i].pid = processes[i].pid;
+        map[i].index = i;
+    }
+    qsort(map, n, sizeof(PidIndex), comparePidIndex);
+    return map;
+}
 
-        processes[i].remaining_time = processes[i].burst_time;
-        processes[i].completed = 0;
-        processes[i].start_time = -1; // -1 indicates not started yet
-        processes[i].completion_time = 0;
-        processes[i].in_ready_queue = 0;
+// Binary search for the first index holding pid, or -1
+int lookupPid(PidIndex *map, int n, int pid)
+{
+    int low = 0, high = n;
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        if (map[middle].pid < pid)
+            low = middle + 1;
+        else
+            high = middle;
     }
+    return low < n && map[low].pid == pid ? map[low].index : -1;
+}
 
-    fclose(file);
+// Check whether every pid equals its index plus one, so lookups can be direct
+int pidsAreDense(Process *processes, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (processes[i].pid != i + 1)
+            return 0;
+    }
+    return 1;
+}
 
+// Run the reference algorithm (SRPT order with a mean/median time quantum)
+// and return the time at which the last process completed
+int64_t runReferenceAlgo(Process *processes, int n)
+{
     // Create ready queue
     ReadyQueue *ready_queue = createReadyQueue(n);
 
     // Initialize simulation variables
-    int current_time = 0;
+    int64_t current_time = 0;
     int completed_processes = 0;
 
+    // Sorted traces (including synthetic ones) admit arrivals through a cursor;
+    // dense pids are found directly and others through a sorted pid map
+    int sorted = arrivalsSorted(processes, n);
+    int dense_pids = pidsAreDense(processes, n);
+    PidIndex *pid_map = dense_pids ? NULL : buildPidMap(processes, n);
+    int next_arrival = 0;
+    resetProgress(n);
+    if (tick_model != NULL)
+    {
+        tick_model->busy_ticks = 0;
+        tick_model->stolen_time = 0;
+    }
+    if (idle_model != NULL)
+        resetIdleModel(idle_model);
+    if (admission != NULL)
+        resetAdmission(admission, n);
+    if (irq_model != NULL)
+        resetInterrupts(irq_model);
+    if (burst_predictor != NULL)
+        resetPredictor(burst_predictor);
+
     // Simulation loop
-    while (completed_processes < n)
+    // Processes shed by admission control never complete
+    while (completed_processes + (admission != NULL ? admission->rejected : 0) < n)
     {
         // Step 1: Add arrived processes to the ReadyQueue
-        for (int i = 0; i < n; i++)
+        int from = sorted ? next_arrival : 0;
+        int to = sorted ? firstArrivalAfter(processes, n, current_time) : n;
+        for (int i = from; i < to; i++)
         {
             if (processes[i].arrival_time <= current_time &&
                 !processes[i].in_ready_queue &&
                 !processes[i].completed)
             {
+                predictArrival(&processes[i]);
+                if (admission != NULL && !admitArrival(admission, &processes[i], current_time, ready_queue->size))
+                {
+                    // Deferred processes are marked queued so that later scans skip them
+                    processes[i].in_ready_queue = 1;
+                    continue;
+                }
                 addToReadyQueue(ready_queue, processes[i]);
                 processes[i].in_ready_queue = 1;
 
@@ -250,23 +528,29 @@ int main(int argc, char *argv[])
                 proc->in_ready_queue = 1;
             }
         }
+        next_arrival = to;
+
+        // Deferred processes are admitted as the ready queue drains
+        Process *released;
+        while (admission != NULL && (released = releaseDeferred(admission, current_time, ready_queue->size)) != NULL)
+            addToReadyQueue(ready_queue, *released);
 
         // Step 2: If ReadyQueue is not empty, schedule processes
         if (ready_queue->size > 0)
         {
             // Sort ready queue by remaining time (SRPT)
-            qsort(ready_queue->processes, ready_queue->size, sizeof(Process), compareRemainingTime);
+            sortReadyQueue(ready_queue);
 
             // Calculate time quantum based on mean and median of burst times
-            int bt_list[ready_queue->size];
+            int64_t bt_list[ready_queue->size];
             for (int i = 0; i < ready_queue->size; i++)
             {
-                bt_list[i] = ready_queue->processes[i].remaining_time;
+                bt_list[i] = visibleRemaining(&ready_queue->processes[i]);
             }
 
-            float mean_bt = mean(bt_list, ready_queue->size);
-            float median_bt = median(bt_list, ready_queue->size);
-            int time_quantum = (int)((mean_bt + median_bt) / 2);
+            double mean_bt = mean(bt_list, ready_queue->size);
+            double median_bt = median(bt_list, ready_queue->size);
+            int64_t time_quantum = (int64_t)((mean_bt + median_bt) / 2);
 
             // Ensure time quantum is at least 1
             if (time_quantum < 1)
@@ -276,15 +560,7 @@ int main(int argc, char *argv[])
             Process current_process = removeFromReadyQueue(ready_queue, 0);
 
             // Find the process in the original array
-            int idx = -1;
-            for (int i = 0; i < n; i++)
-            {
-                if (processes[i].pid == current_process.pid)
-                {
-                    idx = i;
-                    break;
-                }
-            }
+            int idx = dense_pids ? current_process.pid - 1 : lookupPid(pid_map, n, current_process.pid);
 
             if (idx == -1)
             {
@@ -298,21 +574,52 @@ int main(int argc, char *argv[])
                 processes[idx].start_time = current_time;
             }
 
-            if (current_process.remaining_time <= time_quantum)
+            // With a periodic tick the quantum only ends on a tick, and ticks steal CPU time
+            int64_t work = current_process.remaining_time < time_quantum ? current_process.remaining_time : time_quantum;
+            int64_t slice_end = current_time + work;
+            if (tick_model != NULL)
+                slice_end = tickedExecution(tick_model, current_time, time_quantum, current_process.remaining_time, &work);
+
+            // Interrupts arriving during the slice preempt the process
+            if (irq_model != NULL)
+                slice_end = interruptedExecution(irq_model, current_time, slice_end);
+            progress.busy_time += slice_end - current_time;
+            if (exporter != NULL)
+                metricsDispatch(work);
+
+            // The admitted backlog shrinks by the work the policy sees done,
+            // which includes any revision of a predicted burst
+            int64_t visible_before = visibleRemaining(&processes[idx]);
+
+            if (work == current_process.remaining_time)
             {
                 // Process completes execution
-                current_time += current_process.remaining_time;
+                current_time = slice_end;
                 processes[idx].remaining_time = 0;
                 processes[idx].completed = 1;
                 processes[idx].completion_time = current_time;
                 processes[idx].in_ready_queue = 0;
                 completed_processes++;
+                if (admission != NULL)
+                    admission->backlog -= visible_before;
+                observeBurst(&processes[idx]);
+                recordProgressCompletion(current_time - processes[idx].arrival_time,
+                                         current_time - processes[idx].arrival_time - processes[idx].burst_time,
+                                         processes[idx].start_time - processes[idx].arrival_time);
+                if (exporter != NULL)
+                    metricsCompletion(current_time, processes[idx].deadline);
+
+                // Synthetic runs stop once the steady-state estimates are precise enough
+                if (steady_state != NULL && recordObservation(steady_state, &processes[idx], current_time))
+                    break;
             }
             else
             {
                 // Process is preempted
-                current_time += time_quantum;
-                processes[idx].remaining_time -= time_quantum;
+                current_time = slice_end;
+                processes[idx].remaining_time -= work;
+                if (admission != NULL)
+                    admission->backlog -= visible_before - visibleRemaining(&processes[idx]);
 
                 // Add process back to ready queue
                 processes[idx].in_ready_queue = 0; // Reset flag before adding back
@@ -322,50 +629,588 @@ int main(int argc, char *argv[])
         }
         else
         {
-            // No process in queue, increment time
-            current_time++;
+            // No process in queue, skip to the next arrival; waking from an idle
+            // state delays the dispatch by its exit latency
+            int64_t idle_start = current_time;
+            current_time = nextArrivalAfter(processes, n, current_time, sorted);
+            if (idle_model != NULL)
+                current_time += enterIdleState(idle_model, current_time - idle_start);
+            if (irq_model != NULL)
+                current_time += interruptIdleDelay(irq_model, current_time);
         }
+
+        updateProgress(current_time, completed_processes, ready_queue->size);
     }
 
-    // Calculate metrics
-    float total_turnaround_time = 0;
-    float total_waiting_time = 0;
-    float total_response_time = 0;
+    free(ready_queue->processes);
+    free(ready_queue);
+    free(pid_map);
+    if (tick_model != NULL)
+        tick_model->end_time = current_time;
+    if (irq_model != NULL)
+        irq_model->end_time = current_time;
+
+    return current_time;
+}
+
+// Calculate the reported metrics for a completed run
+void calculateMetrics(Process processes[], int n, int64_t total_time, Metrics *metrics)
+{
+    double total_turnaround_time = 0;
+    double total_waiting_time = 0;
+    double total_response_time = 0;
 
     for (int i = 0; i < n; i++)
     {
-        int turnaround_time = processes[i].completion_time - processes[i].arrival_time;
-        int waiting_time = turnaround_time - processes[i].burst_time;
-        int response_time = processes[i].start_time - processes[i].arrival_time;
+        int64_t turnaround_time = processes[i].completion_time - processes[i].arrival_time;
+        int64_t waiting_time = turnaround_time - processes[i].burst_time;
+        int64_t response_time = processes[i].start_time - processes[i].arrival_time;
 
         total_turnaround_time += turnaround_time;
         total_waiting_time += waiting_time;
         total_response_time += response_time;
     }
 
-    float avg_turnaround_time = total_turnaround_time / n;
-    float avg_waiting_time = total_waiting_time / n;
-    float avg_response_time = total_response_time / n;
-    float throughput = (float)n / processes[n - 1].completion_time;
-    float fairness_index = calculateFairnessIndex(processes, n);
-    int starvation_count = calculateStarvationCount(processes, n);
-    float load_balancing_efficiency = calculateLoadBalancingEfficiency(processes, n, current_time);
+    // Averages and throughput are reported in time units
+    metrics->avg_turnaround_time = total_turnaround_time / n / time_unit;
+    metrics->avg_waiting_time = total_waiting_time / n / time_unit;
+    metrics->avg_response_time = total_response_time / n / time_unit;
+    metrics->throughput = (double)n / ((double)processes[n - 1].completion_time / time_unit);
+    metrics->fairness_index = calculateFairnessIndex(processes, n);
+    metrics->starvation_count = calculateStarvationCount(processes, n);
+    metrics->load_balancing_efficiency = calculateLoadBalancingEfficiency(processes, n, total_time);
+}
 
-    // Write output to CSV file
+// Compute the metrics over the processes that admission control did not shed
+void calculateAdmittedMetrics(Process *processes, int n, int64_t total_time, Metrics *metrics)
+{
+    int admitted;
+    Process *kept = admittedProcesses(processes, n, &admitted);
+    calculateMetrics(kept, admitted, total_time, metrics);
+    if (kept != processes)
+        free(kept);
+}
+
+// Write the metrics as CSV
+void displayMetrics(Metrics *metrics)
+{
     printf("Metric,Value\n");
-    printf("Average Turnaround Time,%.2f\n", avg_turnaround_time);
-    printf("Average Waiting Time,%.2f\n", avg_waiting_time);
-    printf("Average Response Time,%.2f\n", avg_response_time);
-    printf("Throughput,%.2f\n", throughput);
-    printf("Fairness Index,%.2f\n", fairness_index);
-    printf("Starvation Count,%d\n", starvation_count);
-    printf("Load Balancing Efficiency,%.2f\n", load_balancing_efficiency);
+    printf("Average Turnaround Time,%.2f\n", metrics->avg_turnaround_time);
+    printf("Average Waiting Time,%.2f\n", metrics->avg_waiting_time);
+    printf("Average Response Time,%.2f\n", metrics->avg_response_time);
+    printf("Throughput,%.2f\n", metrics->throughput);
+    printf("Fairness Index,%.2f\n", metrics->fairness_index);
+    printf("Starvation Count,%d\n", metrics->starvation_count);
+    printf("Load Balancing Efficiency,%.2f\n", metrics->load_balancing_efficiency);
+}
 
+// Run the reference algorithm for sampling mode
+void runSampledReferenceAlgo(Process *processes, int n, void *context, double *averages)
+{
+    int64_t total_time = runReferenceAlgo(processes, n);
 
+    if (averages != NULL)
+    {
+        Metrics metrics;
+        calculateMetrics(processes, n, total_time, &metrics);
+        averages[0] = metrics.avg_turnaround_time;
+        averages[1] = metrics.avg_waiting_time;
+        averages[2] = metrics.avg_response_time;
+        averages[3] = metrics.starvation_count;
+    }
+}
+
+// One run of the interrupt comparison: without, then with the interrupt source
+void runInterruptVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Metrics run_metrics;
+    irq_model = variant ? (InterruptModel *)context : NULL;
+    calculateAdmittedMetrics(processes, n, runReferenceAlgo(processes, n), &run_metrics);
+    summarizeResponses(processes, n, values);
+    values[4] = run_metrics.avg_turnaround_time;
+    values[5] = run_metrics.throughput;
+}
+
+// Run the trace without and then with the interrupt source, and compare the
+// metrics interrupts disturb
+void runInterruptComparison(Process *processes, int n, InterruptModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Response Time",
+        "Response Time Jitter",
+        "P99 Response Time",
+        "Deadline Misses",
+        "Average Turnaround Time",
+        "Throughput"};
+
+    runComparison(processes, n, runInterruptVariant, model, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "No Interrupts", "Interrupts");
+    displayInterruptLoad(model);
+}
+
+// Summary metrics of a run, in the order displayMetrics reports them
+void metricValues(Metrics *run_metrics, double *values)
+{
+    values[0] = run_metrics->avg_turnaround_time;
+    values[1] = run_metrics->avg_waiting_time;
+    values[2] = run_metrics->avg_response_time;
+    values[3] = run_metrics->throughput;
+    values[4] = run_metrics->fairness_index;
+    values[5] = run_metrics->starvation_count;
+    values[6] = run_metrics->load_balancing_efficiency;
+}
+
+// One run of the tick comparison: tickless, then with the tick model
+void runTickVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Metrics run_metrics;
+    tick_model = variant ? (TickModel *)context : NULL;
+    calculateAdmittedMetrics(processes, n, runReferenceAlgo(processes, n), &run_metrics);
+    metricValues(&run_metrics, values);
+}
+
+// Run the trace tickless and then with the tick model, and compare the metrics
+void runTickComparison(Process *processes, int n, TickModel *model)
+{
+    static const char *metric_names[] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time",
+        "Throughput",
+        "Fairness Index",
+        "Starvation Count",
+        "Load Balancing Efficiency"};
+    char label[32];
+    snprintf(label, sizeof(label), "HZ=%lld", (long long)model->hz);
+
+    runComparison(processes, n, runTickVariant, model, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "Tickless", label);
+    displayTickStats(model);
+}
+// One run of the predictor comparison: exact burst knowledge, then the predictor
+void runPredictorVariant(Process *processes, int n, int variant, double *values, void *context)
+{
+    Metrics run_metrics;
+    burst_predictor = variant ? (BurstPredictor *)context : NULL;
+    calculateAdmittedMetrics(processes, n, runReferenceAlgo(processes, n), &run_metrics);
+    metricValues(&run_metrics, values);
+}
+
+// Run the trace with exact burst knowledge and then with the predictor, and compare the metrics
+void runPredictorComparison(Process *processes, int n, BurstPredictor *predictor)
+{
+    static const char *metric_names[] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time",
+        "Throughput",
+        "Fairness Index",
+        "Starvation Count",
+        "Load Balancing Efficiency"};
+    static const char *predictor_names[] = {"oracle", "estimate", "ewma", "class"};
+
+    runComparison(processes, n, runPredictorVariant, predictor, metric_names,
+                  (int)(sizeof(metric_names) / sizeof(metric_names[0])), "Exact", predictor_names[predictor->kind]);
+    displayPredictorStats(predictor);
+}
+
+int main(int argc, char *argv[])
+{
+    SamplingParams sampling;
+    SteadyStateParams steady;
+    const char *stats_filename = NULL;
+    int progress_interval = 0;
+    const char *metrics_socket = NULL;
+    const char *metrics_file = NULL;
+    int metrics_interval = DEFAULT_METRICS_INTERVAL;
+    TickModel ticks;
+    int tick_compare = 0;
+    IdleModel idle;
+    const char *idle_states = NULL;
+    const char *idle_governor = NULL;
+    AdmissionControl admit;
+    InterruptModel irq;
+    int irq_compare = 0;
+    BurstPredictor predictor;
+    const char *predictor_name = NULL;
+    const char *actual_bursts = NULL;
+    int predictor_compare = 0;
+
+    // Tickless unless a tick rate is given with --hz
+    memset(&ticks, 0, sizeof(ticks));
+    ticks.overhead = DEFAULT_TICK_OVERHEAD_NS;
+
+    // Idle CPUs wake up instantly unless idle states are enabled
+    memset(&idle, 0, sizeof(idle));
+    idle.latency_limit = -1;
+
+    // Every arrival is admitted unless an admission limit is set
+    memset(&admit, 0, sizeof(admit));
+    admit.horizon = -1;
+
+    // No interrupt load unless an interval is given with --irq-interval-ns
+    memset(&irq, 0, sizeof(irq));
+    irq.hardirq = DEFAULT_HARDIRQ_NS;
+    irq.softirq = DEFAULT_SOFTIRQ_NS;
+    irq.burst = 1.0;
+
+    // Policies know the exact bursts unless a predictor is chosen with --predictor
+    memset(&predictor, 0, sizeof(predictor));
+    predictor.alpha = DEFAULT_PREDICTOR_ALPHA;
+
+    // Sampling mode is off unless requested with --sample
+    sampling.enabled = 0;
+    sampling.window_length = 0;
+    sampling.strata = 4;
+    sampling.windows_per_stratum = 3;
+    sampling.warmup = -1;
+    sampling.seed = 1;
+    sampling.compare = 0;
+
+    // Synthetic workloads are off unless requested with --synthetic
+    steady.enabled = 0;
+    steady.arrival_rate = 0.15;
+    steady.mean_burst = 4.0;
+    steady.max_jobs = 200000;
+    steady.precision = 0.05;
+    steady.abs_precision = 0.01;
+    steady.check_interval = 1000;
+    steady.seed = 1;
+
+    // The input file comes first unless a synthetic workload is requested
+    int first_option = (argc > 1 && strncmp(argv[1], "--", 2) != 0) ? 2 : 1;
+
+    // Optional flags follow the input file
+    for (int i = first_option; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sample") == 0)
+            sampling.enabled = 1;
+        else if (strcmp(argv[i], "--compare") == 0)
+            sampling.compare = 1;
+        else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc)
+            sampling.window_length = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--strata") == 0 && i + 1 < argc)
+            sampling.strata = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--per-stratum") == 0 && i + 1 < argc)
+            sampling.windows_per_stratum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            sampling.warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--synthetic") == 0)
+            steady.enabled = 1;
+        else if (strcmp(argv[i], "--arrival-rate") == 0 && i + 1 < argc)
+            steady.arrival_rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--mean-burst") == 0 && i + 1 < argc)
+            steady.mean_burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-jobs") == 0 && i + 1 < argc)
+            steady.max_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc)
+            steady.precision = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            sampling.seed = steady.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--time-unit-ns") == 0 && i + 1 < argc)
+            time_unit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--small-queue") == 0 && i + 1 < argc)
+            small_queue_max = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            ticks.hz = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-overhead-ns") == 0 && i + 1 < argc)
+            ticks.overhead = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick-compare") == 0)
+            tick_compare = 1;
+        else if (strcmp(argv[i], "--idle-states") == 0 && i + 1 < argc)
+            idle_states = argv[++i];
+        else if (strcmp(argv[i], "--idle-governor") == 0 && i + 1 < argc)
+            idle_governor = argv[++i];
+        else if (strcmp(argv[i], "--idle-latency-limit-ns") == 0 && i + 1 < argc)
+            idle.latency_limit = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-utilization") == 0 && i + 1 < argc)
+            admit.max_utilization = atof(argv[++i]);
+        else if (strcmp(argv[i], "--admit-horizon-ns") == 0 && i + 1 < argc)
+            admit.horizon = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-queue") == 0 && i + 1 < argc)
+            admit.max_queue = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--admit-max-defer-ns") == 0 && i + 1 < argc)
+            admit.max_deferral = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--admit-deadlines") == 0)
+            admit.deadline_check = 1;
+        else if (strcmp(argv[i], "--actual-bursts") == 0 && i + 1 < argc)
+            actual_bursts = argv[++i];
+        else if (strcmp(argv[i], "--predictor") == 0 && i + 1 < argc)
+            predictor_name = argv[++i];
+        else if (strcmp(argv[i], "--predictor-alpha") == 0 && i + 1 < argc)
+            predictor.alpha = atof(argv[++i]);
+        else if (strcmp(argv[i], "--predictor-compare") == 0)
+            predictor_compare = 1;
+        else if (strcmp(argv[i], "--irq-interval-ns") == 0 && i + 1 < argc)
+            irq.interval = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-hardirq-ns") == 0 && i + 1 < argc)
+            irq.hardirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-softirq-ns") == 0 && i + 1 < argc)
+            irq.softirq = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--irq-burst") == 0 && i + 1 < argc)
+            irq.burst = atof(argv[++i]);
+        else if (strcmp(argv[i], "--irq-compare") == 0)
+            irq_compare = 1;
+        else if (strcmp(argv[i], "--progress-file") == 0 && i + 1 < argc)
+            stats_filename = argv[++i];
+        else if (strcmp(argv[i], "--progress-interval") == 0 && i + 1 < argc)
+            progress_interval = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--metrics-socket") == 0 && i + 1 < argc)
+            metrics_socket = argv[++i];
+        else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc)
+            metrics_file = argv[++i];
+        else if (strcmp(argv[i], "--metrics-interval") == 0 && i + 1 < argc)
+            metrics_interval = atoi(argv[++i]);
+        else
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (time_unit < 1)
+    {
+        printf("Invalid time unit: %lld ns (must be at least 1)\n", (long long)time_unit);
+        return 1;
+    }
+    if (small_queue_max < 0 || small_queue_max > SMALL_QUEUE_CAPACITY)
+    {
+        printf("Invalid small queue size: %d (must be 0 to %d)\n", small_queue_max, SMALL_QUEUE_CAPACITY);
+        return 1;
+    }
+
+    if (ticks.hz > 0)
+    {
+        ticks.period = 1000000000LL / ticks.hz;
+        if (ticks.period < 1 || ticks.overhead < 0 || ticks.overhead >= ticks.period)
+        {
+            printf("Invalid tick settings: %lld HZ with %lld ns overhead per tick\n",
+                   (long long)ticks.hz, (long long)ticks.overhead);
+            return 1;
+        }
+        tick_model = &ticks;
+    }
+
+    if (idle_states != NULL || idle_governor != NULL || idle.latency_limit >= 0)
+    {
+        if (parseIdleStates(&idle, idle_states != NULL ? idle_states : DEFAULT_IDLE_STATES) < 1)
+        {
+            printf("Invalid idle states: %s\n", idle_states);
+            return 1;
+        }
+        int governor = parseIdleGovernor(idle_governor != NULL ? idle_governor : "menu");
+        if (governor < 0)
+        {
+            printf("Unknown idle governor: %s\n", idle_governor);
+            return 1;
+        }
+        idle.governor = (IdleGovernor)governor;
+        idle_model = &idle;
+    }
+
+    if (admit.horizon < 0)
+        admit.horizon = DEFAULT_ADMISSION_HORIZON * time_unit;
+    if (admit.max_utilization < 0 || admit.horizon < 1 || admit.max_queue < 0 || admit.max_deferral < 0)
+    {
+        printf("Invalid admission settings\n");
+        return 1;
+    }
+    if (admit.max_utilization > 0 || admit.max_queue > 0 || admit.deadline_check)
+        admission = &admit;
+
+    if (irq.interval > 0)
+    {
+        // The handlers must leave the CPU some time, or no process ever finishes
+        if (irq.hardirq < 0 || irq.softirq < 0 || irq.burst < 1.0 || irq.hardirq + irq.softirq >= irq.interval)
+        {
+            printf("Invalid interrupt settings: %lld ns handlers every %lld ns in bursts of %g\n",
+                   (long long)(irq.hardirq + irq.softirq), (long long)irq.interval, irq.burst);
+            return 1;
+        }
+        irq.seed = sampling.seed;
+        irq_model = &irq;
+    }
+
+    // Actual bursts are drawn as "lognormal[:sigma]" or "exponential" around the trace's
+    BurstDistribution distribution = BURSTS_EXACT;
+    double burst_sigma = DEFAULT_BURST_SIGMA;
+    if (actual_bursts != NULL)
+    {
+        int parsed = parseBurstDistribution(actual_bursts, &burst_sigma);
+        if (parsed < 0)
+        {
+            printf("Invalid actual burst distribution: %s\n", actual_bursts);
+            return 1;
+        }
+        distribution = (BurstDistribution)parsed;
+    }
+
+    if (predictor_name != NULL)
+    {
+        int kind = parsePredictor(predictor_name);
+        if (kind < 0 || predictor.alpha <= 0 || predictor.alpha > 1)
+        {
+            printf("Invalid burst predictor: %s with alpha %g\n", predictor_name, predictor.alpha);
+            return 1;
+        }
+        predictor.kind = (PredictorKind)kind;
+        burst_predictor = &predictor;
+    }
+
+    // SIGUSR1 (and --progress-interval) dump live progress to stderr or --progress-file
+    startProgressReporting(stats_filename, progress_interval);
+
+    // --metrics-socket and --metrics-file export Prometheus metrics from a separate thread
+    if (metrics_socket != NULL || metrics_file != NULL)
+    {
+        if (metrics_interval < 1)
+        {
+            printf("Invalid metrics interval: %d s\n", metrics_interval);
+            return 1;
+        }
+        exporter = startMetricsExporter(METRICS_SCHEDULER, metrics_socket, metrics_file, metrics_interval);
+        if (exporter == NULL)
+        {
+            printf("Error starting metrics exporter on %s\n", metrics_socket != NULL ? metrics_socket : metrics_file);
+            return 1;
+        }
+        atexit(stopMetricsExporter);
+    }
+
+    if (steady.enabled)
+    {
+        SteadyState state;
+        Process *processes;
+        int n = generateSyntheticProcesses(&processes, &steady);
+        initializeSteadyState(&state, &steady);
+        steady_state = &state;
+
+        runReferenceAlgo(processes, n);
+        if (!state.converged)
+            evaluateSteadyState(&state);
+        displaySteadyState(&state);
+
+        steady_state = NULL;
+        freeSteadyState(&state);
+        free(processes);
+        return 0;
+    }
+
+    if (first_option == 1)
+    {
+        printf("Usage: %s <input_file> [--sample [--compare] [--window L] [--strata S] [--per-stratum K] [--warmup W] [--seed N]] [--time-unit-ns U] [--small-queue N] [--hz N [--tick-overhead-ns O] [--tick-compare]] [--idle-states S] [--idle-governor G] [--idle-latency-limit-ns L] [--admit-utilization U [--admit-horizon-ns H]] [--admit-queue Q [--admit-max-defer-ns D]] [--admit-deadlines] [--actual-bursts D] [--predictor P [--predictor-alpha A] [--predictor-compare]] [--irq-interval-ns I [--irq-hardirq-ns H] [--irq-softirq-ns S] [--irq-burst B] [--irq-compare]] [--progress-file F] [--progress-interval S] [--metrics-socket P] [--metrics-file F [--metrics-interval S]]\n", argv[0]);
+        printf("       %s --synthetic [--arrival-rate R] [--mean-burst B] [--max-jobs N] [--precision P] [--seed N]\n", argv[0]);
+        return 1;
+    }
+
+    // Traces prepared by trace-prep are mapped instead of parsed
+    Process *processes = NULL;
+    int n = readPreparedTrace(&processes, argv[1]);
+    if (n < 0)
+        return 1;
+    if (n == 0)
+    {
+        // Open the input file
+        FILE *file = fopen(argv[1], "r");
+        if (file == NULL)
+        {
+            printf("Error opening file: %s\n", argv[1]);
+            return 1;
+        }
+
+        // Read the number of processes
+        if (fscanf(file, "%d", &n) != 1)
+        {
+            printf("Error reading number of processes\n");
+            fclose(file);
+            return 1;
+        }
+
+        // Allocate memory for processes
+        processes = (Process *)malloc(sizeof(Process) * n);
+
+        // Read process information from file; times are given in time units and kept in ns
+        for (int i = 0; i < n; i++)
+        {
+            long long arrival_time, burst_time, deadline, period;
+            if (fscanf(file, "%d %lld %lld %lld %d %lld %d",
+                       &processes[i].pid,
+                       &arrival_time,
+                       &burst_time,
+                       &deadline,
+                       &processes[i].criticality,
+                       &period,
+                       &processes[i].nice) != 7)
+            {
+                printf("Error reading process information\n");
+                fclose(file);
+                free(processes);
+                return 1;
+            }
+
+            processes[i].arrival_time = arrival_time * time_unit;
+            processes[i].burst_time = burst_time * time_unit;
+            processes[i].deadline = deadline * time_unit;
+            processes[i].period = period * time_unit;
+            resetProcessState(&processes[i]);
+        }
+
+        fclose(file);
+    }
+
+    if (distribution != BURSTS_EXACT)
+    {
+        srand(sampling.seed);
+        sampleActualBursts(processes, n, distribution, burst_sigma);
+    }
+
+    if (predictor_compare && burst_predictor != NULL)
+    {
+        runPredictorComparison(processes, n, burst_predictor);
+        free(processes);
+        return 0;
+    }
+
+    if (sampling.enabled)
+    {
+        runSampling(processes, n, runSampledReferenceAlgo, NULL, &sampling);
+        free(processes);
+        return 0;
+    }
+
+    if (tick_compare && tick_model != NULL)
+    {
+        runTickComparison(processes, n, tick_model);
+        free(processes);
+        return 0;
+    }
+
+    if (irq_compare && irq_model != NULL)
+    {
+        runInterruptComparison(processes, n, irq_model);
+        free(processes);
+        return 0;
+    }
+
+    // Run the simulation and write the metrics as CSV
+    Metrics metrics;
+    int64_t total_time = runReferenceAlgo(processes, n);
+    calculateAdmittedMetrics(processes, n, total_time, &metrics);
+    displayMetrics(&metrics);
+    if (tick_model != NULL)
+        displayTickStats(tick_model);
+    if (idle_model != NULL)
+        displayIdleStats(idle_model);
+    if (admission != NULL)
+        displayAdmissionStats(admission, processes, n);
+    if (irq_model != NULL)
+        displayInterruptStats(irq_model, processes, n);
+    if (burst_predictor != NULL)
+        displayPredictorStats(burst_predictor);
+
+
+    free(admit.deferred);
     free(processes);
-    free(ready_queue->processes);
-    free(ready_queue);
 
     return 0;
 }
-
@@ -0,0 +1,2459 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "sim-common.h"
+#include "trace-io.h"
+
+// Global variables
+GanttChartItem *gantt_chart = NULL;
+int gantt_chart_size = 0;
+int gantt_chart_capacity = 0;
+SteadyState *steady_state = NULL;
+int64_t time_unit = 1; // Nanoseconds per time unit of the input trace
+TickModel *tick_model = NULL;
+IdleModel *idle_model = NULL;
+AdmissionControl *admission = NULL;
+BurstPredictor *burst_predictor = NULL;
+InterruptModel *irq_model = NULL;
+HostModel *host_model = NULL;
+_Thread_local int host_guest = HOST_TURN; // Guest whose simulation runs on this thread
+ProgressCounters progress;
+volatile sig_atomic_t progress_requested = 0;
+const char *progress_filename = NULL;
+struct timespec progress_start;
+MetricsExporter *exporter = NULL;
+
+// Add an entry to the Gantt chart
+void addToGanttChart(int process_id, int64_t start_time, int64_t end_time)
+{
+    if (gantt_chart_size == gantt_chart_capacity)
+    {
+        // Grow the chart geometrically so long schedules stay cheap to record
+        int capacity = gantt_chart_capacity ? gantt_chart_capacity * 2 : INITIAL_GANTT_CHART_SIZE;
+        GanttChartItem *grown = (GanttChartItem *)realloc(gantt_chart, sizeof(GanttChartItem) * capacity);
+        if (grown != NULL)
+        {
+            gantt_chart = grown;
+            gantt_chart_capacity = capacity;
+        }
+    }
+
+    if (gantt_chart_size < gantt_chart_capacity)
+    {
+        gantt_chart[gantt_chart_size].process_id = process_id;
+        gantt_chart[gantt_chart_size].start_time = start_time;
+        gantt_chart[gantt_chart_size].end_time = end_time;
+        gantt_chart_size++;
+    }
+    else
+    {
+        printf("Gantt chart is full!\n");
+    }
+}
+
+// Display Gantt chart
+void displayGanttChart()
+{
+    printf("\n\nGantt Chart:\n");
+
+    // Print top border
+    printf(" ");
+    for (int i = 0; i < gantt_chart_size; i++)
+    {
+        int64_t duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
+        for (int j = 0; j < duration; j++)
+        {
+            printf("--");
+        }
+        printf(" ");
+    }
+    printf("\n|");
+
+    // Print process IDs
+    for (int i = 0; i < gantt_chart_size; i++)
+    {
+        int64_t duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
+        for (int j = 0; j < duration; j++)
+        {
+            if (gantt_chart[i].process_id == -1)
+            {
+                printf("I "); // I for Idle
+            }
+            else
+            {
+                printf("P%d", gantt_chart[i].process_id);
+            }
+            if (j < duration - 1)
+            {
+                printf(" ");
+            }
+        }
+        printf("|");
+    }
+
+    // Print bottom border
+    printf("\n ");
+    for (int i = 0; i < gantt_chart_size; i++)
+    {
+        int64_t duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
+        for (int j = 0; j < duration; j++)
+        {
+            printf("--");
+        }
+        printf(" ");
+    }
+
+    // Print time markers
+    printf("\n");
+    for (int i = 0; i < gantt_chart_size; i++)
+    {
+        printf("%2lld", (long long)gantt_chart[i].start_time);
+        int64_t duration = gantt_chart[i].end_time - gantt_chart[i].start_time;
+        for (int j = 0; j < duration * 2 - 1; j++)
+        {
+            printf(" ");
+        }
+    }
+    printf("%2lld\n", (long long)gantt_chart[gantt_chart_size - 1].end_time);
+}
+
+// Write the Gantt chart as CSV segments (CPU,ProcessID,StartTime,EndTime)
+// for the gantt-index tool; the simulators run on a single CPU (0)
+void writeGanttChart(const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("Error creating Gantt chart file %s\n", filename);
+        return;
+    }
+
+    fprintf(file, "CPU,ProcessID,StartTime,EndTime\n");
+    for (int i = 0; i < gantt_chart_size; i++)
+    {
+        fprintf(file, "0,%d,%lld,%lld\n", gantt_chart[i].process_id,
+                (long long)gantt_chart[i].start_time, (long long)gantt_chart[i].end_time);
+    }
+
+    fclose(file);
+}
+
+// Charge the time a deferred process spent before admission as blocked
+void accountRelease(Process *process, int64_t now)
+{
+    ProcessView view;
+    viewProcess(process, &view);
+    SchedStat *stat = processStat(process);
+    stat->blocked_time += now - view.arrival_time;
+    stat->runnable_since = now;
+}
+
+// Charge a finished slice: the wait since the process became runnable, its
+// own work as running and the rest of the slice as throttled. A slice that
+// leaves work behind (preempted) is a preemption.
+void accountSlice(Process *process, int64_t start, int64_t end, int64_t work, bool preempted)
+{
+    ProcessView view;
+    viewProcess(process, &view);
+    SchedStat *stat = processStat(process);
+    int64_t since = stat->runnable_since;
+    if (stat->slices == 0 && since < view.arrival_time)
+        since = view.arrival_time;
+    stat->wait_time += start - since;
+    stat->run_time += work;
+    stat->throttled_time += end - start - work;
+    stat->runnable_since = end;
+    stat->slices++;
+    if (preempted)
+        stat->preemptions++;
+}
+
+// Start a fresh progress block for a run over n processes
+void resetProgress(int n)
+{
+    memset(&progress, 0, sizeof(progress));
+    progress.total_processes = n;
+    if (exporter != NULL)
+        clock_gettime(CLOCK_MONOTONIC, &exporter->last_event);
+}
+
+
+// Add a completed process to the running metric sums
+void recordProgressCompletion(int64_t turnaround_time, int64_t waiting_time, int64_t response_time)
+{
+    progress.sum_turnaround += turnaround_time;
+    progress.sum_waiting += waiting_time;
+    progress.sum_response += response_time;
+}
+
+
+// Write the progress block to stderr, or atomically replace the stats file
+void writeProgressSnapshot()
+{
+    progress_requested = 0;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double wall_seconds = (now.tv_sec - progress_start.tv_sec) + (now.tv_nsec - progress_start.tv_nsec) / 1e9;
+    double completed = progress.completed > 0 ? (double)progress.completed : 1.0;
+
+    char temp_filename[MAX_FILENAME_LENGTH + 8];
+    FILE *file = stderr;
+    if (progress_filename != NULL)
+    {
+        snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", progress_filename);
+        file = fopen(temp_filename, "w");
+        if (file == NULL)
+            return;
+    }
+
+    fprintf(file, "Progress,Value\n");
+    fprintf(file, "Wall Seconds,%.2f\n", wall_seconds);
+    fprintf(file, "Simulated Time (ns),%lld\n", progress.simulated_time);
+    fprintf(file, "Events,%lld\n", progress.events);
+    fprintf(file, "Events Per Second,%.0f\n", wall_seconds > 0 ? progress.events / wall_seconds : 0.0);
+    fprintf(file, "Completed Processes,%lld\n", progress.completed);
+    fprintf(file, "Total Processes,%d\n", progress.total_processes);
+    fprintf(file, "Ready Queue Length,%lld\n", progress.queue_length);
+    fprintf(file, "CPU Utilization,%.4f\n",
+            progress.simulated_time > 0 ? (double)progress.busy_time / progress.simulated_time : 0.0);
+    fprintf(file, "Average Turnaround Time (ns),%.2f\n", progress.sum_turnaround / completed);
+    fprintf(file, "Average Waiting Time (ns),%.2f\n", progress.sum_waiting / completed);
+    fprintf(file, "Average Response Time (ns),%.2f\n", progress.sum_response / completed);
+
+    if (progress_filename != NULL)
+    {
+        fclose(file);
+        rename(temp_filename, progress_filename);
+    }
+    else
+    {
+        fflush(file);
+    }
+}
+
+
+// Publish the loop state after one event and serve pending snapshot requests
+void updateProgress(int64_t current_time, int completed_processes, int queue_length)
+{
+    progress.simulated_time = current_time;
+    progress.completed = completed_processes;
+    progress.queue_length = queue_length;
+    progress.events++;
+    if (exporter != NULL)
+        metricsEvent(current_time, queue_length);
+    if (progress_requested)
+        writeProgressSnapshot();
+}
+
+
+// SIGUSR1 and the interval timer only raise a flag; the event loop writes the
+// snapshot at its next event, so the counters never need a lock
+void handleProgressSignal(int signal_number)
+{
+    (void)signal_number;
+    progress_requested = 1;
+}
+
+
+// Install the SIGUSR1 handler and, for interval > 0, a periodic timer
+void startProgressReporting(const char *filename, int interval)
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleProgressSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
+
+    progress_filename = filename;
+    clock_gettime(CLOCK_MONOTONIC, &progress_start);
+
+    if (interval > 0)
+    {
+        sigaction(SIGALRM, &action, NULL);
+        struct itimerval timer;
+        timer.it_interval.tv_sec = interval;
+        timer.it_interval.tv_usec = 0;
+        timer.it_value = timer.it_interval;
+        setitimer(ITIMER_REAL, &timer, NULL);
+    }
+}
+
+// Histogram bucket of a value: the first power of four not below it
+int metricsBucket(int64_t value)
+{
+    if (value <= 1)
+        return 0;
+    int bucket = (65 - __builtin_clzll((unsigned long long)(value - 1))) / 2;
+    return bucket < METRICS_BUCKETS ? bucket : METRICS_BUCKETS;
+}
+
+void observeHistogram(MetricsHistogram *histogram, int64_t value)
+{
+    histogram->buckets[metricsBucket(value)]++;
+    histogram->sum += value;
+    histogram->count++;
+}
+
+// Make the sequence odd before the event loop changes the snapshot
+void beginMetricsUpdate(MetricsExporter *e)
+{
+    unsigned int sequence = atomic_load_explicit(&e->sequence, memory_order_relaxed);
+    atomic_store_explicit(&e->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+// Make the sequence even again once the snapshot is consistent
+void endMetricsUpdate(MetricsExporter *e)
+{
+    unsigned int sequence = atomic_load_explicit(&e->sequence, memory_order_relaxed);
+    atomic_store_explicit(&e->sequence, sequence + 1, memory_order_release);
+}
+
+// Count a dispatch decision granting the given amount of work
+void metricsDispatch(int64_t quantum)
+{
+    beginMetricsUpdate(exporter);
+    exporter->snapshot.decisions++;
+    observeHistogram(&exporter->snapshot.quantum, quantum);
+    endMetricsUpdate(exporter);
+}
+
+// Count a completion and whether it came after the process's deadline
+void metricsCompletion(int64_t completion_time, int64_t deadline)
+{
+    beginMetricsUpdate(exporter);
+    exporter->snapshot.completed++;
+    if (deadline > 0 && completion_time > deadline)
+        exporter->snapshot.deadline_misses++;
+    endMetricsUpdate(exporter);
+}
+
+// Publish the loop state after one event, timing the event on the wall clock
+void metricsEvent(int64_t current_time, int queue_length)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t latency = (int64_t)(now.tv_sec - exporter->last_event.tv_sec) * 1000000000LL +
+                      (now.tv_nsec - exporter->last_event.tv_nsec);
+    exporter->last_event = now;
+
+    beginMetricsUpdate(exporter);
+    exporter->snapshot.events++;
+    exporter->snapshot.queue_length = queue_length;
+    exporter->snapshot.simulated_time = current_time;
+    observeHistogram(&exporter->snapshot.queue_depth, queue_length);
+    observeHistogram(&exporter->snapshot.latency, latency);
+    endMetricsUpdate(exporter);
+}
+
+// Copy a consistent snapshot, retrying while the event loop is mid-update
+void readMetricsSnapshot(MetricsExporter *e, MetricsSnapshot *snapshot)
+{
+    unsigned int before, after;
+    do
+    {
+        before = atomic_load_explicit(&e->sequence, memory_order_acquire);
+        memcpy(snapshot, &e->snapshot, sizeof(*snapshot));
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&e->sequence, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+}
+
+// Write one counter or gauge sample with its HELP and TYPE lines
+void writeMetric(FILE *file, const char *scheduler, const char *name, const char *type, const char *help, double value)
+{
+    fprintf(file, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    fprintf(file, "%s{scheduler=\"%s\"} %.15g\n", name, scheduler, value);
+}
+
+// Write a histogram as cumulative buckets followed by its sum and count
+void writeMetricsHistogram(FILE *file, const char *scheduler, const char *name, const char *help, MetricsHistogram *histogram)
+{
+    fprintf(file, "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    long long cumulative = 0;
+    long long bound = 1;
+    for (int b = 0; b < METRICS_BUCKETS; b++, bound *= 4)
+    {
+        cumulative += histogram->buckets[b];
+        fprintf(file, "%s_bucket{scheduler=\"%s\",le=\"%lld\"} %lld\n", name, scheduler, bound, cumulative);
+    }
+    cumulative += histogram->buckets[METRICS_BUCKETS];
+    fprintf(file, "%s_bucket{scheduler=\"%s\",le=\"+Inf\"} %lld\n", name, scheduler, cumulative);
+    fprintf(file, "%s_sum{scheduler=\"%s\"} %lld\n", name, scheduler, histogram->sum);
+    fprintf(file, "%s_count{scheduler=\"%s\"} %lld\n", name, scheduler, histogram->count);
+}
+
+// Format a snapshot of the metrics in Prometheus text exposition format
+void formatMetrics(FILE *file, MetricsExporter *e)
+{
+    MetricsSnapshot snapshot;
+    readMetricsSnapshot(e, &snapshot);
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double uptime = (now.tv_sec - e->start.tv_sec) + (now.tv_nsec - e->start.tv_nsec) / 1e9;
+
+    writeMetric(file, e->scheduler, "sched_decisions_total", "counter", "Dispatch decisions made.", snapshot.decisions);
+    writeMetric(file, e->scheduler, "sched_decisions_per_second", "gauge", "Dispatch decisions per wall-clock second since start.",
+                uptime > 0 ? snapshot.decisions / uptime : 0.0);
+    writeMetric(file, e->scheduler, "sched_events_total", "counter", "Scheduling events, including idle steps.", snapshot.events);
+    writeMetric(file, e->scheduler, "sched_completed_total", "counter", "Processes completed.", snapshot.completed);
+    writeMetric(file, e->scheduler, "sched_deadline_misses_total", "counter", "Processes completed after their deadline.",
+                snapshot.deadline_misses);
+    writeMetric(file, e->scheduler, "sched_ready_queue_length", "gauge", "Ready queue length after the latest event.",
+                snapshot.queue_length);
+    writeMetric(file, e->scheduler, "sched_simulated_time_ns", "gauge", "Simulated clock of the current run.",
+                snapshot.simulated_time);
+    writeMetric(file, e->scheduler, "sched_uptime_seconds", "gauge", "Wall-clock seconds since the exporter started.", uptime);
+    writeMetricsHistogram(file, e->scheduler, "sched_ready_queue_depth", "Ready queue length observed after each event.",
+                          &snapshot.queue_depth);
+    writeMetricsHistogram(file, e->scheduler, "sched_quantum_ns", "Work granted per dispatch decision.", &snapshot.quantum);
+    writeMetricsHistogram(file, e->scheduler, "sched_decision_latency_ns", "Wall-clock time the event loop spent per event.",
+                          &snapshot.latency);
+}
+
+// Atomically replace the metrics file (textfile collector style)
+void writeMetricsFile(MetricsExporter *e)
+{
+    char temp_filename[MAX_FILENAME_LENGTH + 8];
+    snprintf(temp_filename, sizeof(temp_filename), "%s.tmp", e->file_path);
+    FILE *file = fopen(temp_filename, "w");
+    if (file == NULL)
+        return;
+    formatMetrics(file, e);
+    fclose(file);
+    rename(temp_filename, e->file_path);
+}
+
+// Answer one connection with an HTTP response carrying the metrics, so that
+// both curl --unix-socket and a plain socket reader can scrape them
+void serveMetricsClient(MetricsExporter *e)
+{
+    int client = accept(e->listen_fd, NULL, NULL);
+    if (client < 0)
+        return;
+
+    // Consume the request, if the client sends one, before answering
+    char request[1024];
+    struct pollfd readable = {client, POLLIN, 0};
+    if (poll(&readable, 1, METRICS_REQUEST_TIMEOUT_MS) > 0)
+        recv(client, request, sizeof(request), 0);
+
+    char *body = NULL;
+    size_t length = 0;
+    FILE *stream = open_memstream(&body, &length);
+    if (stream != NULL)
+    {
+        formatMetrics(stream, e);
+        fclose(stream);
+
+        char header[128];
+        int header_length = snprintf(header, sizeof(header),
+                                     "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: %zu\r\n\r\n",
+                                     length);
+        if (send(client, header, header_length, MSG_NOSIGNAL) == header_length)
+        {
+            for (size_t sent = 0; sent < length;)
+            {
+                ssize_t written = send(client, body + sent, length - sent, MSG_NOSIGNAL);
+                if (written <= 0)
+                    break;
+                sent += written;
+            }
+        }
+        free(body);
+    }
+    close(client);
+}
+
+int64_t monotonicMilliseconds()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// Exporter thread: serve scrapes and rewrite the metrics file until woken to stop
+void *runMetricsExporter(void *argument)
+{
+    MetricsExporter *e = argument;
+    struct pollfd fds[2] = {{e->wake_pipe[0], POLLIN, 0}, {e->listen_fd, POLLIN, 0}};
+    int count = e->listen_fd >= 0 ? 2 : 1;
+    int64_t next_write = monotonicMilliseconds() + e->interval * 1000LL;
+
+    while (true)
+    {
+        int timeout = -1;
+        if (e->file_path != NULL)
+        {
+            int64_t remaining = next_write - monotonicMilliseconds();
+            timeout = remaining > 0 ? (int)remaining : 0;
+        }
+
+        int ready = poll(fds, count, timeout);
+        if (ready > 0 && (fds[0].revents & POLLIN))
+            break;
+        if (ready > 0 && count == 2 && (fds[1].revents & POLLIN))
+            serveMetricsClient(e);
+        if (e->file_path != NULL && monotonicMilliseconds() >= next_write)
+        {
+            writeMetricsFile(e);
+            next_write += e->interval * 1000LL;
+        }
+    }
+    return NULL;
+}
+
+// Bind the socket (if any) and start the exporter thread; NULL if the socket
+// cannot be created
+MetricsExporter *startMetricsExporter(const char *scheduler, const char *socket_path, const char *file_path, int interval)
+{
+    MetricsExporter *e = (MetricsExporter *)calloc(1, sizeof(MetricsExporter));
+    atomic_init(&e->sequence, 0);
+    e->scheduler = scheduler;
+    e->socket_path = socket_path;
+    e->file_path = file_path;
+    e->interval = interval;
+    e->listen_fd = -1;
+    clock_gettime(CLOCK_MONOTONIC, &e->start);
+    e->last_event = e->start;
+
+    if (socket_path != NULL)
+    {
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (strlen(socket_path) >= sizeof(address.sun_path))
+        {
+            free(e);
+            return NULL;
+        }
+        strcpy(address.sun_path, socket_path);
+        unlink(socket_path);
+
+        e->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (e->listen_fd < 0 || bind(e->listen_fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+            listen(e->listen_fd, 8) < 0)
+        {
+            if (e->listen_fd >= 0)
+                close(e->listen_fd);
+            free(e);
+            return NULL;
+        }
+    }
+
+    if (pipe(e->wake_pipe) < 0 || pthread_create(&e->thread, NULL, runMetricsExporter, e) != 0)
+    {
+        if (e->listen_fd >= 0)
+        {
+            close(e->listen_fd);
+            unlink(socket_path);
+        }
+        free(e);
+        return NULL;
+    }
+    return e;
+}
+
+// Stop the exporter thread, write the final metrics file and remove the socket
+void stopMetricsExporter()
+{
+    if (exporter == NULL)
+        return;
+
+    char wake = 0;
+    if (write(exporter->wake_pipe[1], &wake, 1) == 1)
+        pthread_join(exporter->thread, NULL);
+    close(exporter->wake_pipe[0]);
+    close(exporter->wake_pipe[1]);
+
+    if (exporter->file_path != NULL)
+        writeMetricsFile(exporter);
+    if (exporter->listen_fd >= 0)
+    {
+        close(exporter->listen_fd);
+        unlink(exporter->socket_path);
+    }
+    free(exporter);
+    exporter = NULL;
+}
+
+// Check whether the processes are sorted by arrival time
+bool arrivalsSorted(Process *processes, int n)
+{
+    ProcessView previous;
+    ProcessView view;
+    for (int i = 1; i < n; i++)
+    {
+        viewProcess(processAt(processes, i - 1), &previous);
+        viewProcess(processAt(processes, i), &view);
+        if (view.arrival_time < previous.arrival_time)
+            return false;
+    }
+    return true;
+}
+
+// Index of the first process arriving after the given time; the processes
+// must be sorted by arrival time
+int firstArrivalAfter(Process *processes, int n, int64_t time)
+{
+    ProcessView view;
+    int low = 0;
+    int high = n;
+    while (low < high)
+    {
+        int mid = low + (high - low) / 2;
+        viewProcess(processAt(processes, mid), &view);
+        if (view.arrival_time <= time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+// Compare trace windows by offered load (used to stratify them)
+int compareWindowLoad(const void *a, const void *b)
+{
+    const TraceWindow *w1 = (const TraceWindow *)a;
+    const TraceWindow *w2 = (const TraceWindow *)b;
+    if (w1->load < w2->load)
+        return -1;
+    if (w1->load > w2->load)
+        return 1;
+    return w1->index - w2->index;
+}
+
+// Two-sided 95% Student t quantile. A sample of a few windows per stratum
+// leaves few degrees of freedom, and the normal quantile would make its
+// confidence intervals too narrow.
+double tQuantile95(int df)
+{
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+    if (df < 1)
+        return INFINITY;
+    if (df <= 30)
+        return table[df - 1];
+    // Cornish-Fisher expansion around the normal quantile
+    return CI95_Z + (CI95_Z * CI95_Z * CI95_Z + CI95_Z) / (4.0 * df);
+}
+
+// Resolve the window boundaries before the end of the busy period [start, end).
+// A window starting inside it needs the period's earlier work as warm-up, and
+// one ending inside it needs the later work until the period ends as cool-down.
+void resolveBoundaries(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length, int64_t start,
+                       int64_t end)
+{
+    while (busy->boundary <= num_windows && busy->boundary * length < end)
+    {
+        int64_t time = busy->boundary * length;
+        bool busy_at = time > start;
+        if (busy->boundary < num_windows)
+            windows[busy->boundary].busy_from = busy_at ? start : time;
+        if (busy->boundary > 0)
+            windows[busy->boundary - 1].idle_at = busy_at ? end : time;
+        busy->boundary++;
+    }
+}
+
+// Queue the work of the next arrival; arrivals must come in arrival order
+void addBusyWork(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length, int64_t arrival,
+                 int64_t burst)
+{
+    if (arrival >= busy->end)
+    {
+        // The queued work ran out before this arrival and a new busy period starts
+        if (busy->end > busy->start)
+            resolveBoundaries(busy, windows, num_windows, length, busy->start, busy->end);
+        busy->start = arrival;
+        busy->end = arrival;
+    }
+    busy->end += burst;
+}
+
+// Resolve the boundaries left after the last arrival
+void finishBusyPeriods(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length)
+{
+    resolveBoundaries(busy, windows, num_windows, length, busy->start, busy->end);
+    resolveBoundaries(busy, windows, num_windows, length, INT64_MAX, INT64_MAX);
+}
+
+// Simulate the arrivals in [from, until) and sum the metrics of the jobs that
+// arrived inside the window [start, end). The warm-up arrivals before the window
+// build up its initial backlog, and the cool-down arrivals after it keep
+// competing for the CPU with its last jobs as they would in the full trace.
+WindowSample simulateWindow(Process *processes, int n, SimulationRun run, void *context, int64_t start, int64_t end,
+                            int64_t from, int64_t until, bool sorted)
+{
+    WindowSample sample;
+    memset(&sample, 0, sizeof(sample));
+
+    // A sorted trace holds the window's processes in one run found by binary
+    // search; otherwise the whole trace is scanned for them
+    ProcessView view;
+    int64_t offset = from;
+    int first = 0;
+    int m = 0;
+    if (sorted)
+    {
+        first = firstArrivalAfter(processes, n, offset - 1);
+        m = firstArrivalAfter(processes, n, until - 1) - first;
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+        {
+            viewProcess(processAt(processes, i), &view);
+            if (view.arrival_time >= offset && view.arrival_time < until)
+                m++;
+        }
+    }
+
+    Process *window = (Process *)malloc(process_size * m);
+    if (window == NULL)
+    {
+        printf("Not enough memory to simulate a window of %d processes\n", m);
+        exit(1);
+    }
+
+    // Copy the window's processes, shifted so the simulation starts at zero
+    int j = 0;
+    for (int i = first; j < m; i++)
+    {
+        viewProcess(processAt(processes, i), &view);
+        if (view.arrival_time >= offset && view.arrival_time < until)
+        {
+            memcpy(processAt(window, j), processAt(processes, i), process_size);
+            shiftProcess(processAt(window, j), offset);
+            j++;
+        }
+    }
+
+    gantt_chart_size = 0;
+    run(window, m, context, NULL);
+
+    // Padding jobs only load the system; they are not part of the sample
+    for (j = 0; j < m; j++)
+    {
+        viewProcess(processAt(window, j), &view);
+        if (view.arrival_time + offset < start || view.arrival_time + offset >= end)
+            continue;
+
+        sample.jobs++;
+        sample.sums[0] += (double)view.turnaround_time / time_unit;
+        sample.sums[1] += (double)view.waiting_time / time_unit;
+        sample.sums[2] += (double)view.response_time / time_unit;
+        sample.sums[3] += view.starved ? 1 : 0;
+    }
+
+    free(window);
+    return sample;
+}
+
+// Approximate the metrics of a long trace by simulating a stratified sample of
+// its time windows. Windows are ranked by offered load and split into strata;
+// a few windows per stratum are simulated with warm-up and cool-down padding,
+// and per-job metrics are extrapolated with a stratified ratio estimator and
+// 95% Student t CIs.
+void runSampling(Process *processes, int n, SimulationRun run, void *context, SamplingParams *sampling)
+{
+    static const char *metric_names[SAMPLE_METRICS] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time",
+        "Starvation Count"};
+
+    ProcessView view;
+    bool sorted = arrivalsSorted(processes, n);
+    int64_t horizon = 1;
+    for (int i = 0; i < n; i++)
+    {
+        viewProcess(processAt(processes, i), &view);
+        if (view.arrival_time + 1 > horizon)
+            horizon = view.arrival_time + 1;
+    }
+
+    int64_t length = (int64_t)sampling->window_length * time_unit;
+    if (length <= 0)
+        length = (horizon + DEFAULT_SAMPLE_WINDOWS - 1) / DEFAULT_SAMPLE_WINDOWS;
+    int64_t warmup = sampling->warmup >= 0 ? (int64_t)sampling->warmup * time_unit : length;
+    bool automatic = sampling->warmup < 0 && sorted;
+    int num_windows = (int)((horizon + length - 1) / length);
+
+    TraceWindow *windows = (TraceWindow *)calloc(num_windows, sizeof(TraceWindow));
+    if (windows == NULL)
+    {
+        printf("Not enough memory for %d sampling windows\n", num_windows);
+        exit(1);
+    }
+
+    for (int w = 0; w < num_windows; w++)
+    {
+        windows[w].index = w;
+    }
+
+    // By default the padding of a window reaches back to the start of the busy
+    // period it starts in and on to the end of the one it ends in
+    BusyPeriods busy = {0, 0, 0};
+    for (int i = 0; i < n; i++)
+    {
+        viewProcess(processAt(processes, i), &view);
+        TraceWindow *window = &windows[view.arrival_time / length];
+        window->jobs++;
+        window->load += (double)view.burst_time / length;
+        if (automatic)
+            addBusyWork(&busy, windows, num_windows, length, view.arrival_time, view.burst_time);
+    }
+    if (automatic)
+        finishBusyPeriods(&busy, windows, num_windows, length);
+
+    // Empty windows hold no jobs to extrapolate, so they are not sampled
+    int active = 0;
+    for (int w = 0; w < num_windows; w++)
+    {
+        if (windows[w].jobs > 0)
+            windows[active++] = windows[w];
+    }
+
+    qsort(windows, active, sizeof(TraceWindow), compareWindowLoad);
+
+    int strata = sampling->strata < active ? sampling->strata : active;
+    if (strata < 1)
+        strata = 1;
+    for (int r = 0; r < active; r++)
+    {
+        windows[r].stratum = r * strata / active;
+    }
+
+    double estimate[SAMPLE_METRICS] = {0};
+    double variance[SAMPLE_METRICS] = {0};
+    int sampled_windows = 0;
+    int sampled_jobs = 0;
+    int degrees_of_freedom = 0;
+
+    srand(sampling->seed);
+    clock_t sample_start = clock();
+
+    int first = 0;
+    for (int h = 0; h < strata; h++)
+    {
+        int count = 0;
+        int stratum_jobs = 0;
+        while (first + count < active && windows[first + count].stratum == h)
+        {
+            stratum_jobs += windows[first + count].jobs;
+            count++;
+        }
+
+        int k = sampling->windows_per_stratum < count ? sampling->windows_per_stratum : count;
+        if (k < 1)
+            k = 1;
+
+        // Partial Fisher-Yates shuffle picks k distinct windows of the stratum
+        for (int s = 0; s < k; s++)
+        {
+            int r = s + rand() % (count - s);
+            TraceWindow temp = windows[first + s];
+            windows[first + s] = windows[first + r];
+            windows[first + r] = temp;
+        }
+
+        WindowSample *samples = (WindowSample *)malloc(sizeof(WindowSample) * k);
+        int stratum_sampled_jobs = 0;
+        for (int s = 0; s < k; s++)
+        {
+            TraceWindow *window = &windows[first + s];
+            int64_t start = window->index * length;
+            int64_t from = automatic ? window->busy_from : (start - warmup > 0 ? start - warmup : 0);
+            int64_t until = automatic ? window->idle_at : start + length + warmup;
+            samples[s] = simulateWindow(processes, n, run, context, start, start + length, from, until, sorted);
+            stratum_sampled_jobs += samples[s].jobs;
+        }
+
+        double weight = (double)stratum_jobs / n;
+        double mean_jobs = (double)stratum_sampled_jobs / k;
+        double fpc = 1.0 - (double)k / count;
+
+        for (int m = 0; m < SAMPLE_METRICS; m++)
+        {
+            double total = 0.0;
+            for (int s = 0; s < k; s++)
+            {
+                total += samples[s].sums[m];
+            }
+
+            double ratio = total / stratum_sampled_jobs;
+            estimate[m] += weight * ratio;
+
+            // Variance of the ratio estimator needs at least two windows
+            if (k > 1)
+            {
+                double residuals = 0.0;
+                for (int s = 0; s < k; s++)
+                {
+                    double residual = samples[s].sums[m] - ratio * samples[s].jobs;
+                    residuals += residual * residual;
+                }
+                double s2 = residuals / (k - 1);
+                variance[m] += weight * weight * fpc * s2 / (k * mean_jobs * mean_jobs);
+            }
+        }
+
+        sampled_windows += k;
+        degrees_of_freedom += k - 1;
+        sampled_jobs += stratum_sampled_jobs;
+        free(samples);
+        first += count;
+    }
+
+    double sample_seconds = (double)(clock() - sample_start) / CLOCKS_PER_SEC;
+
+    double full[SAMPLE_METRICS];
+    double full_seconds = 0.0;
+    if (sampling->compare)
+    {
+        clock_t full_start = clock();
+        gantt_chart_size = 0;
+        run(processes, n, context, full);
+        full_seconds = (double)(clock() - full_start) / CLOCKS_PER_SEC;
+    }
+
+    // Strata sampled with a single window add no degrees of freedom, and
+    // without any the CI is unknown
+    double quantile = tQuantile95(degrees_of_freedom);
+    printf("Metric,Estimate,CI95 Low,CI95 High%s\n", sampling->compare ? ",Full Run,Relative Error,Within CI" : "");
+    for (int m = 0; m < SAMPLE_METRICS; m++)
+    {
+        // Starvation is estimated as a per-job rate and scaled to the trace
+        double scale = (m == 3) ? n : 1.0;
+        double value = estimate[m] * scale;
+        double half_width = quantile * sqrt(variance[m]) * scale;
+
+        if (degrees_of_freedom > 0)
+            printf("%s,%.2f,%.2f,%.2f", metric_names[m], value, value - half_width, value + half_width);
+        else
+            printf("%s,%.2f,NA,NA", metric_names[m], value);
+        if (sampling->compare)
+        {
+            // The full-run value should fall inside the CI in about 95% of samples
+            double error = full[m] != 0.0 ? fabs(value - full[m]) / fabs(full[m]) : fabs(value);
+            const char *within = "NA";
+            if (degrees_of_freedom > 0)
+                within = fabs(full[m] - value) <= half_width + 1e-6 * fabs(full[m]) ? "Yes" : "No";
+            printf(",%.2f,%.2f%%,%s", full[m], error * 100.0, within);
+        }
+        printf("\n");
+    }
+    printf("Sampled Windows,%d/%d\n", sampled_windows, active);
+    printf("Sampled Processes,%d/%d\n", sampled_jobs, n);
+    printf("Sampling Time (s),%.4f\n", sample_seconds);
+    if (sampling->compare)
+    {
+        printf("Full Run Time (s),%.4f\n", full_seconds);
+        printf("Speedup,%.2f\n", full_seconds / fmax(sample_seconds, 1e-6));
+    }
+
+    free(windows);
+}
+
+// Uniform random number in (0, 1)
+double uniformRandom()
+{
+    return (rand() + 1.0) / (RAND_MAX + 2.0);
+}
+
+// Exponentially distributed random number with the given mean
+double exponentialRandom(double mean)
+{
+    return -mean * log(uniformRandom());
+}
+
+// Generate an open-system workload: Poisson arrivals with exponentially
+// distributed bursts, already sorted by arrival time
+int generateSyntheticProcesses(Process **out, SteadyStateParams *params)
+{
+    int n = params->max_jobs;
+    Process *processes = (Process *)malloc(process_size * n);
+    if (processes == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+
+    srand(params->seed);
+    double arrival = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        arrival += exponentialRandom(1.0 / params->arrival_rate);
+
+        int64_t burst = (int64_t)(exponentialRandom(params->mean_burst) + 0.5);
+        if (burst < 1)
+            burst = 1;
+        burst *= time_unit;
+
+        int64_t arrival_time = (int64_t)arrival * time_unit;
+        // Half of the jobs carry a deadline of two to five times their burst
+        int64_t deadline = (rand() % 2) ? arrival_time + burst * (2 + rand() % 4) : 0;
+        int criticality = 1 + rand() % 10;
+        int priority = 1 + rand() % 10;
+        initializeProcess(processAt(processes, i), i + 1, arrival_time, burst, deadline, criticality, 0, priority);
+    }
+
+    *out = processes;
+    return n;
+}
+
+// Map a trace prepared by trace-prep (sorted, validated, densely numbered)
+// and copy it into processes; returns 0 when the file is not one and -1 when
+// it is damaged
+int readPreparedTrace(Process **out, const char *filename)
+{
+    PreparedTrace trace;
+    int status = mapPreparedTrace(filename, &trace);
+    if (status <= 0)
+        return status;
+    if (trace.header->count > INT32_MAX)
+    {
+        printf("Invalid prepared trace: %s\n", filename);
+        unmapPreparedTrace(&trace);
+        return -1;
+    }
+
+    int n = (int)trace.header->count;
+    Process *processes = (Process *)malloc(process_size * n);
+    if (processes == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        unmapPreparedTrace(&trace);
+        return -1;
+    }
+
+    // Times are kept in time units in the file, as in text traces
+    for (int i = 0; i < n; i++)
+    {
+        TraceRecord *record = &trace.records[i];
+        initializeProcess(processAt(processes, i), record->id, record->arrival_time * time_unit,
+                          record->burst_time * time_unit, record->deadline * time_unit, record->criticality,
+                          record->period * time_unit, record->priority);
+    }
+
+    unmapPreparedTrace(&trace);
+    *out = processes;
+    return n;
+}
+
+// Prepare the observation series used for steady-state analysis
+void initializeSteadyState(SteadyState *state, SteadyStateParams *params)
+{
+    memset(state, 0, sizeof(SteadyState));
+    state->params = params;
+    state->capacity = params->max_jobs;
+    for (int m = 0; m < STEADY_STATE_METRICS; m++)
+    {
+        state->values[m] = (double *)malloc(sizeof(double) * state->capacity);
+        if (state->values[m] == NULL)
+        {
+            printf("Not enough memory for %d observations\n", state->capacity);
+            exit(1);
+        }
+    }
+    state->next_check = params->check_interval;
+}
+
+// Release the observation series
+void freeSteadyState(SteadyState *state)
+{
+    for (int m = 0; m < STEADY_STATE_METRICS; m++)
+    {
+        free(state->values[m]);
+    }
+}
+
+// MSER-5 warm-up truncation: average the series in batches of five and pick
+// the truncation point that minimises the standard error of the remaining mean
+int mser5Truncation(double *values, int count)
+{
+    int m = count / MSER_BATCH;
+    if (m < 2)
+        return 0;
+
+    double *z = (double *)malloc(sizeof(double) * m);
+    for (int j = 0; j < m; j++)
+    {
+        double sum = 0.0;
+        for (int k = 0; k < MSER_BATCH; k++)
+        {
+            sum += values[j * MSER_BATCH + k];
+        }
+        z[j] = sum / MSER_BATCH;
+    }
+
+    // Walk backwards so suffix sums give every candidate in O(1)
+    double sum = 0.0;
+    double sum_of_squares = 0.0;
+    double best = INFINITY;
+    int best_d = 0;
+    for (int d = m - 1; d >= 0; d--)
+    {
+        sum += z[d];
+        sum_of_squares += z[d] * z[d];
+
+        // Truncating more than half of the series is not allowed
+        if (d > m / 2)
+            continue;
+
+        double k = m - d;
+        double mser = (sum_of_squares - sum * sum / k) / (k * k);
+        if (mser <= best)
+        {
+            best = mser;
+            best_d = d;
+        }
+    }
+
+    free(z);
+    return best_d * MSER_BATCH;
+}
+
+// Batch-means estimate of the mean of values[start..count) and the half-width
+// of its 95% confidence interval
+void batchMeans(double *values, int start, int count, double *mean, double *half_width)
+{
+    int batch_size = (count - start) / STEADY_STATE_BATCHES;
+    if (batch_size < 1)
+    {
+        *mean = 0.0;
+        *half_width = INFINITY;
+        return;
+    }
+
+    double batch[STEADY_STATE_BATCHES];
+    double total = 0.0;
+    for (int b = 0; b < STEADY_STATE_BATCHES; b++)
+    {
+        double sum = 0.0;
+        for (int k = 0; k < batch_size; k++)
+        {
+            sum += values[start + b * batch_size + k];
+        }
+        batch[b] = sum / batch_size;
+        total += batch[b];
+    }
+
+    *mean = total / STEADY_STATE_BATCHES;
+    double variance = 0.0;
+    for (int b = 0; b < STEADY_STATE_BATCHES; b++)
+    {
+        variance += (batch[b] - *mean) * (batch[b] - *mean);
+    }
+    variance /= STEADY_STATE_BATCHES - 1;
+
+    *half_width = T_QUANTILE_BATCHES * sqrt(variance / STEADY_STATE_BATCHES);
+}
+
+// Truncate the warm-up with MSER-5 (using the longest warm-up of any metric)
+// and check every metric's batch-means confidence interval against the target
+bool evaluateSteadyState(SteadyState *state)
+{
+    state->truncation = 0;
+    for (int m = 0; m < STEADY_STATE_METRICS; m++)
+    {
+        int d = mser5Truncation(state->values[m], state->count);
+        if (d > state->truncation)
+            state->truncation = d;
+    }
+
+    state->converged = true;
+    for (int m = 0; m < STEADY_STATE_METRICS; m++)
+    {
+        batchMeans(state->values[m], state->truncation, state->count, &state->mean[m], &state->half_width[m]);
+        double target = state->params->precision * fabs(state->mean[m]);
+        if (target < state->params->abs_precision)
+            target = state->params->abs_precision;
+        if (state->half_width[m] > target)
+            state->converged = false;
+    }
+
+    return state->converged;
+}
+
+// Record the metrics of a completed process and apply the stopping rule.
+// Returns true once every tracked metric's confidence interval is tight enough.
+bool recordObservation(SteadyState *state, Process *process, int64_t current_time)
+{
+    if (state->count == state->capacity)
+        return true;
+
+    ProcessView view;
+    viewProcess(process, &view);
+    state->values[0][state->count] = (double)view.turnaround_time / time_unit;
+    state->values[1][state->count] = (double)view.waiting_time / time_unit;
+    state->values[2][state->count] = (double)view.response_time / time_unit;
+    state->count++;
+    state->stop_time = current_time;
+
+    // Checks are spaced geometrically so the analysis stays linear overall
+    if (state->count < state->next_check)
+        return false;
+    int step = state->count / 10;
+    state->next_check = state->count + (step > state->params->check_interval ? step : state->params->check_interval);
+
+    return evaluateSteadyState(state);
+}
+
+// Write the steady-state estimates as CSV
+void displaySteadyState(SteadyState *state)
+{
+    static const char *metric_names[STEADY_STATE_METRICS] = {
+        "Average Turnaround Time",
+        "Average Waiting Time",
+        "Average Response Time"};
+
+    printf("Metric,Steady-State Mean,CI95 Low,CI95 High\n");
+    for (int m = 0; m < STEADY_STATE_METRICS; m++)
+    {
+        printf("%s,%.2f,%.2f,%.2f\n", metric_names[m], state->mean[m],
+               state->mean[m] - state->half_width[m], state->mean[m] + state->half_width[m]);
+    }
+    printf("Converged,%s\n", state->converged ? "Yes" : "No");
+    printf("Warm-up Truncated,%d\n", state->truncation);
+    printf("Completed Processes,%d\n", state->count);
+    printf("Simulated Time,%lld\n", (long long)(state->stop_time / time_unit));
+}
+// CPU time available to processes in [0, time): every tick window
+// [k * period, k * period + overhead) is taken by the interrupt handler
+int64_t tickUsefulTime(TickModel *model, int64_t time)
+{
+    int64_t k = time / model->period;
+    int64_t into_period = time - k * model->period - model->overhead;
+    return k * (model->period - model->overhead) + (into_period > 0 ? into_period : 0);
+}
+
+
+// Earliest time at which work ns of CPU time starting at start are done
+int64_t tickWorkEnd(TickModel *model, int64_t start, int64_t work)
+{
+    int64_t useful = tickUsefulTime(model, start) + work;
+    int64_t per_period = model->period - model->overhead;
+    int64_t k = useful / per_period;
+    int64_t rest = useful - k * per_period;
+    return k * model->period + (rest > 0 ? model->overhead + rest : 0);
+}
+
+
+// Run a process from start under the tick model. Its slice expires at the
+// first tick after it has received slice ns of CPU time, unless it finishes
+// its remaining work first. Returns the end time and the work done.
+int64_t tickedExecution(TickModel *model, int64_t start, int64_t slice, int64_t remaining, int64_t *work)
+{
+    int64_t slice_end = tickWorkEnd(model, start, slice);
+    int64_t preempt_at = (slice_end + model->period - 1) / model->period * model->period;
+    int64_t available = tickUsefulTime(model, preempt_at) - tickUsefulTime(model, start);
+
+    int64_t end = preempt_at;
+    *work = available;
+    if (remaining <= available)
+    {
+        end = tickWorkEnd(model, start, remaining);
+        *work = remaining;
+    }
+
+    model->busy_ticks += (end + model->period - 1) / model->period - (start + model->period - 1) / model->period;
+    model->stolen_time += end - start - *work;
+    return end;
+}
+
+
+// Write the tick statistics of the last run as CSV rows
+void displayTickStats(TickModel *model)
+{
+    int64_t ticks = (model->end_time + model->period - 1) / model->period;
+    printf("Tick Rate (HZ),%lld\n", (long long)model->hz);
+    printf("Ticks,%lld\n", (long long)ticks);
+    printf("Idle Ticks (avoided by NO_HZ),%lld\n", (long long)(ticks - model->busy_ticks));
+    printf("Tick Overhead (%%),%.4f\n",
+           model->end_time > 0 ? 100.0 * model->stolen_time / model->end_time : 0.0);
+}
+
+// Clear the idle statistics and the governor's prediction before a run
+void resetIdleModel(IdleModel *model)
+{
+    for (int s = 0; s < model->count; s++)
+    {
+        model->states[s].entries = 0;
+        model->states[s].residency = 0;
+    }
+    model->predicted_idle = 0.0;
+    model->wakeups = 0;
+    model->premature = 0;
+    model->exit_latency = 0;
+}
+
+// Parse "name:exit_ns:residency_ns[:power_mw],..." ordered from shallowest to
+// deepest. Returns the number of states, or -1 if the list is malformed.
+int parseIdleStates(IdleModel *model, const char *spec)
+{
+    model->count = 0;
+    while (*spec != '\0')
+    {
+        if (model->count == MAX_IDLE_STATES)
+            return -1;
+
+        IdleState *state = &model->states[model->count];
+        long long exit_latency, residency;
+        int used = 0;
+        memset(state, 0, sizeof(*state));
+        if (sscanf(spec, "%15[^:,]:%lld:%lld%n:%lf%n", state->name, &exit_latency, &residency,
+                   &used, &state->power, &used) < 3)
+            return -1;
+        state->exit_latency = exit_latency;
+        state->target_residency = residency;
+        if (exit_latency < 0 || residency < 0 || state->power < 0 ||
+            (model->count > 0 && exit_latency < model->states[model->count - 1].exit_latency))
+            return -1;
+        model->count++;
+
+        spec += used;
+        if (*spec == ',')
+            spec++;
+        else if (*spec != '\0')
+            return -1;
+    }
+    return model->count;
+}
+
+// Map a governor name to its IdleGovernor, or -1 if unknown
+int parseIdleGovernor(const char *name)
+{
+    static const char *names[] = {"menu", "oracle", "shallowest", "deepest"};
+    for (int g = 0; g < (int)(sizeof(names) / sizeof(names[0])); g++)
+    {
+        if (strcmp(name, names[g]) == 0)
+            return g;
+    }
+    return -1;
+}
+
+// The CPU is idle for idle ns: let the governor pick a state, account for
+// it, and return the exit latency the next dispatch has to wait for
+int64_t enterIdleState(IdleModel *model, int64_t idle)
+{
+    double expected = model->governor == IDLE_GOVERNOR_ORACLE ? (double)idle : model->predicted_idle;
+    int chosen = 0;
+    for (int s = 1; s < model->count && model->governor != IDLE_GOVERNOR_SHALLOWEST; s++)
+    {
+        if (model->latency_limit >= 0 && model->states[s].exit_latency > model->latency_limit)
+            break;
+        if (model->governor != IDLE_GOVERNOR_DEEPEST && model->states[s].target_residency > expected)
+            break;
+        chosen = s;
+    }
+
+    // The menu governor predicts the next idle period from the previous ones
+    if (model->wakeups == 0)
+        model->predicted_idle = idle;
+    else
+        model->predicted_idle += IDLE_PREDICTION_WEIGHT * (idle - model->predicted_idle);
+
+    IdleState *state = &model->states[chosen];
+    state->entries++;
+    state->residency += idle + state->exit_latency;
+    model->wakeups++;
+    if (idle < state->target_residency)
+        model->premature++;
+    model->exit_latency += state->exit_latency;
+    return state->exit_latency;
+}
+
+// Write the idle state statistics of the last run as CSV rows
+void displayIdleStats(IdleModel *model)
+{
+    static const char *governor_names[] = {"menu", "oracle", "shallowest", "deepest"};
+    int64_t idle_time = 0;
+    double energy = 0.0; // mJ
+    for (int s = 0; s < model->count; s++)
+    {
+        idle_time += model->states[s].residency;
+        energy += model->states[s].power * model->states[s].residency / 1e9;
+    }
+
+    printf("Idle Governor,%s\n", governor_names[model->governor]);
+    for (int s = 0; s < model->count; s++)
+    {
+        printf("%s Entries,%lld\n", model->states[s].name, model->states[s].entries);
+        printf("%s Residency (%%),%.2f\n", model->states[s].name,
+               idle_time > 0 ? 100.0 * model->states[s].residency / idle_time : 0.0);
+    }
+    printf("Idle Wakeups,%lld\n", model->wakeups);
+    printf("Premature Wakeups,%lld\n", model->premature);
+    printf("Average Exit Latency (ns),%.2f\n",
+           model->wakeups > 0 ? (double)model->exit_latency / model->wakeups : 0.0);
+    printf("Idle Energy (mJ),%.4f\n", energy);
+    printf("Average Idle Power (mW),%.2f\n", idle_time > 0 ? energy * 1e9 / idle_time : 0.0);
+}
+
+// Clear the admission state before a run over n processes
+void resetAdmission(AdmissionControl *ac, int n)
+{
+    free(ac->deferred);
+    ac->deferred = (Process **)malloc(sizeof(Process *) * (n > 0 ? n : 1));
+    if (ac->deferred == NULL)
+    {
+        printf("Not enough memory for %d deferred processes\n", n);
+        exit(1);
+    }
+    ac->backlog = 0;
+    ac->deferred_head = 0;
+    ac->deferred_tail = 0;
+    ac->rejected = 0;
+    ac->admitted = 0;
+    ac->deferrals = 0;
+    ac->released = 0;
+    ac->rejected_load = 0;
+    ac->rejected_deadline = 0;
+    ac->rejected_timeout = 0;
+    ac->deferral_time = 0;
+}
+
+// Decide whether a process may enter a ready queue of queue_length at time now.
+// The deadline test is conservative: the whole backlog is assumed to run first.
+AdmissionDecision admissionCheck(AdmissionControl *ac, ProcessView *view, int64_t now, int queue_length)
+{
+    if (ac->deadline_check && view->deadline > 0 && now + ac->backlog + view->work > view->deadline)
+        return ADMISSION_REJECT_DEADLINE;
+    if (ac->max_utilization > 0 && ac->backlog + view->work > ac->max_utilization * ac->horizon)
+        return ADMISSION_REJECT_LOAD;
+    if (ac->max_queue > 0 && queue_length >= ac->max_queue)
+        return ADMISSION_DEFER;
+    return ADMISSION_ADMIT;
+}
+
+// Shed a process: it never runs and is left out of the scheduling metrics
+void shedProcess(AdmissionControl *ac, Process *process, AdmissionDecision reason)
+{
+    markShed(process);
+    ac->rejected++;
+    if (reason == ADMISSION_REJECT_LOAD)
+        ac->rejected_load++;
+    else if (reason == ADMISSION_REJECT_DEADLINE)
+        ac->rejected_deadline++;
+    else
+        ac->rejected_timeout++;
+}
+
+// Run an arriving process past admission control. Returns whether it may be
+// queued now; otherwise it has been deferred or shed.
+bool admitArrival(AdmissionControl *ac, Process *process, int64_t now, int queue_length)
+{
+    ProcessView view;
+    viewProcess(process, &view);
+    AdmissionDecision decision = admissionCheck(ac, &view, now, queue_length);
+    if (decision == ADMISSION_ADMIT)
+    {
+        ac->backlog += view.work;
+        ac->admitted++;
+        return true;
+    }
+    if (decision == ADMISSION_DEFER)
+    {
+        ac->deferred[ac->deferred_tail++] = process;
+        ac->deferrals++;
+        return false;
+    }
+    shedProcess(ac, process, decision);
+    return false;
+}
+
+// Admit the oldest deferred process once the ready queue has room again.
+// Deferred processes that waited too long or no longer pass are shed.
+Process *releaseDeferred(AdmissionControl *ac, int64_t now, int queue_length)
+{
+    while (ac->deferred_head < ac->deferred_tail)
+    {
+        Process *process = ac->deferred[ac->deferred_head];
+        ProcessView view;
+        viewProcess(process, &view);
+        if (ac->max_deferral > 0 && now - view.arrival_time > ac->max_deferral)
+        {
+            ac->deferred_head++;
+            shedProcess(ac, process, ADMISSION_DEFER);
+            continue;
+        }
+        if (ac->max_queue > 0 && queue_length >= ac->max_queue)
+            return NULL;
+
+        ac->deferred_head++;
+        AdmissionDecision decision = admissionCheck(ac, &view, now, queue_length);
+        if (decision != ADMISSION_ADMIT)
+        {
+            shedProcess(ac, process, decision);
+            continue;
+        }
+        ac->backlog += view.work;
+        ac->admitted++;
+        ac->released++;
+        ac->deferral_time += now - view.arrival_time;
+        return process;
+    }
+    return NULL;
+}
+
+// Processes the metrics are computed over: all of them, or a compacted copy
+// without the shed ones (freed by the caller) when admission control shed any
+Process *admittedProcesses(Process *processes, int n, int *admitted)
+{
+    *admitted = n;
+    if (admission == NULL || admission->rejected == 0)
+        return processes;
+
+    Process *kept = (Process *)malloc(process_size * n);
+    if (kept == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+    *admitted = 0;
+    for (int i = 0; i < n; i++)
+    {
+        ProcessView view;
+        viewProcess(processAt(processes, i), &view);
+        if (!view.shed)
+            memcpy(processAt(kept, (*admitted)++), processAt(processes, i), process_size);
+    }
+    return kept;
+}
+
+// Compare two int64_t values for qsort
+int compareInt64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile q (0-100) of count values; sorts them in place
+int64_t nearestRankPercentile(int64_t *values, int count, double q)
+{
+    if (count == 0)
+        return 0;
+    qsort(values, count, sizeof(int64_t), compareInt64);
+    int rank = (int)ceil(q / 100.0 * count);
+    return values[rank > 0 ? rank - 1 : 0];
+}
+
+// Write the admission statistics and the tail latency of admitted work as CSV rows
+void displayAdmissionStats(AdmissionControl *ac, Process *processes, int n)
+{
+    int64_t *response = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    int64_t *turnaround = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    if (response == NULL || turnaround == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+    int count = 0;
+    int misses = 0;
+    for (int i = 0; i < n; i++)
+    {
+        ProcessView view;
+        viewProcess(processAt(processes, i), &view);
+        if (view.shed || !view.completed)
+            continue;
+        response[count] = view.response_time;
+        turnaround[count] = view.turnaround_time;
+        count++;
+        if (view.deadline > 0 && view.completion_time > view.deadline)
+            misses++;
+    }
+
+    printf("Admitted Processes,%lld\n", ac->admitted);
+    printf("Deferred Processes,%lld\n", ac->deferrals);
+    printf("Average Deferral,%.2f\n",
+           ac->released > 0 ? (double)ac->deferral_time / ac->released / time_unit : 0.0);
+    printf("Rejected (Utilization),%lld\n", ac->rejected_load);
+    printf("Rejected (Deadline),%lld\n", ac->rejected_deadline);
+    printf("Rejected (Deferral Timeout),%lld\n", ac->rejected_timeout);
+    printf("Admitted Deadline Misses,%d\n", misses);
+    printf("Admitted P99 Response Time,%.2f\n", (double)nearestRankPercentile(response, count, 99.0) / time_unit);
+    printf("Admitted P99 Turnaround Time,%.2f\n", (double)nearestRankPercentile(turnaround, count, 99.0) / time_unit);
+
+    free(response);
+    free(turnaround);
+}
+
+// Standard normal random number (Box-Muller)
+double normalRandom()
+{
+    return sqrt(-2.0 * log(uniformRandom())) * cos(2.0 * M_PI * uniformRandom());
+}
+
+// Parse an actual burst distribution: "exact", "exponential" or "lognormal[:sigma]".
+// Returns the BurstDistribution, or -1 if the spec is malformed.
+int parseBurstDistribution(const char *spec, double *sigma)
+{
+    if (strcmp(spec, "exact") == 0)
+        return BURSTS_EXACT;
+    if (strcmp(spec, "exponential") == 0)
+        return BURSTS_EXPONENTIAL;
+    if (strcmp(spec, "lognormal") == 0 || (sscanf(spec, "lognormal:%lf", sigma) == 1 && *sigma >= 0))
+        return BURSTS_LOGNORMAL;
+    return -1;
+}
+
+// Draw an actual burst around the trace's burst, which is kept as the
+// estimate. sigma is the lognormal shape parameter.
+int64_t drawActualBurst(BurstDistribution distribution, double sigma, int64_t estimate)
+{
+    double actual = (double)estimate;
+    if (distribution == BURSTS_LOGNORMAL)
+        actual = estimate * exp(sigma * normalRandom() - sigma * sigma / 2.0);
+    else if (distribution == BURSTS_EXPONENTIAL)
+        actual = exponentialRandom(estimate);
+    return actual < 1.0 ? 1 : (int64_t)llround(actual);
+}
+
+// Map a predictor name to its PredictorKind, or -1 if unknown
+int parsePredictor(const char *name)
+{
+    static const char *names[] = {"oracle", "estimate", "ewma", "class"};
+    for (int k = 0; k < (int)(sizeof(names) / sizeof(names[0])); k++)
+    {
+        if (strcmp(name, names[k]) == 0)
+            return k;
+    }
+    return -1;
+}
+
+// Clear what the predictor has learned before a run
+void resetPredictor(BurstPredictor *predictor)
+{
+    predictor->ratio = 1.0;
+    for (int c = 0; c < PREDICTOR_CLASSES; c++)
+    {
+        predictor->class_mean[c] = 0.0;
+        predictor->class_seen[c] = false;
+    }
+    predictor->predictions = 0;
+    predictor->underestimates = 0;
+    predictor->abs_error = 0.0;
+    predictor->rel_error = 0.0;
+}
+
+// Predictor class of a criticality for the per-class predictor
+int predictorClass(int criticality)
+{
+    if (criticality < 0)
+        return 0;
+    return criticality < PREDICTOR_CLASSES ? criticality : PREDICTOR_CLASSES - 1;
+}
+
+// Predict the burst of an arriving process from its estimate and account the
+// error against its actual burst
+int64_t predictBurst(BurstPredictor *predictor, int64_t estimate, int64_t actual, int criticality)
+{
+    double prediction = (double)estimate;
+    if (predictor->kind == PREDICT_ORACLE)
+        prediction = (double)actual;
+    else if (predictor->kind == PREDICT_EWMA)
+        prediction = estimate * predictor->ratio;
+    else if (predictor->kind == PREDICT_CLASS && predictor->class_seen[predictorClass(criticality)])
+        prediction = predictor->class_mean[predictorClass(criticality)];
+    int64_t predicted = prediction < 1.0 ? 1 : (int64_t)llround(prediction);
+
+    double error = (double)(predicted - actual);
+    predictor->predictions++;
+    predictor->abs_error += fabs(error);
+    predictor->rel_error += fabs(error) / actual;
+    if (error < 0)
+        predictor->underestimates++;
+    return predicted;
+}
+
+// Learn from the actual burst of a completed process
+void learnBurst(BurstPredictor *predictor, int64_t estimate, int64_t actual, int criticality)
+{
+    double ratio = (double)actual / estimate;
+    predictor->ratio += predictor->alpha * (ratio - predictor->ratio);
+
+    int c = predictorClass(criticality);
+    if (predictor->class_seen[c])
+        predictor->class_mean[c] += predictor->alpha * (actual - predictor->class_mean[c]);
+    else
+        predictor->class_mean[c] = (double)actual;
+    predictor->class_seen[c] = true;
+}
+
+// Write the prediction accuracy of the last run as CSV rows
+void displayPredictorStats(BurstPredictor *predictor)
+{
+    static const char *names[] = {"oracle", "estimate", "ewma", "class"};
+    long long count = predictor->predictions > 0 ? predictor->predictions : 1;
+    printf("Burst Predictor,%s\n", names[predictor->kind]);
+    printf("Predictions,%lld\n", predictor->predictions);
+    printf("Mean Absolute Prediction Error,%.2f\n", predictor->abs_error / count / time_unit);
+    printf("Mean Relative Prediction Error (%%),%.2f\n", 100.0 * predictor->rel_error / count);
+    printf("Underestimates (%%),%.2f\n", 100.0 * predictor->underestimates / count);
+}
+
+// Uniform random number in (0, 1) from the interrupt source's own generator
+double interruptRandom(InterruptModel *model)
+{
+    model->rng ^= model->rng >> 12;
+    model->rng ^= model->rng << 25;
+    model->rng ^= model->rng >> 27;
+    return (((model->rng * 2685821657736338717ULL) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+// Schedule the next interrupt: the rest of the current burst arrives at once,
+// and bursts of geometrically distributed size are spaced exponentially
+void nextInterrupt(InterruptModel *model)
+{
+    if (model->pending > 0)
+    {
+        model->pending--;
+        return;
+    }
+
+    model->next_arrival += (int64_t)(-model->interval * model->burst * log(interruptRandom(model)));
+    if (model->burst > 1.0)
+        model->pending = (int)(log(interruptRandom(model)) / log(1.0 - 1.0 / model->burst));
+}
+
+// Start the interrupt source over for a new run
+void resetInterrupts(InterruptModel *model)
+{
+    model->rng = model->seed * 0x9E3779B97F4A7C15ULL + 1;
+    model->next_arrival = 0;
+    model->pending = 0;
+    model->busy_until = 0;
+    model->count = 0;
+    model->stolen = 0;
+    nextInterrupt(model);
+}
+
+// A process runs from start and would finish its slice at end without
+// interrupts. Every interrupt arriving before the slice ends preempts it for
+// its handlers' service time. Returns the end of the slice.
+int64_t interruptedExecution(InterruptModel *model, int64_t start, int64_t end)
+{
+    int64_t service = model->hardirq + model->softirq;
+    while (model->next_arrival < end)
+    {
+        end += service;
+        model->stolen += service;
+        model->count++;
+        nextInterrupt(model);
+    }
+    model->busy_until = end > start ? end : start;
+    return end;
+}
+
+// Handle the interrupts of an idle period ending at idle_end, when a process
+// becomes ready. Returns how long interrupt work still in progress delays it.
+int64_t interruptIdleDelay(InterruptModel *model, int64_t idle_end)
+{
+    int64_t service = model->hardirq + model->softirq;
+    while (model->next_arrival < (model->busy_until > idle_end ? model->busy_until : idle_end))
+    {
+        int64_t begin = model->busy_until > model->next_arrival ? model->busy_until : model->next_arrival;
+        model->busy_until = begin + service;
+        model->count++;
+        nextInterrupt(model);
+    }
+
+    int64_t delay = model->busy_until > idle_end ? model->busy_until - idle_end : 0;
+    model->stolen += delay;
+    return delay;
+}
+
+// Mean response time, its standard deviation (jitter), its p99 and the
+// number of deadline misses of the completed processes, in time units
+void summarizeResponses(Process *processes, int n, double summary[4])
+{
+    int64_t *response = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    if (response == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+
+    int count = 0;
+    int misses = 0;
+    double sum = 0.0;
+    double sum_of_squares = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        ProcessView view;
+        viewProcess(processAt(processes, i), &view);
+        if (view.shed || !view.completed)
+            continue;
+        response[count] = view.response_time;
+        sum += response[count];
+        sum_of_squares += (double)response[count] * response[count];
+        count++;
+        if (view.deadline > 0 && view.completion_time > view.deadline)
+            misses++;
+    }
+
+    double mean = count > 0 ? sum / count : 0.0;
+    double variance = count > 0 ? sum_of_squares / count - mean * mean : 0.0;
+    summary[0] = mean / time_unit;
+    summary[1] = sqrt(variance > 0.0 ? variance : 0.0) / time_unit;
+    summary[2] = (double)nearestRankPercentile(response, count, 99.0) / time_unit;
+    summary[3] = misses;
+
+    free(response);
+}
+
+// Write the interrupt load of the last run as CSV rows
+void displayInterruptLoad(InterruptModel *model)
+{
+    double elapsed = model->end_time > 0 ? (double)model->end_time : 1.0;
+    printf("Interrupts,%lld\n", model->count);
+    printf("Hardirq Time (%%),%.4f\n", 100.0 * model->count * model->hardirq / elapsed);
+    printf("Softirq Time (%%),%.4f\n", 100.0 * model->count * model->softirq / elapsed);
+    printf("Time Stolen From Processes,%.2f\n", (double)model->stolen / time_unit);
+}
+
+// Write the interrupt load and the response time jitter and deadline misses as CSV rows
+void displayInterruptStats(InterruptModel *model, Process *processes, int n)
+{
+    double summary[4];
+    summarizeResponses(processes, n, summary);
+    displayInterruptLoad(model);
+    printf("Response Time Jitter,%.2f\n", summary[1]);
+    printf("P99 Response Time,%.2f\n", summary[2]);
+    printf("Deadline Misses,%.0f\n", summary[3]);
+}
+
+
+// The calling guest thread asks its vCPU to execute, halt or exit and blocks
+// until the host has served the request
+int64_t hostRequest(HostModel *model, VcpuRequest request, int64_t argument)
+{
+    HostVcpu *vcpu = &model->vcpus[host_guest];
+    pthread_mutex_lock(&model->lock);
+    vcpu->request = request;
+    vcpu->argument = argument;
+    model->turn = HOST_TURN;
+    pthread_cond_signal(&model->host_resumed);
+    while (request != VCPU_EXIT && model->turn != host_guest)
+        pthread_cond_wait(&vcpu->resumed, &model->lock);
+    int64_t reply = vcpu->reply;
+    pthread_mutex_unlock(&model->lock);
+    return reply;
+}
+
+// Guest CPU time between start and end runs only while the vCPU holds a
+// pCPU; returns when that work has finished
+int64_t hostExecution(HostModel *model, int64_t start, int64_t end)
+{
+    if (end <= start)
+        return start;
+    return hostRequest(model, VCPU_EXECUTE, end - start);
+}
+
+// The guest halts its vCPU from idle_start until idle_end. Returns how long
+// the woken vCPU then waits for a pCPU.
+int64_t hostWakeDelay(HostModel *model, int64_t idle_start, int64_t idle_end)
+{
+    (void)idle_start;
+    return hostRequest(model, VCPU_HALT, idle_end);
+}
+
+// Hand the turn to a guest's thread with the answer to its request and take
+// its next request once it blocks again
+void resumeGuest(HostModel *model, HostVcpu *vcpu, int64_t reply)
+{
+    pthread_mutex_lock(&model->lock);
+    vcpu->reply = reply;
+    model->turn = (int)(vcpu - model->vcpus);
+    pthread_cond_signal(&vcpu->resumed);
+    while (model->turn != HOST_TURN)
+        pthread_cond_wait(&model->host_resumed, &model->lock);
+    pthread_mutex_unlock(&model->lock);
+    applyRequest(model, vcpu);
+}
+
+// Put a vCPU at the tail of the run queue
+void enqueueVcpu(HostModel *model, HostVcpu *vcpu, int64_t time)
+{
+    vcpu->state = VCPU_RUNNABLE;
+    vcpu->pcpu = -1;
+    vcpu->queued_at = time;
+    vcpu->sequence = model->sequence++;
+}
+
+void applyRequest(HostModel *model, HostVcpu *vcpu)
+{
+    if (vcpu->request == VCPU_EXECUTE)
+    {
+        vcpu->work = vcpu->argument;
+        // A guest starts on the run queue
+        if (vcpu->state != VCPU_RUNNING)
+            enqueueVcpu(model, vcpu, model->now);
+        return;
+    }
+
+    if (vcpu->state == VCPU_RUNNING)
+        model->running[vcpu->pcpu] = NULL;
+    vcpu->pcpu = -1;
+    vcpu->work = 0;
+    if (vcpu->request == VCPU_HALT)
+    {
+        vcpu->state = VCPU_HALTED;
+    }
+    else
+    {
+        vcpu->state = VCPU_EXITED;
+        model->active_guests--;
+    }
+}
+
+// Credit: one timeslice. CFS: the vCPU's weighted part of the period, which
+// stretches to the minimum granularity per runnable vCPU of a pCPU.
+int64_t hostTimeslice(HostModel *model, HostVcpu *vcpu)
+{
+    if (model->policy == HOST_CREDIT)
+        return model->slice;
+
+    int runnable = 0;
+    int64_t total_weight = 0;
+    for (int v = 0; v < model->count; v++)
+    {
+        if (model->vcpus[v].state == VCPU_RUNNABLE || model->vcpus[v].state == VCPU_RUNNING)
+        {
+            runnable++;
+            total_weight += model->vcpus[v].weight;
+        }
+    }
+    int64_t granularity = model->slice / CFS_HOST_GRANULARITY;
+    int64_t per_pcpu = (runnable + model->pcpus - 1) / model->pcpus;
+    int64_t period = per_pcpu > CFS_HOST_GRANULARITY ? per_pcpu * granularity : model->slice;
+    int64_t slice = total_weight > 0 ? period * model->pcpus * vcpu->weight / total_weight : period;
+    if (slice > period)
+        slice = period;
+    if (slice < granularity)
+        slice = granularity;
+    return slice > 0 ? slice : 1;
+}
+
+// Whether the host picks a before b: credit by priority, CFS by vruntime,
+// and in queue order between equals
+bool ranksBefore(HostModel *model, HostVcpu *a, HostVcpu *b)
+{
+    if (model->policy == HOST_CREDIT && a->priority != b->priority)
+        return a->priority < b->priority;
+    if (model->policy == HOST_CFS && a->vruntime != b->vruntime)
+        return a->vruntime < b->vruntime;
+    return a->sequence < b->sequence;
+}
+
+// Head of the run queue. A host has a handful of vCPUs, so a scan finds it.
+HostVcpu *nextRunnable(HostModel *model)
+{
+    HostVcpu *next = NULL;
+    for (int v = 0; v < model->count; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        if (vcpu->state == VCPU_RUNNABLE && (next == NULL || ranksBefore(model, vcpu, next)))
+            next = vcpu;
+    }
+    return next;
+}
+
+// pCPU of the running vCPU the host would pick last, -1 when a pCPU is idle
+int lastRunning(HostModel *model)
+{
+    int last = -1;
+    for (int p = 0; p < model->pcpus; p++)
+    {
+        if (model->running[p] == NULL)
+            return -1;
+        if (last < 0 || ranksBefore(model, model->running[last], model->running[p]))
+            last = p;
+    }
+    return last;
+}
+
+void dispatchVcpu(HostModel *model, HostVcpu *vcpu, int pcpu)
+{
+    int64_t waited = model->now - vcpu->queued_at;
+    vcpu->steal += waited;
+    if (vcpu->request == VCPU_HALT)
+        vcpu->wake_steal += waited;
+    vcpu->state = VCPU_RUNNING;
+    vcpu->pcpu = pcpu;
+    vcpu->active = true;
+    model->running[pcpu] = vcpu;
+    vcpu->slice_end = model->now + hostTimeslice(model, vcpu);
+}
+
+void preemptVcpu(HostModel *model, HostVcpu *vcpu)
+{
+    model->running[vcpu->pcpu] = NULL;
+    vcpu->preemptions++;
+    enqueueVcpu(model, vcpu, model->now);
+}
+
+// A halted vCPU becomes runnable. Credit boosts it while it has credit left;
+// CFS places it at most half a period behind min_vruntime. Either may then
+// preempt the running vCPU the host would pick last.
+void wakeVcpu(HostModel *model, HostVcpu *vcpu)
+{
+    bool preempts;
+    int last = lastRunning(model);
+    if (model->policy == HOST_CREDIT)
+    {
+        if (vcpu->priority == CREDIT_UNDER)
+            vcpu->priority = CREDIT_BOOST;
+        preempts = last >= 0 && vcpu->priority < model->running[last]->priority;
+    }
+    else
+    {
+        if (vcpu->vruntime < model->min_vruntime - model->slice / 2)
+            vcpu->vruntime = model->min_vruntime - model->slice / 2;
+        preempts = last >= 0 &&
+                   vcpu->vruntime + model->slice / CFS_HOST_GRANULARITY < model->running[last]->vruntime;
+    }
+    enqueueVcpu(model, vcpu, vcpu->argument);
+    if (preempts)
+    {
+        preemptVcpu(model, model->running[last]);
+        dispatchVcpu(model, vcpu, last);
+    }
+}
+
+// Every timeslice the pCPUs' time is handed out as credit by weight among the
+// vCPUs active since the last accounting. Credit is capped at one timeslice
+// either way, so an idle vCPU cannot bank it.
+void accountCredit(HostModel *model)
+{
+    int64_t total_weight = 0;
+    for (int v = 0; v < model->count; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        if (vcpu->state == VCPU_RUNNABLE || vcpu->state == VCPU_RUNNING)
+            vcpu->active = true;
+        if (vcpu->active)
+            total_weight += vcpu->weight;
+    }
+
+    for (int v = 0; v < model->count; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        if (vcpu->active)
+        {
+            vcpu->credit += model->pcpus * model->slice * vcpu->weight / total_weight;
+            vcpu->active = vcpu->state == VCPU_RUNNABLE || vcpu->state == VCPU_RUNNING;
+        }
+        if (vcpu->credit > model->slice)
+            vcpu->credit = model->slice;
+        if (vcpu->credit < -model->slice)
+            vcpu->credit = -model->slice;
+        if (vcpu->priority != CREDIT_BOOST || vcpu->credit <= 0)
+            vcpu->priority = vcpu->credit > 0 ? CREDIT_UNDER : CREDIT_OVER;
+    }
+}
+
+// Serve everything due at the current time; returns whether anything changed,
+// as each change may make more work due
+bool settleHost(HostModel *model)
+{
+    bool changed = false;
+
+    // Guests whose request finished on a pCPU get control back
+    for (int p = 0; p < model->pcpus; p++)
+    {
+        HostVcpu *vcpu = model->running[p];
+        if (vcpu != NULL && !vcpu->tenant && vcpu->work == 0)
+        {
+            resumeGuest(model, vcpu, vcpu->request == VCPU_HALT ? model->now - vcpu->argument : model->now);
+            changed = true;
+        }
+    }
+
+    for (int v = 0; v < model->guests; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        if (vcpu->state == VCPU_HALTED && vcpu->argument <= model->now)
+        {
+            wakeVcpu(model, vcpu);
+            changed = true;
+        }
+    }
+
+    // At the end of a slice the head of the run queue takes over if it ranks
+    // at least level with the running vCPU (credit) or has run less (CFS)
+    for (int p = 0; p < model->pcpus; p++)
+    {
+        HostVcpu *vcpu = model->running[p];
+        if (vcpu == NULL || vcpu->slice_end > model->now)
+            continue;
+        HostVcpu *next = nextRunnable(model);
+        if (next != NULL && (model->policy == HOST_CREDIT ? next->priority <= vcpu->priority
+                                                          : next->vruntime < vcpu->vruntime))
+        {
+            preemptVcpu(model, vcpu);
+            dispatchVcpu(model, next, p);
+            changed = true;
+        }
+        else
+        {
+            vcpu->slice_end = model->now + hostTimeslice(model, vcpu);
+        }
+    }
+
+    // Credit ticks end boosts, and accounting may leave a running vCPU
+    // ranked behind a queued one
+    if (model->policy == HOST_CREDIT && model->next_tick <= model->now)
+    {
+        while (model->next_tick <= model->now)
+        {
+            for (int p = 0; p < model->pcpus; p++)
+            {
+                if (model->running[p] != NULL && model->running[p]->priority == CREDIT_BOOST)
+                    model->running[p]->priority = CREDIT_UNDER;
+            }
+            if (++model->ticks == CREDIT_TICKS_PER_SLICE)
+            {
+                accountCredit(model);
+                model->ticks = 0;
+            }
+            model->next_tick += model->slice / CREDIT_TICKS_PER_SLICE > 0 ? model->slice / CREDIT_TICKS_PER_SLICE : 1;
+        }
+        HostVcpu *next;
+        int last;
+        while ((next = nextRunnable(model)) != NULL && (last = lastRunning(model)) >= 0 &&
+               next->priority < model->running[last]->priority)
+        {
+            preemptVcpu(model, model->running[last]);
+            dispatchVcpu(model, next, last);
+            changed = true;
+        }
+    }
+
+    for (int p = 0; p < model->pcpus; p++)
+    {
+        HostVcpu *next;
+        if (model->running[p] == NULL && (next = nextRunnable(model)) != NULL)
+        {
+            dispatchVcpu(model, next, p);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Run the pCPUs until time: guests work off their requests, and vruntime and
+// credit follow the time each vCPU runs
+void advanceHost(HostModel *model, int64_t time)
+{
+    int64_t elapsed = time - model->now;
+    for (int p = 0; p < model->pcpus; p++)
+    {
+        HostVcpu *vcpu = model->running[p];
+        if (vcpu == NULL)
+            continue;
+        vcpu->run_time += elapsed;
+        if (!vcpu->tenant)
+            vcpu->work -= elapsed;
+        vcpu->vruntime += elapsed * HOST_DEFAULT_WEIGHT / vcpu->weight;
+        vcpu->credit -= elapsed;
+    }
+    model->now = time;
+
+    int64_t min_vruntime = INT64_MAX;
+    for (int v = 0; v < model->count; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        if ((vcpu->state == VCPU_RUNNABLE || vcpu->state == VCPU_RUNNING) && vcpu->vruntime < min_vruntime)
+            min_vruntime = vcpu->vruntime;
+    }
+    if (min_vruntime != INT64_MAX && min_vruntime > model->min_vruntime)
+        model->min_vruntime = min_vruntime;
+}
+
+void *runGuestThread(void *argument)
+{
+    GuestThread *thread = (GuestThread *)argument;
+    HostModel *model = thread->model;
+    host_guest = thread->guest;
+    pthread_mutex_lock(&model->lock);
+    while (model->turn != host_guest)
+        pthread_cond_wait(&model->vcpus[host_guest].resumed, &model->lock);
+    pthread_mutex_unlock(&model->lock);
+
+    thread->run_guest(thread->guest, thread->context);
+    hostRequest(model, VCPU_EXIT, 0);
+    return NULL;
+}
+
+// Simulate every guest on its vCPU together with the tenant vCPUs on the
+// host's pCPUs. run_guest runs one guest's simulation; the host serves its
+// vCPU's requests from the event loop here until every guest has exited.
+void runHost(HostModel *model, void (*run_guest)(int guest, void *context), void *context)
+{
+    model->count = model->guests + model->tenant_vcpus;
+    model->vcpus = (HostVcpu *)calloc(model->count, sizeof(HostVcpu));
+    model->running = (HostVcpu **)calloc(model->pcpus, sizeof(HostVcpu *));
+    GuestThread *threads = (GuestThread *)malloc(sizeof(GuestThread) * model->guests);
+    if (model->vcpus == NULL || model->running == NULL || threads == NULL)
+    {
+        printf("Not enough memory for %d vCPUs\n", model->count);
+        exit(1);
+    }
+    for (int v = 0; v < model->count; v++)
+    {
+        HostVcpu *vcpu = &model->vcpus[v];
+        vcpu->tenant = v >= model->guests;
+        vcpu->weight = vcpu->tenant ? HOST_DEFAULT_WEIGHT : model->guest_weight;
+        vcpu->state = VCPU_HALTED;
+        vcpu->pcpu = -1;
+        vcpu->request = VCPU_EXECUTE;
+        vcpu->priority = CREDIT_UNDER;
+        pthread_cond_init(&vcpu->resumed, NULL);
+    }
+    model->now = 0;
+    model->min_vruntime = 0;
+    model->next_tick = model->slice / CREDIT_TICKS_PER_SLICE > 0 ? model->slice / CREDIT_TICKS_PER_SLICE : 1;
+    model->ticks = 0;
+    model->sequence = 0;
+    model->active_guests = model->guests;
+    model->turn = HOST_TURN;
+    pthread_mutex_init(&model->lock, NULL);
+    pthread_cond_init(&model->host_resumed, NULL);
+
+    for (int g = 0; g < model->guests; g++)
+    {
+        threads[g].model = model;
+        threads[g].guest = g;
+        threads[g].run_guest = run_guest;
+        threads[g].context = context;
+        if (pthread_create(&threads[g].thread, NULL, runGuestThread, &threads[g]) != 0)
+        {
+            printf("Cannot start the thread of guest %d\n", g + 1);
+            exit(1);
+        }
+    }
+
+    // Every guest runs up to its first request at time zero; the tenants
+    // queue behind the guests
+    for (int g = 0; g < model->guests; g++)
+        resumeGuest(model, &model->vcpus[g], 0);
+    for (int v = model->guests; v < model->count; v++)
+        enqueueVcpu(model, &model->vcpus[v], 0);
+
+    while (model->active_guests > 0)
+    {
+        while (settleHost(model))
+            ;
+        if (model->active_guests == 0)
+            break;
+
+        // Next event: a guest's work finishing, a slice ending, a halted
+        // guest waking or a credit tick
+        int64_t next = model->policy == HOST_CREDIT ? model->next_tick : INT64_MAX;
+        for (int v = 0; v < model->count; v++)
+        {
+            HostVcpu *vcpu = &model->vcpus[v];
+            if (vcpu->state == VCPU_RUNNING)
+            {
+                if (vcpu->slice_end < next)
+                    next = vcpu->slice_end;
+                if (!vcpu->tenant && model->now + vcpu->work < next)
+                    next = model->now + vcpu->work;
+            }
+            else if (vcpu->state == VCPU_HALTED && !vcpu->tenant && vcpu->argument < next)
+            {
+                next = vcpu->argument;
+            }
+        }
+        advanceHost(model, next);
+    }
+
+    for (int g = 0; g < model->guests; g++)
+        pthread_join(threads[g].thread, NULL);
+    for (int v = 0; v < model->count; v++)
+        pthread_cond_destroy(&model->vcpus[v].resumed);
+    pthread_mutex_destroy(&model->lock);
+    pthread_cond_destroy(&model->host_resumed);
+    free(threads);
+    free(model->running);
+    model->running = NULL;
+}
+
+// Copy the processes of one guest; guests take trace entries round-robin
+Process *guestProcesses(Process *processes, int n, int guests, int guest, int *count)
+{
+    Process *subset = (Process *)malloc(process_size * (n / guests + 1));
+    if (subset == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+
+    *count = 0;
+    for (int i = guest; i < n; i += guests)
+        memcpy(processAt(subset, (*count)++), processAt(processes, i), process_size);
+    return subset;
+}
+
+// One guest's simulation on its vCPU, run on the guest's thread by runHost
+void runHostedGuest(int guest, void *context)
+{
+    HostedRun *hosted = (HostedRun *)context;
+    int count;
+    Process *subset = guestProcesses(hosted->processes, hosted->n, hosted->guests, guest, &count);
+    hosted->run(subset, count, hosted->context, NULL);
+    summarizeResponses(subset, count, &hosted->hosted[4 * guest]);
+    hosted->counts[guest] = count;
+    free(subset);
+}
+
+// Run every guest on a dedicated CPU, then all of them together under the
+// host scheduler, and report per-guest steal time and the latency
+// amplification the host causes. run simulates one guest with context.
+void runHostedGuests(Process *processes, int n, HostModel *model, SimulationRun run, void *context)
+{
+    int guests = model->guests;
+    double *bare = (double *)malloc(sizeof(double) * 4 * guests);
+    double *hosted = (double *)malloc(sizeof(double) * 4 * guests);
+    int *counts = (int *)malloc(sizeof(int) * guests);
+    if (bare == NULL || hosted == NULL || counts == NULL)
+    {
+        printf("Not enough memory for %d guests\n", guests);
+        exit(1);
+    }
+
+    // Dedicated CPUs give the baseline
+    host_model = NULL;
+    for (int g = 0; g < guests; g++)
+    {
+        int count;
+        Process *guest = guestProcesses(processes, n, guests, g, &count);
+        gantt_chart_size = 0;
+        run(guest, count, context, NULL);
+        summarizeResponses(guest, count, &bare[4 * g]);
+        free(guest);
+    }
+
+    HostedRun hosted_run = {processes, n, guests, run, context, counts, hosted};
+    gantt_chart_size = 0;
+    host_model = model;
+    runHost(model, runHostedGuest, &hosted_run);
+    host_model = NULL;
+    displayHostedGuests(model, counts, bare, hosted);
+
+    free(model->vcpus);
+    free(bare);
+    free(hosted);
+    free(counts);
+}
+
+int parseHostPolicy(const char *name)
+{
+    static const char *names[] = {"credit", "cfs"};
+    for (int p = 0; p < (int)(sizeof(names) / sizeof(names[0])); p++)
+    {
+        if (strcmp(name, names[p]) == 0)
+            return p;
+    }
+    return -1;
+}
+
+// Ratio of a hosted latency to the same guest's latency on a dedicated CPU,
+// NA when only the hosted run has any
+void displayAmplification(double dedicated, double hosted)
+{
+    if (dedicated > 0.0)
+        printf("%.2f", hosted / dedicated);
+    else if (hosted > 0.0)
+        printf("NA");
+    else
+        printf("1.00");
+}
+
+// Write a CSV row per guest with the steal time the host scheduler caused and
+// the guest's response times with a dedicated CPU (dedicated) and on its vCPU
+// (hosted), four values per guest as summarizeResponses gives them
+void displayHostedGuests(HostModel *model, int *counts, double *dedicated, double *hosted)
+{
+    printf("Guest,Processes,vCPU Share,Steal Time,Steal (%%),Wakeup Steal,Host Preemptions,"
+           "Avg Response (Dedicated),Avg Response (Hosted),Response Amplification,"
+           "P99 Response (Dedicated),P99 Response (Hosted),P99 Amplification,"
+           "Deadline Misses (Dedicated),Deadline Misses (Hosted)\n");
+    for (int g = 0; g < model->guests; g++)
+    {
+        // The share is the part of its runnable time the vCPU held a pCPU
+        HostVcpu *vcpu = &model->vcpus[g];
+        int64_t runnable = vcpu->run_time + vcpu->steal;
+        double *bare = &dedicated[4 * g];
+        double *guest = &hosted[4 * g];
+        printf("%d,%d,%.4f,%.2f,%.2f,%.2f,%lld,%.2f,%.2f,", g + 1, counts[g],
+               runnable > 0 ? (double)vcpu->run_time / runnable : 1.0, (double)vcpu->steal / time_unit,
+               runnable > 0 ? 100.0 * vcpu->steal / runnable : 0.0, (double)vcpu->wake_steal / time_unit,
+               vcpu->preemptions, bare[0], guest[0]);
+        displayAmplification(bare[0], guest[0]);
+        printf(",%.2f,%.2f,", bare[2], guest[2]);
+        displayAmplification(bare[2], guest[2]);
+        printf(",%.0f,%.0f\n", bare[3], guest[3]);
+    }
+}
+
+// Write metrics measured before and after a change as CSV rows with the relative change
+void displayChanges(const char *names[], double *before, double *after, int count)
+{
+    for (int m = 0; m < count; m++)
+    {
+        double change = before[m] != 0.0 ? 100.0 * (after[m] - before[m]) / fabs(before[m]) : 0.0;
+        printf("%s,%.2f,%.2f,%.2f%%\n", names[m], before[m], after[m], change);
+    }
+}
+
+// Run the trace without and then with a change, both from the same initial
+// process state, and print the compared metrics side by side
+void runComparison(Process *processes, int n, ComparisonRun run, void *context, const char *names[], int count,
+                   const char *before_label, const char *after_label)
+{
+    Process *original = (Process *)malloc(process_size * n);
+    double *before = (double *)malloc(sizeof(double) * count);
+    double *after = (double *)malloc(sizeof(double) * count);
+    if (original == NULL || before == NULL || after == NULL)
+    {
+        printf("Not enough memory for %d processes\n", n);
+        exit(1);
+    }
+    memcpy(original, processes, process_size * n);
+
+    run(processes, n, 0, before, context);
+
+    memcpy(processes, original, process_size * n);
+    gantt_chart_size = 0;
+    run(processes, n, 1, after, context);
+
+    printf("Metric,%s,%s,Change\n", before_label, after_label);
+    displayChanges(names, before, after, count);
+
+    free(after);
+    free(before);
+    free(original);
+}
+
@@ -0,0 +1,595 @@
+#ifndef SIM_COMMON_H
+#define SIM_COMMON_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+// Models and reporting shared by the simulators (CFS, DPS-DTQ, reference)
+
+#define INITIAL_GANTT_CHART_SIZE 1000
+#define MAX_FILENAME_LENGTH 256
+#define DEFAULT_TICK_OVERHEAD_NS 1000
+#define DEFAULT_ADMISSION_HORIZON 20 // Time units of work the utilization limit applies to
+#define PREDICTOR_CLASSES 11 // Criticality classes 0-10 of the per-class burst predictor
+#define DEFAULT_PREDICTOR_ALPHA 0.2
+#define DEFAULT_BURST_SIGMA 0.5
+#define DEFAULT_HARDIRQ_NS 2000
+#define DEFAULT_SOFTIRQ_NS 8000
+#define HOST_DEFAULT_WEIGHT 256
+#define DEFAULT_CREDIT_SLICE_NS 30000000
+#define DEFAULT_HOST_LATENCY_NS 6000000
+#define CREDIT_TICKS_PER_SLICE 3 // Credit ticks per timeslice; credit is accounted once per timeslice
+#define CFS_HOST_GRANULARITY 8 // sched_latency / sched_min_granularity of the CFS host
+#define HOST_TURN -1
+#define MAX_IDLE_STATES 8
+#define IDLE_PREDICTION_WEIGHT 0.25 // EWMA weight of the latest idle period for the menu governor
+// name:exit latency ns:target residency ns:power mW, shallowest first (intel_idle-like)
+#define DEFAULT_IDLE_STATES "POLL:0:0:3000,C1:2000:2000:1000,C1E:10000:20000:600,C6:85000:200000:200,C10:890000:5000000:50"
+#define DEFAULT_SAMPLE_WINDOWS 200
+#define SAMPLE_METRICS 4
+#define CI95_Z 1.96
+#define STEADY_STATE_METRICS 3
+#define STEADY_STATE_BATCHES 20
+#define MSER_BATCH 5
+#define T_QUANTILE_BATCHES 2.093 // t(0.975) with STEADY_STATE_BATCHES - 1 degrees of freedom
+#define METRICS_BUCKETS 20 // Power-of-four histogram bounds, 1 to 4^19
+#define DEFAULT_METRICS_INTERVAL 1 // Seconds between metrics file rewrites
+#define METRICS_REQUEST_TIMEOUT_MS 100
+
+// Each simulator defines its own struct Process; the shared code reaches
+// processes only through the hooks below
+typedef struct Process Process;
+
+// What the shared models read from a process
+typedef struct
+{
+    int64_t arrival_time;
+    int64_t burst_time;
+    int64_t work; // Remaining work as the policy sees it, charged by admission control
+    int64_t deadline;
+    int64_t completion_time;
+    int64_t turnaround_time;
+    int64_t waiting_time;
+    int64_t response_time;
+    bool starved;   // Counted by the simulator's starvation metric
+    bool completed;
+    bool shed;      // Rejected by admission control
+} ProcessView;
+
+// Where a process's turnaround went (schedstat-like), accumulated per slice;
+// for a completed process the four times add up to its turnaround
+typedef struct
+{
+    int64_t wait_time;      // Runnable in the ready queue
+    int64_t run_time;       // Executing its own work
+    int64_t blocked_time;   // Held outside the ready queue by admission control
+    int64_t throttled_time; // Dispatched while ticks, interrupts or the host took the CPU
+    int64_t runnable_since; // When the process last became runnable
+    int slices;
+    int preemptions;        // Slices that ended with work left
+    int migrations;         // Always 0 on the single simulated CPU
+} SchedStat;
+
+// Runs the simulator's policy over processes. When averages is not NULL it
+// receives the run's average turnaround, waiting and response times and its
+// starvation count, in that order.
+typedef void (*SimulationRun)(Process *processes, int n, void *context, double *averages);
+
+// Runs one side of a before/after comparison: variant 0 without the change
+// under test, variant 1 with it. values receives the compared metrics.
+typedef void (*ComparisonRun)(Process *processes, int n, int variant, double *values, void *context);
+
+// Gantt Chart structure
+typedef struct
+{
+    int process_id;
+    int64_t start_time;
+    int64_t end_time;
+} GanttChartItem;
+
+// Sampling mode parameters
+typedef struct
+{
+    bool enabled;
+    int window_length;       // Length of a sampling window (0 = auto)
+    int strata;              // Number of load-level strata
+    int windows_per_stratum; // Windows simulated per stratum
+    int warmup;              // Padding before and after each window (-1 = the busy periods around it)
+    unsigned int seed;       // Seed for window selection
+    bool compare;            // Also run the full trace and report error/speedup
+} SamplingParams;
+
+// Load statistics of one trace window
+typedef struct
+{
+    int index;
+    int jobs;
+    double load;
+    int stratum;
+    int64_t busy_from; // Start of the busy period the window starts in
+    int64_t idle_at;   // First instant after the window's end with no work queued
+} TraceWindow;
+
+// Busy periods of one CPU that is fed the trace's work in arrival order. A
+// work-conserving scheduler runs exactly while work is queued, so it empties
+// the system at these instants whatever order it picks the jobs in.
+typedef struct
+{
+    int64_t start; // Start of the current busy period
+    int64_t end;   // When the work queued so far is done
+    int boundary;  // Next window boundary to resolve
+} BusyPeriods;
+
+// Per-window sums of the job-level metrics extrapolated by sampling mode
+typedef struct
+{
+    int jobs;
+    double sums[SAMPLE_METRICS];
+} WindowSample;
+
+// Synthetic open-system workload and run-length control parameters
+typedef struct
+{
+    bool enabled;
+    double arrival_rate;  // Poisson arrival rate (jobs per time unit)
+    double mean_burst;    // Mean of the exponential burst distribution
+    int max_jobs;         // Upper bound on generated jobs
+    double precision;     // Target CI half-width relative to the mean
+    double abs_precision; // Half-width accepted for metrics close to zero
+    int check_interval;   // Minimum completions between stopping-rule checks
+    unsigned int seed;    // Seed for the workload generator
+} SteadyStateParams;
+
+// Completion-order observations for steady-state analysis
+typedef struct
+{
+    SteadyStateParams *params;
+    double *values[STEADY_STATE_METRICS];
+    int count;
+    int capacity;
+    int next_check;
+    int truncation; // Warm-up observations discarded by MSER-5
+    double mean[STEADY_STATE_METRICS];
+    double half_width[STEADY_STATE_METRICS];
+    bool converged;
+    int64_t stop_time;
+} SteadyState;
+
+// Live progress of the running simulation, dumped on SIGUSR1 or periodically
+typedef struct
+{
+    long long simulated_time;
+    long long events; // Dispatch decisions and idle steps
+    long long completed;
+    long long queue_length;
+    long long busy_time;
+    double sum_turnaround;
+    double sum_waiting;
+    double sum_response;
+    int total_processes;
+} ProgressCounters;
+
+// Prometheus histogram over power-of-four bounds (1, 4, 16, ...); counts are
+// kept per bucket and made cumulative when the metrics are formatted
+typedef struct
+{
+    long long buckets[METRICS_BUCKETS + 1]; // Last bucket is +Inf
+    long long sum;
+    long long count;
+} MetricsHistogram;
+
+// Monotonic engine metrics exported in Prometheus text format
+typedef struct
+{
+    long long decisions; // Dispatch decisions
+    long long events;    // Dispatch decisions and idle steps
+    long long completed;
+    long long deadline_misses;
+    long long queue_length;
+    long long simulated_time;
+    MetricsHistogram quantum;     // Work granted per dispatch decision (ns)
+    MetricsHistogram queue_depth; // Ready queue length after each event
+    MetricsHistogram latency;     // Wall-clock time the event loop spent per event (ns)
+} MetricsSnapshot;
+
+// The event loop is the only writer of the snapshot and keeps the sequence odd
+// while it updates it; the exporter thread copies the snapshot and retries when
+// the sequence was odd or moved, so a scrape never holds up dispatch
+typedef struct
+{
+    atomic_uint sequence;
+    MetricsSnapshot snapshot;
+    const char *scheduler;   // Value of the scheduler label
+    const char *socket_path; // Unix socket answering each connection with the metrics
+    const char *file_path;   // Text file replaced every interval and at exit
+    int interval;            // Seconds between file rewrites
+    int listen_fd;
+    int wake_pipe[2];        // Written once to stop the exporter thread
+    pthread_t thread;
+    struct timespec start;
+    struct timespec last_event;
+} MetricsExporter;
+
+// Periodic timer tick (HZ) model. A tick fires every period ns and its
+// interrupt handler steals overhead ns of CPU time; running slices can only be
+// preempted on a tick. Without a tick model the simulation is tickless (NO_HZ).
+typedef struct
+{
+    int64_t hz;
+    int64_t period;      // ns between ticks
+    int64_t overhead;    // ns of CPU time taken by each tick
+    int64_t busy_ticks;  // Ticks that interrupted a running process
+    int64_t stolen_time; // CPU time lost to ticks while a process ran
+    int64_t end_time;    // Simulated time at the end of the run
+} TickModel;
+
+// An idle (C-)state. Leaving it takes exit_latency ns, and entering it only
+// pays off when the CPU then stays idle for at least target_residency ns.
+typedef struct
+{
+    char name[16];
+    int64_t exit_latency;
+    int64_t target_residency;
+    double power;      // mW drawn while in the state
+    long long entries;
+    int64_t residency; // ns spent in the state, including the exit
+} IdleState;
+
+// Idle states and the governor choosing among them whenever the CPU goes idle
+typedef enum
+{
+    IDLE_GOVERNOR_MENU,       // Deepest state whose residency fits the predicted idle period
+    IDLE_GOVERNOR_ORACLE,     // Deepest state whose residency fits the actual idle period
+    IDLE_GOVERNOR_SHALLOWEST, // Always the shallowest state (polling)
+    IDLE_GOVERNOR_DEEPEST     // Always the deepest allowed state
+} IdleGovernor;
+
+typedef struct
+{
+    IdleState states[MAX_IDLE_STATES];
+    int count;
+    IdleGovernor governor;
+    int64_t latency_limit;   // Deeper states exiting slower than this are never used, -1 for no limit
+    double predicted_idle;   // EWMA of past idle periods (ns)
+    long long wakeups;
+    long long premature;     // Wakeups before the target residency of the chosen state
+    int64_t exit_latency;    // Total exit latency charged to dispatches (ns)
+} IdleModel;
+
+// Outcome of admission control for a process arriving at the ready queue
+typedef enum
+{
+    ADMISSION_ADMIT,
+    ADMISSION_DEFER,           // Ready queue too long; retried when it shrinks
+    ADMISSION_REJECT_LOAD,     // Admitted work would exceed the utilization limit
+    ADMISSION_REJECT_DEADLINE  // Cannot finish before its deadline behind the backlog
+} AdmissionDecision;
+
+// Admission controller in front of the ready queue. A zero limit disables its check.
+typedef struct
+{
+    double max_utilization; // Admitted work allowed over the horizon, as a fraction of the CPU
+    int64_t horizon;        // ns
+    int max_queue;          // Ready queue length at which arrivals are deferred
+    int64_t max_deferral;   // ns a deferred process may wait before it is shed
+    bool deadline_check;    // Reject processes that cannot meet their deadline
+    int64_t backlog;        // Admitted work not yet executed (ns)
+    Process **deferred;     // FIFO of deferred processes
+    int deferred_head;
+    int deferred_tail;
+    int rejected;           // Processes shed for any reason
+    long long admitted;
+    long long deferrals;
+    long long released;     // Deferred processes admitted later
+    long long rejected_load;
+    long long rejected_deadline;
+    long long rejected_timeout;
+    int64_t deferral_time;  // Total time deferred processes waited before admission (ns)
+} AdmissionControl;
+
+// Distribution the actual execution times are drawn from. The trace's burst
+// times then become the estimates the policies are given.
+typedef enum
+{
+    BURSTS_EXACT,       // Actual bursts equal the trace
+    BURSTS_LOGNORMAL,   // Estimate times a mean-one lognormal error
+    BURSTS_EXPONENTIAL  // Exponential with the estimate as its mean
+} BurstDistribution;
+
+// How a process's burst is predicted when it arrives
+typedef enum
+{
+    PREDICT_ORACLE,   // The actual burst (exact knowledge)
+    PREDICT_ESTIMATE, // The trace estimate as given
+    PREDICT_EWMA,     // The estimate corrected by an EWMA of actual/estimate ratios
+    PREDICT_CLASS     // EWMA of the actual bursts of the same criticality class
+} PredictorKind;
+
+// Online burst predictor: policies only see predicted bursts, refined as
+// processes complete; a process that outlives its prediction has it doubled
+typedef struct
+{
+    PredictorKind kind;
+    double alpha;                        // EWMA weight of the newest observation
+    double ratio;                        // EWMA of actual / estimated burst
+    double class_mean[PREDICTOR_CLASSES]; // EWMA of actual bursts per criticality (ns)
+    bool class_seen[PREDICTOR_CLASSES];
+    long long predictions;
+    long long underestimates;
+    double abs_error;     // Sum of |predicted - actual| (ns)
+    double rel_error;     // Sum of |predicted - actual| / actual
+} BurstPredictor;
+
+// Interrupt source pinned to the simulated CPU. Interrupts arrive in bursts
+// at Poisson times (one interrupt per burst makes the source Poisson), and
+// their hardirq and softirq handlers preempt whatever runs.
+typedef struct
+{
+    int64_t interval;     // Mean ns between interrupts
+    int64_t hardirq;      // ns spent in the hardirq handler per interrupt
+    int64_t softirq;      // ns of softirq processing per interrupt
+    double burst;         // Mean interrupts per burst
+    uint64_t seed;
+    uint64_t rng;         // xorshift64* state, independent of rand()
+    int64_t next_arrival;
+    int pending;          // Interrupts still to come in the current burst
+    int64_t busy_until;   // End of the interrupt work handled so far
+    long long count;
+    int64_t stolen;       // ns taken from running or waking processes
+    int64_t end_time;     // Simulated time at the end of the run
+} InterruptModel;
+
+// Host scheduler multiplexing guest vCPUs onto physical CPUs
+typedef enum
+{
+    HOST_CREDIT, // Xen-style credit: fixed timeslices, BOOST for vCPUs woken under credit
+    HOST_CFS     // CFS-style: the sched_latency period is shared by weight, sleepers get half of it back
+} HostPolicy;
+
+typedef enum
+{
+    VCPU_HALTED,   // Blocked by its guest until the wake time
+    VCPU_RUNNABLE, // In the host run queue
+    VCPU_RUNNING,
+    VCPU_EXITED    // The guest finished its trace
+} VcpuState;
+
+// Credit priorities, best first
+typedef enum
+{
+    CREDIT_BOOST, // Woken with credit left
+    CREDIT_UNDER,
+    CREDIT_OVER
+} CreditPriority;
+
+// What a guest asks of its vCPU
+typedef enum
+{
+    VCPU_EXECUTE, // Run argument ns of guest work
+    VCPU_HALT,    // Block until argument, the next event of the guest
+    VCPU_EXIT
+} VcpuRequest;
+
+// A vCPU as the host schedules it. Guest vCPUs come first; tenant vCPUs are
+// always runnable.
+typedef struct
+{
+    int weight;
+    bool tenant;
+    VcpuState state;
+    int pcpu;             // pCPU while running
+    VcpuRequest request;  // Last request of the guest
+    int64_t argument;     // Work of an execution, wake time of a halt
+    int64_t work;         // Guest work left of the current request
+    int64_t queued_at;
+    long long sequence;   // Enqueue order, FIFO within a credit priority
+    int64_t slice_end;
+    int64_t vruntime;     // CFS host
+    int64_t credit;       // Credit host
+    CreditPriority priority;
+    bool active;          // Ran since the last credit accounting
+    int64_t reply;        // Answer to the request: completion time, or the wakeup delay
+    int64_t run_time;     // Time on a pCPU
+    int64_t steal;        // Runnable time spent waiting for a pCPU
+    int64_t wake_steal;   // Part of the steal time taken on wakeups
+    long long preemptions;
+    pthread_cond_t resumed; // Signalled when the host hands the guest its turn
+} HostVcpu;
+
+// All guests' vCPUs and the tenant vCPUs share the pCPUs. Each guest's
+// simulation runs on a thread of its own and blocks in hostExecution and
+// hostWakeDelay while the host advances; the host hands the turn to one
+// thread at a time, so the simulation stays single-threaded and deterministic.
+typedef struct
+{
+    HostPolicy policy;
+    int pcpus;            // Physical CPUs the host schedules onto
+    int guests;           // Guests the trace is split into, one vCPU each
+    int tenant_vcpus;     // Always-runnable vCPUs of other tenants
+    int guest_weight;     // Weight of each guest vCPU; tenant vCPUs have HOST_DEFAULT_WEIGHT
+    int64_t slice;        // Credit timeslice, or the CFS host's sched_latency
+    HostVcpu *vcpus;      // guests + tenant_vcpus entries
+    int count;
+    HostVcpu **running;   // vCPU on each pCPU, NULL while idle
+    int64_t now;
+    int64_t min_vruntime; // CFS host: never decreases
+    int64_t next_tick;    // Credit host: next tick, every slice / CREDIT_TICKS_PER_SLICE
+    int ticks;            // Ticks since the last accounting
+    long long sequence;
+    int active_guests;    // Guests that have not exited
+    int turn;             // Guest whose thread runs, HOST_TURN for the host
+    pthread_mutex_t lock;
+    pthread_cond_t host_resumed; // Signalled when a guest hands the turn back
+} HostModel;
+
+// A guest's simulation thread
+typedef struct
+{
+    HostModel *model;
+    int guest;
+    void (*run_guest)(int guest, void *context);
+    void *context;
+    pthread_t thread;
+} GuestThread;
+
+// The trace split among the guests of a host, and what each guest reports
+typedef struct
+{
+    Process *processes;
+    int n;
+    int guests;
+    SimulationRun run; // Runs one guest on its own copy of the simulator's parameters
+    void *context;
+    int *counts;       // Processes of each guest
+    double *hosted;    // summarizeResponses of each guest on its vCPU
+} HostedRun;
+
+// Global variables
+extern GanttChartItem *gantt_chart;
+extern int gantt_chart_size;
+extern int gantt_chart_capacity;
+extern SteadyState *steady_state;
+extern int64_t time_unit; // Nanoseconds per time unit of the input trace
+extern TickModel *tick_model;
+extern IdleModel *idle_model;
+extern AdmissionControl *admission;
+extern BurstPredictor *burst_predictor;
+extern InterruptModel *irq_model;
+extern HostModel *host_model;
+extern ProgressCounters progress;
+extern volatile sig_atomic_t progress_requested;
+extern const char *progress_filename;
+extern struct timespec progress_start;
+extern MetricsExporter *exporter;
+
+// Implemented by each simulator over its own Process layout
+extern const size_t process_size; // sizeof(struct Process)
+void viewProcess(Process *process, ProcessView *view);
+Process *processAt(Process *processes, int index);
+void shiftProcess(Process *process, int64_t offset);
+void markShed(Process *process);
+SchedStat *processStat(Process *process);
+void initializeProcess(Process *process, int id, int64_t arrival_time, int64_t burst_time, int64_t deadline,
+                       int criticality, int64_t period, int priority);
+
+// Function prototypes
+void addToGanttChart(int process_id, int64_t start_time, int64_t end_time);
+void displayGanttChart();
+void writeGanttChart(const char *filename);
+bool arrivalsSorted(Process *processes, int n);
+int firstArrivalAfter(Process *processes, int n, int64_t time);
+int compareWindowLoad(const void *a, const void *b);
+double tQuantile95(int df);
+void resolveBoundaries(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length, int64_t start,
+                       int64_t end);
+void addBusyWork(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length, int64_t arrival,
+                 int64_t burst);
+void finishBusyPeriods(BusyPeriods *busy, TraceWindow *windows, int num_windows, int64_t length);
+WindowSample simulateWindow(Process *processes, int n, SimulationRun run, void *context, int64_t start, int64_t end,
+                            int64_t from, int64_t until, bool sorted);
+void runSampling(Process *processes, int n, SimulationRun run, void *context, SamplingParams *sampling);
+double uniformRandom();
+double exponentialRandom(double mean);
+int generateSyntheticProcesses(Process **out, SteadyStateParams *params);
+int readPreparedTrace(Process **out, const char *filename);
+void initializeSteadyState(SteadyState *state, SteadyStateParams *params);
+void freeSteadyState(SteadyState *state);
+int mser5Truncation(double *values, int count);
+void batchMeans(double *values, int start, int count, double *mean, double *half_width);
+bool evaluateSteadyState(SteadyState *state);
+bool recordObservation(SteadyState *state, Process *process, int64_t current_time);
+void displaySteadyState(SteadyState *state);
+int64_t tickUsefulTime(TickModel *model, int64_t time);
+int64_t tickWorkEnd(TickModel *model, int64_t start, int64_t work);
+int64_t tickedExecution(TickModel *model, int64_t start, int64_t slice, int64_t remaining, int64_t *work);
+void displayTickStats(TickModel *model);
+void resetIdleModel(IdleModel *model);
+int parseIdleStates(IdleModel *model, const char *spec);
+int parseIdleGovernor(const char *name);
+int64_t enterIdleState(IdleModel *model, int64_t idle);
+void displayIdleStats(IdleModel *model);
+void resetAdmission(AdmissionControl *ac, int n);
+AdmissionDecision admissionCheck(AdmissionControl *ac, ProcessView *view, int64_t now, int queue_length);
+void shedProcess(AdmissionControl *ac, Process *process, AdmissionDecision reason);
+bool admitArrival(AdmissionControl *ac, Process *process, int64_t now, int queue_length);
+Process *releaseDeferred(AdmissionControl *ac, int64_t now, int queue_length);
+Process *admittedProcesses(Process *processes, int n, int *admitted);
+int compareInt64(const void *a, const void *b);
+int64_t nearestRankPercentile(int64_t *values, int count, double q);
+void displayAdmissionStats(AdmissionControl *ac, Process *processes, int n);
+double normalRandom();
+int parseBurstDistribution(const char *spec, double *sigma);
+int64_t drawActualBurst(BurstDistribution distribution, double sigma, int64_t estimate);
+int parsePredictor(const char *name);
+void resetPredictor(BurstPredictor *predictor);
+int predictorClass(int criticality);
+int64_t predictBurst(BurstPredictor *predictor, int64_t estimate, int64_t actual, int criticality);
+void learnBurst(BurstPredictor *predictor, int64_t estimate, int64_t actual, int criticality);
+void displayPredictorStats(BurstPredictor *predictor);
+double interruptRandom(InterruptModel *model);
+void nextInterrupt(InterruptModel *model);
+void resetInterrupts(InterruptModel *model);
+int64_t interruptedExecution(InterruptModel *model, int64_t start, int64_t end);
+int64_t interruptIdleDelay(InterruptModel *model, int64_t idle_end);
+void summarizeResponses(Process *processes, int n, double summary[4]);
+void displayInterruptLoad(InterruptModel *model);
+void displayInterruptStats(InterruptModel *model, Process *processes, int n);
+int64_t hostRequest(HostModel *model, VcpuRequest request, int64_t argument);
+int64_t hostExecution(HostModel *model, int64_t start, int64_t end);
+int64_t hostWakeDelay(HostModel *model, int64_t idle_start, int64_t idle_end);
+void resumeGuest(HostModel *model, HostVcpu *vcpu, int64_t reply);
+void enqueueVcpu(HostModel *model, HostVcpu *vcpu, int64_t time);
+void applyRequest(HostModel *model, HostVcpu *vcpu);
+int64_t hostTimeslice(HostModel *model, HostVcpu *vcpu);
+bool ranksBefore(HostModel *model, HostVcpu *a, HostVcpu *b);
+HostVcpu *nextRunnable(HostModel *model);
+int lastRunning(HostModel *model);
+void dispatchVcpu(HostModel *model, HostVcpu *vcpu, int pcpu);
+void preemptVcpu(HostModel *model, HostVcpu *vcpu);
+void wakeVcpu(HostModel *model, HostVcpu *vcpu);
+void accountCredit(HostModel *model);
+bool settleHost(HostModel *model);
+void advanceHost(HostModel *model, int64_t time);
+void *runGuestThread(void *argument);
+void runHost(HostModel *model, void (*run_guest)(int guest, void *context), void *context);
+Process *guestProcesses(Process *processes, int n, int guests, int guest, int *count);
+void runHostedGuest(int guest, void *context);
+void runHostedGuests(Process *processes, int n, HostModel *model, SimulationRun run, void *context);
+int parseHostPolicy(const char *name);
+void displayAmplification(double dedicated, double hosted);
+void displayHostedGuests(HostModel *model, int *counts, double *dedicated, double *hosted);
+void displayChanges(const char *names[], double *before, double *after, int count);
+void runComparison(Process *processes, int n, ComparisonRun run, void *context, const char *names[], int count,
+                   const char *before_label, const char *after_label);
+void accountRelease(Process *process, int64_t now);
+void accountSlice(Process *process, int64_t start, int64_t end, int64_t work, bool preempted);
+void resetProgress(int n);
+void recordProgressCompletion(int64_t turnaround_time, int64_t waiting_time, int64_t response_time);
+void writeProgressSnapshot();
+void updateProgress(int64_t current_time, int completed_processes, int queue_length);
+void handleProgressSignal(int signal_number);
+void startProgressReporting(const char *filename, int interval);
+int metricsBucket(int64_t value);
+void observeHistogram(MetricsHistogram *histogram, int64_t value);
+void beginMetricsUpdate(MetricsExporter *e);
+void endMetricsUpdate(MetricsExporter *e);
+void metricsDispatch(int64_t quantum);
+void metricsCompletion(int64_t completion_time, int64_t deadline);
+void metricsEvent(int64_t current_time, int queue_length);
+void readMetricsSnapshot(MetricsExporter *e, MetricsSnapshot *snapshot);
+void writeMetric(FILE *file, const char *scheduler, const char *name, const char *type, const char *help, double value);
+void writeMetricsHistogram(FILE *file, const char *scheduler, const char *name, const char *help, MetricsHistogram *histogram);
+void formatMetrics(FILE *file, MetricsExporter *e);
+void writeMetricsFile(MetricsExporter *e);
+void serveMetricsClient(MetricsExporter *e);
+int64_t monotonicMilliseconds();
+void *runMetricsExporter(void *argument);
+MetricsExporter *startMetricsExporter(const char *scheduler, const char *socket_path, const char *file_path, int interval);
+void stopMetricsExporter();
+
+#endif
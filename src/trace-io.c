@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace-io.h"
+
+// Map a prepared trace read-only. Returns 1 when it is mapped, 0 when the file
+// cannot be read or is not a prepared trace, and -1 when it is one but damaged.
+int mapPreparedTrace(const char *filename, PreparedTrace *trace)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceHeader))
+    {
+        close(fd);
+        return 0;
+    }
+
+    trace->size = st.st_size;
+    trace->base = mmap(NULL, trace->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (trace->base == MAP_FAILED)
+        return 0;
+
+    char *base = (char *)trace->base;
+    trace->header = (TraceHeader *)base;
+    if (memcmp(trace->header->magic, TRACE_MAGIC, sizeof(trace->header->magic)) != 0)
+    {
+        munmap(trace->base, trace->size);
+        return 0;
+    }
+    if (trace->header->version != TRACE_VERSION || trace->header->record_size != sizeof(TraceRecord) ||
+        trace->header->count < 1 ||
+        (size_t)trace->header->record_offset + sizeof(TraceRecord) * trace->header->count > trace->size ||
+        (size_t)trace->header->pid_offset + sizeof(PidEntry) * trace->header->count > trace->size)
+    {
+        printf("Invalid prepared trace: %s\n", filename);
+        munmap(trace->base, trace->size);
+        return -1;
+    }
+
+    trace->records = (TraceRecord *)(base + trace->header->record_offset);
+    trace->pids = (PidEntry *)(base + trace->header->pid_offset);
+    return 1;
+}
+
+// Unmap a prepared trace
+void unmapPreparedTrace(PreparedTrace *trace)
+{
+    munmap(trace->base, trace->size);
+}
+
+bool parseFormat(const char *name, TraceFormat *format)
+{
+    static const char *names[] = {"text", "swf", "google", "alibaba"};
+    for (int f = FORMAT_TEXT; f <= FORMAT_ALIBABA; f++)
+    {
+        if (strcmp(name, names[f]) == 0)
+        {
+            *format = (TraceFormat)f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Split a line in place. A space separator splits on runs of whitespace;
+// any other separator keeps empty fields. Returns the number of fields.
+int splitFields(char *line, char separator, char **fields, int max_fields)
+{
+    line[strcspn(line, "\r\n")] = '\0';
+    int count = 0;
+    if (separator == ' ')
+    {
+        for (char *token = strtok(line, " \t"); token != NULL && count < max_fields; token = strtok(NULL, " \t"))
+            fields[count++] = token;
+        return count;
+    }
+
+    char *field = line;
+    while (count < max_fields)
+    {
+        fields[count++] = field;
+        char *next = strchr(field, separator);
+        if (next == NULL)
+            break;
+        *next = '\0';
+        field = next + 1;
+    }
+    return count;
+}
+
+// Parse a whole field as a number; empty fields do not parse
+bool numberField(const char *field, double *value)
+{
+    char *end;
+    *value = strtod(field, &end);
+    return end != field && *end == '\0';
+}
+
+int clampCriticality(long long value)
+{
+    if (value < MIN_CRITICALITY)
+        return MIN_CRITICALITY;
+    return value > MAX_CRITICALITY ? MAX_CRITICALITY : (int)value;
+}
+
+// Convert a finished job to the process model and emit it. Bursts are the
+// CPU time runtime x cpus unless runtime_only is set, rounded up to at least
+// one unit; a deadline of 0 means none.
+void emitProcess(Importer *importer, int64_t original_id, double arrival_ns, double runtime_ns, double deadline_ns,
+                 int criticality, double cpus)
+{
+    double unit = (double)importer->options->unit_ns;
+    double work = importer->options->runtime_only || cpus < 1 ? runtime_ns : runtime_ns * cpus;
+
+    TraceRecord record;
+    memset(&record, 0, sizeof(record));
+    record.original_id = (int32_t)original_id;
+    record.arrival_time = (int64_t)(arrival_ns / unit);
+    record.burst_time = (int64_t)ceil(work / unit);
+    if (record.burst_time < 1)
+        record.burst_time = 1;
+    record.deadline = deadline_ns > 0 ? (int64_t)ceil(deadline_ns / unit) : 0;
+    record.criticality = criticality;
+
+    importer->imported++;
+    importer->emit(&record, importer->context);
+}
+
+// SWF: ';' starts a header comment; each job line has 18 fields, -1 when
+// unknown. Submit time and run time (seconds) become arrival and runtime,
+// allocated (else requested) processors the CPUs, and submit + requested
+// time the deadline. SWF has no priority field, so the queue number
+// stands in for the criticality.
+void importSwfLine(Importer *importer, char *line)
+{
+    char *fields[SWF_FIELDS];
+    int count = splitFields(line, ' ', fields, SWF_FIELDS);
+    if (count == 0 || fields[0][0] == ';')
+        return;
+
+    double job, submit, runtime, allocated, requested, requested_time, queue;
+    if (count < 15 || !numberField(fields[0], &job) || !numberField(fields[1], &submit) ||
+        !numberField(fields[3], &runtime) || !numberField(fields[4], &allocated) ||
+        !numberField(fields[7], &requested) || !numberField(fields[8], &requested_time) ||
+        !numberField(fields[14], &queue) || submit < 0)
+    {
+        importer->malformed++;
+        return;
+    }
+    if (runtime <= 0)
+    {
+        importer->no_runtime++;
+        return;
+    }
+
+    double cpus = allocated > 0 ? allocated : requested;
+    double deadline = requested_time > 0 ? (submit + requested_time) * 1e9 : 0;
+    int criticality = queue >= 0 ? clampCriticality((long long)queue) : DEFAULT_CRITICALITY;
+    emitProcess(importer, (int64_t)job, submit * 1e9, runtime * 1e9, deadline, criticality, cpus);
+}
+
+uint64_t hashTask(int64_t job, int64_t task)
+{
+    uint64_t h = (uint64_t)job * 0x9E3779B97F4A7C15ULL ^ (uint64_t)task * 0xC2B2AE3D27D4EB4FULL;
+    return h ^ (h >> 29);
+}
+
+// Look up an open task, inserting it when create is set
+OpenTask *findOpenTask(Importer *importer, int64_t job, int64_t task, bool create)
+{
+    if (create && (importer->task_count + 1) * 2 > importer->task_capacity)
+    {
+        // Grow to keep the table at most half full
+        OpenTask *old = importer->tasks;
+        int64_t old_capacity = importer->task_capacity;
+        importer->task_capacity = old_capacity > 0 ? old_capacity * 2 : INITIAL_OPEN_TASKS;
+        importer->tasks = (OpenTask *)malloc(sizeof(OpenTask) * importer->task_capacity);
+        if (importer->tasks == NULL)
+        {
+            printf("Not enough memory for %lld open tasks\n", (long long)importer->task_count);
+            exit(1);
+        }
+        for (int64_t i = 0; i < importer->task_capacity; i++)
+            importer->tasks[i].job = -1;
+        importer->task_count = 0;
+        for (int64_t i = 0; i < old_capacity; i++)
+        {
+            if (old[i].job >= 0)
+                *findOpenTask(importer, old[i].job, old[i].task, true) = old[i];
+        }
+        free(old);
+    }
+    if (importer->task_capacity == 0)
+        return NULL;
+
+    int64_t mask = importer->task_capacity - 1;
+    for (int64_t slot = hashTask(job, task) & mask;; slot = (slot + 1) & mask)
+    {
+        OpenTask *open_task = &importer->tasks[slot];
+        if (open_task->job == job && open_task->task == task)
+            return open_task;
+        if (open_task->job < 0)
+        {
+            if (!create)
+                return NULL;
+            open_task->job = job;
+            open_task->task = task;
+            open_task->submit_time = -1;
+            open_task->schedule_time = -1;
+            open_task->priority = 0;
+            open_task->cpu_request = 0;
+            importer->task_count++;
+            return open_task;
+        }
+    }
+}
+
+// Delete an open task, shifting later entries of its probe run back so that
+// lookups never stop early
+void removeOpenTask(Importer *importer, OpenTask *open_task)
+{
+    int64_t mask = importer->task_capacity - 1;
+    int64_t hole = open_task - importer->tasks;
+    for (int64_t next = (hole + 1) & mask; importer->tasks[next].job >= 0; next = (next + 1) & mask)
+    {
+        int64_t home = hashTask(importer->tasks[next].job, importer->tasks[next].task) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            importer->tasks[hole] = importer->tasks[next];
+            hole = next;
+        }
+    }
+    importer->tasks[hole].job = -1;
+    importer->task_count--;
+}
+
+// Google task_events: timestamp (us), missing info, job id, task index,
+// machine id, event type, user, scheduling class, priority (0-11), CPU
+// request (fraction of a machine), ... A task arrives at its first SUBMIT and
+// its burst is the run from its last SCHEDULE to FINISH. EVICT and FAIL wait
+// for a resubmission; KILL and LOST drop the task.
+void importGoogleLine(Importer *importer, char *line)
+{
+    char *fields[GOOGLE_FIELDS];
+    int count = splitFields(line, ',', fields, GOOGLE_FIELDS);
+    if (count == 1 && fields[0][0] == '\0')
+        return;
+
+    double timestamp, job, task, event, priority, cpu_request;
+    if (count < 10 || !numberField(fields[0], &timestamp) || !numberField(fields[2], &job) ||
+        !numberField(fields[3], &task) || !numberField(fields[5], &event) || job < 0)
+    {
+        importer->malformed++;
+        return;
+    }
+    // Timestamp 2^63 - 1 marks events after the end of the trace
+    if (timestamp >= 9.2e18)
+        return;
+
+    OpenTask *open_task = findOpenTask(importer, (int64_t)job, (int64_t)task, event <= GOOGLE_SCHEDULE);
+    if (open_task == NULL)
+        return;
+    if (numberField(fields[8], &priority))
+        open_task->priority = (int)priority;
+    if (numberField(fields[9], &cpu_request))
+        open_task->cpu_request = cpu_request;
+
+    switch ((int)event)
+    {
+    case GOOGLE_SUBMIT:
+        if (open_task->submit_time < 0)
+            open_task->submit_time = (int64_t)timestamp;
+        open_task->schedule_time = -1;
+        break;
+    case GOOGLE_SCHEDULE:
+        if (open_task->submit_time < 0)
+            open_task->submit_time = (int64_t)timestamp;
+        open_task->schedule_time = (int64_t)timestamp;
+        break;
+    case GOOGLE_EVICT:
+    case GOOGLE_FAIL:
+        open_task->schedule_time = -1;
+        break;
+    case GOOGLE_FINISH:
+        if (open_task->schedule_time >= 0 && timestamp > open_task->schedule_time)
+        {
+            emitProcess(importer, importer->imported + 1, open_task->submit_time * 1e3,
+                        (timestamp - open_task->schedule_time) * 1e3, 0,
+                        clampCriticality(1 + open_task->priority * (MAX_CRITICALITY - 1) / GOOGLE_MAX_PRIORITY),
+                        open_task->cpu_request * importer->options->machine_cpus);
+        }
+        else
+        {
+            importer->no_runtime++;
+        }
+        removeOpenTask(importer, open_task);
+        break;
+    case GOOGLE_KILL:
+    case GOOGLE_LOST:
+        importer->unfinished++;
+        removeOpenTask(importer, open_task);
+        break;
+    default:
+        break; // Updates only change the priority and request
+    }
+}
+
+// Alibaba batch_task: task name, instance count, job name, task type, status,
+// start time, end time (seconds), planned CPU (100 = one core), planned
+// memory. Terminated tasks arrive at their start; each of the instances runs
+// for the task's duration on the planned CPUs. There is no priority field.
+void importAlibabaLine(Importer *importer, char *line)
+{
+    char *fields[ALIBABA_FIELDS];
+    int count = splitFields(line, ',', fields, ALIBABA_FIELDS);
+    if (count == 1 && fields[0][0] == '\0')
+        return;
+
+    double instances, start, end, plan_cpu;
+    if (count < 8 || !numberField(fields[5], &start) || !numberField(fields[6], &end) || start < 0)
+    {
+        importer->malformed++;
+        return;
+    }
+    if (strcmp(fields[4], "Terminated") != 0)
+    {
+        importer->unfinished++;
+        return;
+    }
+    if (end <= start)
+    {
+        importer->no_runtime++;
+        return;
+    }
+
+    if (!numberField(fields[1], &instances) || instances < 1)
+        instances = 1;
+    if (!numberField(fields[7], &plan_cpu) || plan_cpu <= 0)
+        plan_cpu = 100;
+    emitProcess(importer, importer->imported + 1, start * 1e9, (end - start) * 1e9, 0, DEFAULT_CRITICALITY,
+                instances * plan_cpu / 100.0);
+}
+
+// Stream a source trace through the importer of its format
+int importTrace(const char *source, Importer *importer)
+{
+    FILE *file = fopen(source, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", source);
+        return 1;
+    }
+
+    char *line = NULL;
+    size_t length = 0;
+    while (getline(&line, &length, file) != -1)
+    {
+        importer->lines++;
+        if (importer->options->format == FORMAT_SWF)
+            importSwfLine(importer, line);
+        else if (importer->options->format == FORMAT_GOOGLE)
+            importGoogleLine(importer, line);
+        else
+            importAlibabaLine(importer, line);
+    }
+    free(line);
+    fclose(file);
+
+    // Tasks still open at the end of the trace never finished
+    importer->unfinished += importer->task_count;
+    free(importer->tasks);
+    importer->tasks = NULL;
+    importer->task_capacity = importer->task_count = 0;
+    return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef TRACE_IO_H
+#define TRACE_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TRACE_MAGIC "PROCTRCE"
+#define TRACE_VERSION 1
+#define MIN_CRITICALITY 1
+#define MAX_CRITICALITY 10
+#define DEFAULT_CRITICALITY 5 // For sources without a priority
+#define DEFAULT_IMPORT_UNIT_NS 1000000 // Imported traces are in milliseconds by default
+#define INITIAL_OPEN_TASKS 1024 // Power of two
+#define SWF_FIELDS 18
+#define GOOGLE_FIELDS 13
+#define GOOGLE_MAX_PRIORITY 11
+#define ALIBABA_FIELDS 9
+
+// Prepared trace layout written by trace-prep and mapped by the simulators
+// (native endianness, every section 8-byte aligned):
+//   TraceHeader
+//   TraceRecord[count]     sorted by arrival time (stable), ids renumbered
+//                          1..count in that order
+//   PidEntry[count]        original id -> record index, sorted by original
+//                          id and then index, so a duplicated id lists its
+//                          records in arrival order
+// Times stay in the trace's time units; the simulators scale them by
+// --time-unit-ns when they map the file.
+
+// File header
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    int64_t count;
+    int64_t record_offset;
+    int64_t pid_offset;
+    int64_t min_arrival;
+    int64_t max_arrival;
+    int64_t total_burst;
+} TraceHeader;
+
+// One process, holding the fields of a text trace line
+typedef struct
+{
+    int64_t arrival_time;
+    int64_t burst_time;
+    int64_t deadline;
+    int64_t period;
+    int32_t id;          // Dense id: position in arrival order, from 1
+    int32_t original_id; // Id in the source trace
+    int32_t criticality;
+    int32_t priority;    // Last column: nice value (CFS, reference) or system priority (DPS-DTQ)
+} TraceRecord;
+
+// Record of an original id
+typedef struct
+{
+    int64_t original_id;
+    int64_t index;
+} PidEntry;
+
+// A mapped prepared trace
+typedef struct
+{
+    void *base;
+    size_t size;
+    TraceHeader *header;
+    TraceRecord *records;
+    PidEntry *pids;
+} PreparedTrace;
+
+// Source formats of the importers
+typedef enum
+{
+    FORMAT_TEXT,    // The simulators' own trace format
+    FORMAT_SWF,     // Parallel Workloads Archive Standard Workload Format
+    FORMAT_GOOGLE,  // Google cluster-data task_events CSV
+    FORMAT_ALIBABA  // Alibaba cluster-trace batch_task CSV
+} TraceFormat;
+
+// How the fields of a source trace map onto processes
+typedef struct
+{
+    TraceFormat format;
+    int64_t unit_ns;   // Time unit of the imported trace
+    int machine_cpus;  // CPUs of a machine, for Google's normalized CPU requests
+    bool runtime_only; // Keep bursts at the wall-clock runtime instead of runtime x CPUs
+} ImportOptions;
+
+// Google task_events event types
+typedef enum
+{
+    GOOGLE_SUBMIT,
+    GOOGLE_SCHEDULE,
+    GOOGLE_EVICT,
+    GOOGLE_FAIL,
+    GOOGLE_FINISH,
+    GOOGLE_KILL,
+    GOOGLE_LOST
+} GoogleEvent;
+
+// A Google task seen submitted but not yet finished
+typedef struct
+{
+    int64_t job; // -1 marks a free slot
+    int64_t task;
+    int64_t submit_time;   // us
+    int64_t schedule_time; // us, -1 while waiting to be (re)scheduled
+    int priority;
+    double cpu_request;
+} OpenTask;
+
+// Streaming import: each source line is read once and every finished process
+// is handed to emit, so memory stays constant except for Google's open tasks
+typedef struct
+{
+    ImportOptions *options;
+    void (*emit)(TraceRecord *record, void *context);
+    void *context;
+    int64_t lines;
+    int64_t imported;
+    int64_t malformed;
+    int64_t no_runtime;
+    int64_t unfinished;
+    OpenTask *tasks; // Open addressing with linear probing
+    int64_t task_capacity;
+    int64_t task_count;
+} Importer;
+
+int mapPreparedTrace(const char *filename, PreparedTrace *trace);
+void unmapPreparedTrace(PreparedTrace *trace);
+bool parseFormat(const char *name, TraceFormat *format);
+int splitFields(char *line, char separator, char **fields, int max_fields);
+bool numberField(const char *field, double *value);
+int clampCriticality(long long value);
+void emitProcess(Importer *importer, int64_t original_id, double arrival_ns, double runtime_ns, double deadline_ns,
+                 int criticality, double cpus);
+void importSwfLine(Importer *importer, char *line);
+uint64_t hashTask(int64_t job, int64_t task);
+OpenTask *findOpenTask(Importer *importer, int64_t job, int64_t task, bool create);
+void removeOpenTask(Importer *importer, OpenTask *open_task);
+void importGoogleLine(Importer *importer, char *line);
+void importAlibabaLine(Importer *importer, char *line);
+int importTrace(const char *source, Importer *importer);
+
+#endif
@@ -0,0 +1,828 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace-io.h"
+
+#define MAX_THREADS 64
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// What validation found wrong with a line
+typedef enum
+{
+    LINE_OK,
+    LINE_MALFORMED,
+    LINE_BAD_BURST,
+    LINE_NEGATIVE_TIME,
+    LINE_BAD_CRITICALITY,
+    LINE_PROBLEMS
+} LineProblem;
+
+// One thread's share of the trace text: its lines are counted first, then
+// parsed into records [first_line, first_line + lines)
+typedef struct
+{
+    const char *text;
+    size_t begin;
+    size_t end;
+    int64_t lines;
+    int64_t first_line;
+    TraceRecord *records;
+    uint8_t *problems;
+    int64_t problem_count[LINE_PROBLEMS];
+    int64_t first_problem[LINE_PROBLEMS]; // Earliest line with each problem (-1 = none)
+} ParseTask;
+
+// One thread's slice of a radix sort pass
+typedef struct
+{
+    const uint64_t *keys;
+    const int64_t *items;
+    uint64_t *keys_out;
+    int64_t *items_out;
+    int64_t begin;
+    int64_t end;
+    int shift;
+    int64_t histogram[RADIX_BUCKETS];
+    int64_t offset[RADIX_BUCKETS]; // First output slot of each digit for this slice
+} RadixTask;
+
+// Records collected in memory for a prepared trace
+typedef struct
+{
+    TraceRecord *records;
+    int64_t count;
+    int64_t capacity;
+} RecordBuffer;
+
+// Function prototypes
+double elapsedMs(struct timespec *start);
+void runThreads(void *(*work)(void *), void *tasks, size_t task_size, int threads);
+bool blankLine(const char *line, const char *end);
+bool parseField(const char **cursor, const char *end, long long *value);
+LineProblem parseLine(const char *line, const char *end, TraceRecord *record);
+void *countLines(void *arg);
+void *parseLines(void *arg);
+void *countDigits(void *arg);
+void *scatterDigits(void *arg);
+void radixSort(uint64_t *keys, int64_t *items, int64_t n, int threads);
+int buildTrace(const char *trace_file, const char *prepared_file, int threads, bool drop_invalid);
+int writePreparedTrace(TraceRecord *records, int64_t n, int64_t dropped, int threads, const char *prepared_file,
+                       double parse_ms);
+void displayImportSummary(Importer *importer, double import_ms);
+void emitTextLine(TraceRecord *record, void *context);
+void emitRecord(TraceRecord *record, void *context);
+int importToText(const char *source, const char *trace_file, ImportOptions *options);
+int importToPrepared(const char *source, const char *prepared_file, ImportOptions *options, int threads);
+int openTrace(const char *filename, PreparedTrace *trace);
+void displayInfo(PreparedTrace *trace);
+void queryPid(PreparedTrace *trace, int64_t original_id);
+void printUsage(const char *program);
+
+// Milliseconds since start
+double elapsedMs(struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Run work on every task in its own thread and wait for all of them. A task
+// whose thread cannot be started runs on the calling thread instead.
+void runThreads(void *(*work)(void *), void *tasks, size_t task_size, int threads)
+{
+    pthread_t ids[MAX_THREADS];
+    bool started[MAX_THREADS];
+    for (int t = 1; t < threads; t++)
+        started[t] = pthread_create(&ids[t], NULL, work, (char *)tasks + t * task_size) == 0;
+    work(tasks);
+    for (int t = 1; t < threads; t++)
+    {
+        if (started[t])
+            pthread_join(ids[t], NULL);
+        else
+            work((char *)tasks + t * task_size);
+    }
+}
+
+// Whether a line holds nothing but whitespace
+bool blankLine(const char *line, const char *end)
+{
+    for (; line < end; line++)
+    {
+        if (*line != ' ' && *line != '\t' && *line != '\r')
+            return false;
+    }
+    return true;
+}
+
+// Read one integer of a line; unlike strtoll it never runs into the next line
+bool parseField(const char **cursor, const char *end, long long *value)
+{
+    const char *p = *cursor;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+        p++;
+
+    bool negative = p < end && *p == '-';
+    if (negative)
+        p++;
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+
+    long long result = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+        result = result * 10 + (*p++ - '0');
+
+    *value = negative ? -result : result;
+    *cursor = p;
+    return true;
+}
+
+// Parse "id arrival burst deadline criticality period priority" and check it
+LineProblem parseLine(const char *line, const char *end, TraceRecord *record)
+{
+    long long fields[7];
+    for (int f = 0; f < 7; f++)
+    {
+        if (!parseField(&line, end, &fields[f]))
+            return LINE_MALFORMED;
+    }
+    if (!blankLine(line, end))
+        return LINE_MALFORMED;
+
+    record->original_id = (int32_t)fields[0];
+    record->arrival_time = fields[1];
+    record->burst_time = fields[2];
+    record->deadline = fields[3];
+    record->criticality = (int32_t)fields[4];
+    record->period = fields[5];
+    record->priority = (int32_t)fields[6];
+
+    if (record->burst_time <= 0)
+        return LINE_BAD_BURST;
+    if (record->arrival_time < 0 || record->deadline < 0 || record->period < 0)
+        return LINE_NEGATIVE_TIME;
+    if (record->criticality < MIN_CRITICALITY || record->criticality > MAX_CRITICALITY)
+        return LINE_BAD_CRITICALITY;
+    return LINE_OK;
+}
+
+// Count the non-blank lines of a slice
+void *countLines(void *arg)
+{
+    ParseTask *task = (ParseTask *)arg;
+    task->lines = 0;
+    size_t line = task->begin;
+    while (line < task->end)
+    {
+        const char *newline = memchr(task->text + line, '\n', task->end - line);
+        size_t next = newline != NULL ? (size_t)(newline - task->text) : task->end;
+        if (!blankLine(task->text + line, task->text + next))
+            task->lines++;
+        line = next + 1;
+    }
+    return NULL;
+}
+
+// Parse and validate the non-blank lines of a slice
+void *parseLines(void *arg)
+{
+    ParseTask *task = (ParseTask *)arg;
+    for (int p = 0; p < LINE_PROBLEMS; p++)
+    {
+        task->problem_count[p] = 0;
+        task->first_problem[p] = -1;
+    }
+
+    int64_t row = task->first_line;
+    size_t line = task->begin;
+    while (line < task->end)
+    {
+        const char *newline = memchr(task->text + line, '\n', task->end - line);
+        size_t next = newline != NULL ? (size_t)(newline - task->text) : task->end;
+        if (!blankLine(task->text + line, task->text + next))
+        {
+            LineProblem problem = parseLine(task->text + line, task->text + next, &task->records[row]);
+            task->problems[row] = (uint8_t)problem;
+            task->problem_count[problem]++;
+            if (task->first_problem[problem] < 0)
+                task->first_problem[problem] = row;
+            row++;
+        }
+        line = next + 1;
+    }
+    return NULL;
+}
+
+// Histogram the current digit of a slice
+void *countDigits(void *arg)
+{
+    RadixTask *task = (RadixTask *)arg;
+    memset(task->histogram, 0, sizeof(task->histogram));
+    for (int64_t i = task->begin; i < task->end; i++)
+        task->histogram[(task->keys[i] >> task->shift) & (RADIX_BUCKETS - 1)]++;
+    return NULL;
+}
+
+// Move a slice to its output slots; slices and digits keep their order, so
+// every pass is stable
+void *scatterDigits(void *arg)
+{
+    RadixTask *task = (RadixTask *)arg;
+    for (int64_t i = task->begin; i < task->end; i++)
+    {
+        int digit = (task->keys[i] >> task->shift) & (RADIX_BUCKETS - 1);
+        int64_t slot = task->offset[digit]++;
+        task->keys_out[slot] = task->keys[i];
+        task->items_out[slot] = task->items[i];
+    }
+    return NULL;
+}
+
+// Stable parallel LSD radix sort of items by key. Only the digits below the
+// largest key's top byte are sorted on.
+void radixSort(uint64_t *keys, int64_t *items, int64_t n, int threads)
+{
+    uint64_t largest = 0;
+    for (int64_t i = 0; i < n; i++)
+        largest |= keys[i];
+
+    uint64_t *key_buffer = (uint64_t *)malloc(sizeof(uint64_t) * (n > 0 ? n : 1));
+    int64_t *item_buffer = (int64_t *)malloc(sizeof(int64_t) * (n > 0 ? n : 1));
+    RadixTask *tasks = (RadixTask *)malloc(sizeof(RadixTask) * threads);
+    if (key_buffer == NULL || item_buffer == NULL || tasks == NULL)
+    {
+        printf("Not enough memory to sort %lld records\n", (long long)n);
+        exit(1);
+    }
+
+    uint64_t *from_keys = keys, *to_keys = key_buffer;
+    int64_t *from_items = items, *to_items = item_buffer;
+    for (int shift = 0; shift < 64 && (largest >> shift) != 0; shift += RADIX_BITS)
+    {
+        for (int t = 0; t < threads; t++)
+        {
+            tasks[t].keys = from_keys;
+            tasks[t].items = from_items;
+            tasks[t].keys_out = to_keys;
+            tasks[t].items_out = to_items;
+            tasks[t].begin = n * t / threads;
+            tasks[t].end = n * (t + 1) / threads;
+            tasks[t].shift = shift;
+        }
+        runThreads(countDigits, tasks, sizeof(RadixTask), threads);
+
+        int64_t slot = 0;
+        for (int digit = 0; digit < RADIX_BUCKETS; digit++)
+        {
+            for (int t = 0; t < threads; t++)
+            {
+                tasks[t].offset[digit] = slot;
+                slot += tasks[t].histogram[digit];
+            }
+        }
+        runThreads(scatterDigits, tasks, sizeof(RadixTask), threads);
+
+        uint64_t *swap_keys = from_keys;
+        from_keys = to_keys;
+        to_keys = swap_keys;
+        int64_t *swap_items = from_items;
+        from_items = to_items;
+        to_items = swap_items;
+    }
+
+    if (from_keys != keys)
+    {
+        memcpy(keys, from_keys, sizeof(uint64_t) * n);
+        memcpy(items, from_items, sizeof(int64_t) * n);
+    }
+    free(tasks);
+    free(item_buffer);
+    free(key_buffer);
+}
+
+// Validate a text trace, sort it by arrival, renumber it and write it out
+int buildTrace(const char *trace_file, const char *prepared_file, int threads, bool drop_invalid)
+{
+    static const char *problem_names[] = {"", "Malformed Lines", "Non-Positive Bursts", "Negative Times",
+                                          "Criticality Out Of Range"};
+
+    int fd = open(trace_file, O_RDONLY);
+    if (fd < 0)
+    {
+        printf("Error opening file: %s\n", trace_file);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        printf("Error reading number of processes from file.\n");
+        close(fd);
+        return 1;
+    }
+    size_t size = st.st_size;
+    const char *text = (const char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (text == MAP_FAILED)
+    {
+        printf("Error mapping file: %s\n", trace_file);
+        return 1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // The first line holds the number of processes
+    const char *cursor = text;
+    const char *first_newline = memchr(text, '\n', size);
+    const char *header_end = first_newline != NULL ? first_newline : text + size;
+    long long declared;
+    if (!parseField(&cursor, header_end, &declared) || declared <= 0)
+    {
+        printf("Invalid number of processes in %s (must be at least 1)\n", trace_file);
+        munmap((void *)text, size);
+        return 1;
+    }
+    size_t body = header_end - text + (first_newline != NULL ? 1 : 0);
+
+    // Slices start on line boundaries
+    ParseTask *tasks = (ParseTask *)calloc(threads, sizeof(ParseTask));
+    if (tasks == NULL)
+    {
+        printf("Not enough memory for %d threads\n", threads);
+        munmap((void *)text, size);
+        return 1;
+    }
+    size_t begin = body;
+    for (int t = 0; t < threads; t++)
+    {
+        size_t end = t == threads - 1 ? size : body + (size - body) * (t + 1) / threads;
+        if (end < begin)
+            end = begin;
+        while (end < size && end > begin && text[end - 1] != '\n')
+            end++;
+        tasks[t].text = text;
+        tasks[t].begin = begin;
+        tasks[t].end = end;
+        begin = end;
+    }
+    runThreads(countLines, tasks, sizeof(ParseTask), threads);
+
+    int64_t lines = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        tasks[t].first_line = lines;
+        lines += tasks[t].lines;
+    }
+    if (lines < declared)
+    {
+        printf("%s declares %lld processes but holds %lld\n", trace_file, declared, (long long)lines);
+        free(tasks);
+        munmap((void *)text, size);
+        return 1;
+    }
+
+    TraceRecord *records = (TraceRecord *)malloc(sizeof(TraceRecord) * lines);
+    uint8_t *problems = (uint8_t *)malloc(lines);
+    if (records == NULL || problems == NULL)
+    {
+        printf("Not enough memory for %lld processes\n", (long long)lines);
+        exit(1);
+    }
+    for (int t = 0; t < threads; t++)
+    {
+        tasks[t].records = records;
+        tasks[t].problems = problems;
+    }
+    runThreads(parseLines, tasks, sizeof(ParseTask), threads);
+    munmap((void *)text, size);
+
+    // Like the simulators, only the declared number of lines is used
+    int64_t n = declared;
+    if (lines > n)
+        printf("Ignoring %lld lines after the %lld declared processes\n", (long long)(lines - n), declared);
+
+    int64_t problem_count[LINE_PROBLEMS] = {0};
+    int64_t first_problem[LINE_PROBLEMS];
+    for (int p = 0; p < LINE_PROBLEMS; p++)
+        first_problem[p] = -1;
+    for (int t = 0; t < threads; t++)
+    {
+        if (tasks[t].first_line >= n)
+            break;
+        if (tasks[t].first_line + tasks[t].lines <= n)
+        {
+            for (int p = 0; p < LINE_PROBLEMS; p++)
+            {
+                problem_count[p] += tasks[t].problem_count[p];
+                if (first_problem[p] < 0)
+                    first_problem[p] = tasks[t].first_problem[p];
+            }
+            continue;
+        }
+        // The slice straddles the declared count: recount its used part
+        for (int64_t row = tasks[t].first_line; row < n; row++)
+        {
+            problem_count[problems[row]]++;
+            if (first_problem[problems[row]] < 0)
+                first_problem[problems[row]] = row;
+        }
+    }
+    free(tasks);
+
+    int64_t invalid = n - problem_count[LINE_OK];
+    if (invalid > 0)
+    {
+        for (int p = LINE_OK + 1; p < LINE_PROBLEMS; p++)
+        {
+            if (problem_count[p] > 0)
+                printf("%s,%lld (first on process line %lld)\n", problem_names[p], (long long)problem_count[p],
+                       (long long)first_problem[p] + 1);
+        }
+        if (!drop_invalid)
+        {
+            printf("Invalid trace: %s (use --drop-invalid to skip bad lines)\n", trace_file);
+            free(problems);
+            free(records);
+            return 1;
+        }
+
+        int64_t kept = 0;
+        for (int64_t row = 0; row < n; row++)
+        {
+            if (problems[row] == LINE_OK)
+                records[kept++] = records[row];
+        }
+        n = kept;
+        if (n == 0)
+        {
+            printf("No valid processes left in %s\n", trace_file);
+            free(problems);
+            free(records);
+            return 1;
+        }
+    }
+    free(problems);
+    return writePreparedTrace(records, n, declared - n, threads, prepared_file, elapsedMs(&start));
+}
+
+// Sort records by arrival, renumber them in that order and write the prepared
+// trace with its pid map; takes ownership of records
+int writePreparedTrace(TraceRecord *records, int64_t n, int64_t dropped, int threads, const char *prepared_file,
+                       double parse_ms)
+{
+    // Stable sort by arrival, then renumber in that order
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t *keys = (uint64_t *)malloc(sizeof(uint64_t) * n);
+    int64_t *order = (int64_t *)malloc(sizeof(int64_t) * n);
+    TraceRecord *sorted = (TraceRecord *)malloc(sizeof(TraceRecord) * n);
+    PidEntry *pids = (PidEntry *)malloc(sizeof(PidEntry) * n);
+    if (keys == NULL || order == NULL || sorted == NULL || pids == NULL)
+    {
+        printf("Not enough memory for %lld processes\n", (long long)n);
+        exit(1);
+    }
+
+    int64_t inversions = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+        keys[i] = (uint64_t)records[i].arrival_time;
+        order[i] = i;
+        if (i > 0 && records[i].arrival_time < records[i - 1].arrival_time)
+            inversions++;
+    }
+    radixSort(keys, order, n, threads);
+
+    TraceHeader header;
+    memset(&header, 0, sizeof(header));
+    int64_t smallest_id = INT32_MAX;
+    for (int64_t i = 0; i < n; i++)
+    {
+        sorted[i] = records[order[i]];
+        sorted[i].id = (int32_t)(i + 1);
+        header.total_burst += sorted[i].burst_time;
+        if (sorted[i].original_id < smallest_id)
+            smallest_id = sorted[i].original_id;
+    }
+    free(records);
+
+    // Ids are sorted on their distance from the smallest, which keeps the
+    // keys non-negative and short
+    for (int64_t i = 0; i < n; i++)
+    {
+        keys[i] = (uint64_t)(sorted[i].original_id - smallest_id);
+        order[i] = i;
+    }
+
+    radixSort(keys, order, n, threads);
+    int64_t duplicates = 0;
+    for (int64_t i = 0; i < n; i++)
+    {
+        pids[i].original_id = sorted[order[i]].original_id;
+        pids[i].index = order[i];
+        if (i > 0 && pids[i].original_id == pids[i - 1].original_id)
+            duplicates++;
+    }
+    free(order);
+    free(keys);
+    double sort_ms = elapsedMs(&start);
+
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.count = n;
+    header.record_offset = sizeof(TraceHeader);
+    header.pid_offset = header.record_offset + sizeof(TraceRecord) * n;
+    header.min_arrival = sorted[0].arrival_time;
+    header.max_arrival = sorted[n - 1].arrival_time;
+
+    FILE *file = fopen(prepared_file, "wb");
+    int status = 0;
+    if (file == NULL)
+    {
+        printf("Error creating prepared trace: %s\n", prepared_file);
+        status = 1;
+    }
+    else
+    {
+        if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+            fwrite(sorted, sizeof(TraceRecord), n, file) != (size_t)n ||
+            fwrite(pids, sizeof(PidEntry), n, file) != (size_t)n)
+        {
+            printf("Error writing prepared trace: %s\n", prepared_file);
+            status = 1;
+        }
+        fclose(file);
+    }
+
+    if (status == 0)
+    {
+        printf("Metric,Value\n");
+        printf("Processes,%lld\n", (long long)n);
+        printf("Dropped Lines,%lld\n", (long long)dropped);
+        printf("Duplicate Ids,%lld\n", (long long)duplicates);
+        printf("Arrival Inversions,%lld\n", (long long)inversions);
+        printf("Threads,%d\n", threads);
+        printf("Parse Time (ms),%.2f\n", parse_ms);
+        printf("Sort Time (ms),%.2f\n", sort_ms);
+    }
+
+    free(pids);
+    free(sorted);
+    return status;
+}
+
+void displayImportSummary(Importer *importer, double import_ms)
+{
+    printf("Metric,Value\n");
+    printf("Source Lines,%lld\n", (long long)importer->lines);
+    printf("Imported Processes,%lld\n", (long long)importer->imported);
+    printf("Malformed Lines,%lld\n", (long long)importer->malformed);
+    printf("Skipped Without Runtime,%lld\n", (long long)importer->no_runtime);
+    printf("Unfinished Jobs,%lld\n", (long long)importer->unfinished);
+    printf("Import Time (ms),%.2f\n", import_ms);
+}
+
+// Write a process as a text trace line
+void emitTextLine(TraceRecord *record, void *context)
+{
+    fprintf((FILE *)context, "%d %lld %lld %lld %d %lld %d\n", record->original_id,
+            (long long)record->arrival_time, (long long)record->burst_time, (long long)record->deadline,
+            record->criticality, (long long)record->period, record->priority);
+}
+
+// Append a process to a record buffer
+void emitRecord(TraceRecord *record, void *context)
+{
+    RecordBuffer *buffer = (RecordBuffer *)context;
+    if (buffer->count == buffer->capacity)
+    {
+        buffer->capacity = buffer->capacity > 0 ? buffer->capacity * 2 : INITIAL_OPEN_TASKS;
+        buffer->records = (TraceRecord *)realloc(buffer->records, sizeof(TraceRecord) * buffer->capacity);
+        if (buffer->records == NULL)
+        {
+            printf("Not enough memory for %lld processes\n", (long long)buffer->capacity);
+            exit(1);
+        }
+    }
+    buffer->records[buffer->count++] = *record;
+}
+
+// Stream a source trace into a text trace. The process count is not known
+// until the end, so its line is reserved at full width and filled in last.
+int importToText(const char *source, const char *trace_file, ImportOptions *options)
+{
+    FILE *file = fopen(trace_file, "w");
+    if (file == NULL)
+    {
+        printf("Error creating file: %s\n", trace_file);
+        return 1;
+    }
+    fprintf(file, "%20d\n", 0);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    Importer importer;
+    memset(&importer, 0, sizeof(importer));
+    importer.options = options;
+    importer.emit = emitTextLine;
+    importer.context = file;
+    int status = importTrace(source, &importer);
+
+    if (status == 0 && importer.imported == 0)
+    {
+        printf("No processes imported from %s\n", source);
+        status = 1;
+    }
+    if (status == 0)
+    {
+        fseek(file, 0, SEEK_SET);
+        fprintf(file, "%20lld\n", (long long)importer.imported);
+    }
+    if (fclose(file) != 0 && status == 0)
+    {
+        printf("Error writing file: %s\n", trace_file);
+        status = 1;
+    }
+    if (status == 0)
+        displayImportSummary(&importer, elapsedMs(&start));
+    return status;
+}
+
+// Import a source trace straight into a prepared trace
+int importToPrepared(const char *source, const char *prepared_file, ImportOptions *options, int threads)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    RecordBuffer buffer = {NULL, 0, 0};
+    Importer importer;
+    memset(&importer, 0, sizeof(importer));
+    importer.options = options;
+    importer.emit = emitRecord;
+    importer.context = &buffer;
+    if (importTrace(source, &importer) != 0)
+        return 1;
+    if (buffer.count == 0)
+    {
+        printf("No processes imported from %s\n", source);
+        return 1;
+    }
+
+    double import_ms = elapsedMs(&start);
+    displayImportSummary(&importer, import_ms);
+    return writePreparedTrace(buffer.records, buffer.count,
+                              importer.malformed + importer.no_runtime + importer.unfinished, threads, prepared_file,
+                              import_ms);
+}
+
+// Map a prepared trace read-only
+int openTrace(const char *filename, PreparedTrace *trace)
+{
+    int status = mapPreparedTrace(filename, trace);
+    if (status == 0)
+        printf("Error opening prepared trace: %s\n", filename);
+    return status == 1 ? 0 : 1;
+}
+
+void displayInfo(PreparedTrace *trace)
+{
+    printf("Metric,Value\n");
+    printf("Processes,%lld\n", (long long)trace->header->count);
+    printf("First Arrival,%lld\n", (long long)trace->header->min_arrival);
+    printf("Last Arrival,%lld\n", (long long)trace->header->max_arrival);
+    printf("Total Burst,%lld\n", (long long)trace->header->total_burst);
+}
+
+// Binary search the pid map for the records of an original id
+void queryPid(PreparedTrace *trace, int64_t original_id)
+{
+    int64_t low = 0, high = trace->header->count;
+    while (low < high)
+    {
+        int64_t middle = low + (high - low) / 2;
+        if (trace->pids[middle].original_id < original_id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    printf("ProcessID,OriginalID,ArrivalTime,BurstTime\n");
+    for (int64_t i = low; i < trace->header->count && trace->pids[i].original_id == original_id; i++)
+    {
+        TraceRecord *record = &trace->records[trace->pids[i].index];
+        printf("%d,%d,%lld,%lld\n", record->id, record->original_id, (long long)record->arrival_time,
+               (long long)record->burst_time);
+    }
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s build <trace> <prepared> [--format F] [--threads N] [--drop-invalid] [import options]\n", program);
+    printf("       %s import <source> <trace.txt> --format F [import options]\n", program);
+    printf("       %s info <prepared>\n", program);
+    printf("       %s pid <prepared> <original_pid>\n", program);
+    printf("Formats: text (default for build), swf, google (task_events), alibaba (batch_task)\n");
+    printf("Import options: [--unit-ns U] [--machine-cpus C] [--runtime-only]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool build = strcmp(argv[1], "build") == 0;
+    if (build || strcmp(argv[1], "import") == 0)
+    {
+        if (argc < 4)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        int threads = cpus > 0 ? (int)cpus : 1;
+        bool drop_invalid = false;
+        ImportOptions options = {FORMAT_TEXT, DEFAULT_IMPORT_UNIT_NS, 1, false};
+        for (int i = 4; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            {
+                if (!parseFormat(argv[++i], &options.format))
+                {
+                    printf("Unknown trace format: %s\n", argv[i]);
+                    return 1;
+                }
+            }
+            else if (build && strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+                threads = atoi(argv[++i]);
+            else if (build && strcmp(argv[i], "--drop-invalid") == 0)
+                drop_invalid = true;
+            else if (strcmp(argv[i], "--unit-ns") == 0 && i + 1 < argc)
+                options.unit_ns = strtoll(argv[++i], NULL, 10);
+            else if (strcmp(argv[i], "--machine-cpus") == 0 && i + 1 < argc)
+                options.machine_cpus = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--runtime-only") == 0)
+                options.runtime_only = true;
+            else
+            {
+                printf("Unknown option: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        if (threads < 1 || threads > MAX_THREADS)
+        {
+            printf("Invalid thread count: %d (must be 1 to %d)\n", threads, MAX_THREADS);
+            return 1;
+        }
+        if (options.unit_ns < 1 || options.machine_cpus < 1)
+        {
+            printf("Invalid import settings\n");
+            return 1;
+        }
+
+        if (options.format == FORMAT_TEXT)
+        {
+            if (!build)
+            {
+                printf("Import needs a source format (--format swf, google or alibaba)\n");
+                return 1;
+            }
+            return buildTrace(argv[2], argv[3], threads, drop_invalid);
+        }
+        if (build)
+            return importToPrepared(argv[2], argv[3], &options, threads);
+        return importToText(argv[2], argv[3], &options);
+    }
+
+    PreparedTrace trace;
+    if (openTrace(argv[2], &trace) != 0)
+        return 1;
+
+    int status = 0;
+    if (strcmp(argv[1], "info") == 0 && argc == 3)
+        displayInfo(&trace);
+    else if (strcmp(argv[1], "pid") == 0 && argc == 4)
+        queryPid(&trace, atoll(argv[3]));
+    else
+    {
+        printUsage(argv[0]);
+        status = 1;
+    }
+
+    unmapPreparedTrace(&trace);
+    return status;
+}
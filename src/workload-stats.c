@@ -0,0 +1,507 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "trace-io.h"
+
+#define MAX_FILENAME_LENGTH 256
+#define HISTOGRAM_SUB_BUCKETS 16 // Buckets per power of two (about 6% resolution)
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SIZE 1024
+#define TIMELINE_BUCKETS 64
+#define INITIAL_IMPORTED_RECORDS 1024
+
+// Streaming summary of a non-negative integer distribution: exact moments and
+// a log-bucketed histogram for quantiles, in constant memory
+typedef struct
+{
+    long long count;
+    double mean;
+    double m2; // Sum of squared deviations (Welford)
+    long long min;
+    long long max;
+    long long buckets[HISTOGRAM_SIZE];
+} Distribution;
+
+// Arrivals and offered work per time bucket; the bucket width doubles
+// whenever an arrival falls past the end, so memory stays constant
+typedef struct
+{
+    long long width;
+    long long arrivals[TIMELINE_BUCKETS];
+    double work[TIMELINE_BUCKETS];
+} Timeline;
+
+// Everything gathered in the single pass over the trace
+typedef struct
+{
+    long long processes;
+    long long first_arrival;
+    long long last_arrival;
+    long long total_burst;
+    long long periodic;
+    long long with_deadline;
+    long long infeasible_deadlines;
+    long long out_of_order;
+    long long invalid;
+    long long criticality[MAX_CRITICALITY + 2]; // Index MAX_CRITICALITY + 1 counts out-of-range values
+    long long backlog_end;                      // Completion time of queued work on one CPU
+    long long peak_backlog;
+    bool absolute_deadlines;
+    Distribution inter_arrival;
+    Distribution burst;
+    Distribution slack;
+    Timeline timeline;
+} WorkloadStats;
+
+// Processes handed over by an importer. Importers emit a process once it has
+// finished (Google emits in finish order), so they are collected and folded
+// into the statistics in arrival order.
+typedef struct
+{
+    TraceRecord *records;
+    int64_t count;
+    int64_t capacity;
+} ImportedRecords;
+
+// Function prototypes
+int histogramBucket(long long value);
+long long histogramBucketValue(int bucket);
+void addToDistribution(Distribution *dist, long long value);
+long long distributionQuantile(Distribution *dist, double q);
+void addToTimeline(Timeline *timeline, long long time, long long burst);
+void initializeStats(WorkloadStats *stats);
+void addProcess(WorkloadStats *stats, TraceRecord *record);
+void emitStatsRecord(TraceRecord *record, void *context);
+int compareSubmitOrder(const void *a, const void *b);
+int readTextTrace(FILE *file, WorkloadStats *stats);
+int readTrace(const char *filename, ImportOptions *options, WorkloadStats *stats);
+void displayDistribution(const char *name, Distribution *dist);
+void displayStats(WorkloadStats *stats);
+
+// Map a value to its histogram bucket: exact below HISTOGRAM_SUB_BUCKETS,
+// then HISTOGRAM_SUB_BUCKETS buckets per power of two
+int histogramBucket(long long value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return (int)value;
+
+    int exponent = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = exponent - HISTOGRAM_SUB_BITS;
+    int sub = (int)((value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1));
+    return HISTOGRAM_SUB_BUCKETS + shift * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// Representative (middle) value of a histogram bucket
+long long histogramBucketValue(int bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+        return bucket;
+
+    int shift = (bucket - HISTOGRAM_SUB_BUCKETS) / HISTOGRAM_SUB_BUCKETS;
+    int sub = (bucket - HISTOGRAM_SUB_BUCKETS) % HISTOGRAM_SUB_BUCKETS;
+    long long lower = (long long)(HISTOGRAM_SUB_BUCKETS + sub) << shift;
+    long long width = 1LL << shift;
+    return lower + (width - 1) / 2;
+}
+
+// Add one observation to a distribution
+void addToDistribution(Distribution *dist, long long value)
+{
+    if (value < 0)
+        value = 0;
+
+    dist->count++;
+    double delta = value - dist->mean;
+    dist->mean += delta / dist->count;
+    dist->m2 += delta * (value - dist->mean);
+
+    if (dist->count == 1 || value < dist->min)
+        dist->min = value;
+    if (dist->count == 1 || value > dist->max)
+        dist->max = value;
+
+    dist->buckets[histogramBucket(value)]++;
+}
+
+// Approximate quantile q (0..1) from the histogram, clamped to the exact range
+long long distributionQuantile(Distribution *dist, double q)
+{
+    if (dist->count == 0)
+        return 0;
+
+    long long rank = (long long)ceil(q * dist->count);
+    if (rank < 1)
+        rank = 1;
+
+    long long seen = 0;
+    for (int b = 0; b < HISTOGRAM_SIZE; b++)
+    {
+        seen += dist->buckets[b];
+        if (seen >= rank)
+        {
+            long long value = histogramBucketValue(b);
+            if (value < dist->min)
+                value = dist->min;
+            if (value > dist->max)
+                value = dist->max;
+            return value;
+        }
+    }
+    return dist->max;
+}
+
+// Record an arrival and its work on the timeline
+void addToTimeline(Timeline *timeline, long long time, long long burst)
+{
+    // Coarsen until the arrival fits, merging neighbouring buckets
+    while (time >= timeline->width * TIMELINE_BUCKETS)
+    {
+        for (int b = 0; b < TIMELINE_BUCKETS / 2; b++)
+        {
+            timeline->arrivals[b] = timeline->arrivals[2 * b] + timeline->arrivals[2 * b + 1];
+            timeline->work[b] = timeline->work[2 * b] + timeline->work[2 * b + 1];
+        }
+        for (int b = TIMELINE_BUCKETS / 2; b < TIMELINE_BUCKETS; b++)
+        {
+            timeline->arrivals[b] = 0;
+            timeline->work[b] = 0.0;
+        }
+        timeline->width *= 2;
+    }
+
+    int bucket = (int)(time / timeline->width);
+    timeline->arrivals[bucket]++;
+    timeline->work[bucket] += burst;
+}
+
+// Reset all statistics
+void initializeStats(WorkloadStats *stats)
+{
+    bool absolute_deadlines = stats->absolute_deadlines;
+    memset(stats, 0, sizeof(WorkloadStats));
+    stats->absolute_deadlines = absolute_deadlines;
+    stats->timeline.width = 1;
+}
+
+// Fold one process into the statistics
+void addProcess(WorkloadStats *stats, TraceRecord *record)
+{
+    if (record->arrival_time < 0 || record->burst_time < 0)
+    {
+        stats->invalid++;
+        return;
+    }
+
+    long long arrival = record->arrival_time;
+    long long burst = record->burst_time;
+
+    if (stats->processes == 0)
+    {
+        stats->first_arrival = arrival;
+        stats->last_arrival = arrival;
+        stats->backlog_end = arrival;
+    }
+    else if (arrival < stats->last_arrival)
+    {
+        // Inter-arrival gaps and backlog are only meaningful in arrival order
+        stats->out_of_order++;
+    }
+    else
+    {
+        addToDistribution(&stats->inter_arrival, arrival - stats->last_arrival);
+    }
+
+    if (stats->processes == 0 || arrival >= stats->last_arrival)
+    {
+        // Lindley recursion: work left on one CPU when this process arrives
+        if (stats->backlog_end < arrival)
+            stats->backlog_end = arrival;
+        if (stats->backlog_end - arrival > stats->peak_backlog)
+            stats->peak_backlog = stats->backlog_end - arrival;
+        stats->backlog_end += burst;
+        stats->last_arrival = arrival;
+    }
+    if (arrival < stats->first_arrival)
+        stats->first_arrival = arrival;
+
+    stats->processes++;
+    stats->total_burst += burst;
+    addToDistribution(&stats->burst, burst);
+    addToTimeline(&stats->timeline, arrival, record->burst_time);
+
+    if (record->period > 0)
+        stats->periodic++;
+
+    if (record->deadline > 0)
+    {
+        // Deadlines are relative to arrival unless --absolute-deadlines is given
+        long long due = stats->absolute_deadlines ? record->deadline : arrival + record->deadline;
+        long long slack = due - arrival - burst;
+        stats->with_deadline++;
+        if (slack < 0)
+            stats->infeasible_deadlines++;
+        else
+            addToDistribution(&stats->slack, slack);
+    }
+
+    if (record->criticality >= MIN_CRITICALITY && record->criticality <= MAX_CRITICALITY)
+        stats->criticality[record->criticality]++;
+    else
+        stats->criticality[MAX_CRITICALITY + 1]++;
+}
+
+// Collect a process handed over by an importer; its id keeps the emit order
+void emitStatsRecord(TraceRecord *record, void *context)
+{
+    ImportedRecords *imported = (ImportedRecords *)context;
+    if (imported->count == imported->capacity)
+    {
+        int64_t capacity = imported->capacity > 0 ? imported->capacity * 2 : INITIAL_IMPORTED_RECORDS;
+        TraceRecord *records = (TraceRecord *)realloc(imported->records, sizeof(TraceRecord) * capacity);
+        if (records == NULL)
+        {
+            printf("Not enough memory for %lld imported processes\n", (long long)imported->count);
+            exit(1);
+        }
+        imported->records = records;
+        imported->capacity = capacity;
+    }
+    imported->records[imported->count] = *record;
+    imported->records[imported->count].id = (int32_t)imported->count;
+    imported->count++;
+}
+
+// Order imported processes by arrival (submit) time, then by emit order
+int compareSubmitOrder(const void *a, const void *b)
+{
+    const TraceRecord *r1 = (const TraceRecord *)a;
+    const TraceRecord *r2 = (const TraceRecord *)b;
+    if (r1->arrival_time != r2->arrival_time)
+        return r1->arrival_time < r2->arrival_time ? -1 : 1;
+    if (r1->id != r2->id)
+        return r1->id < r2->id ? -1 : 1;
+    return 0;
+}
+
+// Stream a text trace (count, then one process per line) into the statistics.
+// Returns the number of records read.
+int readTextTrace(FILE *file, WorkloadStats *stats)
+{
+    int n;
+    if (fscanf(file, "%d", &n) != 1)
+    {
+        printf("Error reading number of processes from file.\n");
+        return -1;
+    }
+
+    TraceRecord record;
+    memset(&record, 0, sizeof(record));
+    long long arrival_time, burst_time, deadline, period;
+    int read = 0;
+    while (read < n && fscanf(file, "%d %lld %lld %lld %d %lld %d",
+                              &record.id,
+                              &arrival_time,
+                              &burst_time,
+                              &deadline,
+                              &record.criticality,
+                              &period,
+                              &record.priority) == 7)
+    {
+        record.arrival_time = arrival_time;
+        record.burst_time = burst_time;
+        record.deadline = deadline;
+        record.period = period;
+        addProcess(stats, &record);
+        read++;
+    }
+
+    if (read < n)
+        printf("Warning: expected %d processes, read %d\n", n, read);
+
+    return read;
+}
+
+// Read a trace of any format into the statistics: a prepared trace (found
+// by its header), a text trace, or a cluster trace through its importer.
+// Returns 0 on success.
+int readTrace(const char *filename, ImportOptions *options, WorkloadStats *stats)
+{
+    if (options->format != FORMAT_TEXT)
+    {
+        // Importers write absolute deadlines
+        stats->absolute_deadlines = true;
+        ImportedRecords imported;
+        memset(&imported, 0, sizeof(imported));
+        Importer importer;
+        memset(&importer, 0, sizeof(importer));
+        importer.options = options;
+        importer.emit = emitStatsRecord;
+        importer.context = &imported;
+        if (importTrace(filename, &importer) != 0)
+            return 1;
+
+        qsort(imported.records, imported.count, sizeof(TraceRecord), compareSubmitOrder);
+        for (int64_t i = 0; i < imported.count; i++)
+            addProcess(stats, &imported.records[i]);
+        free(imported.records);
+        stats->invalid += importer.malformed;
+        return 0;
+    }
+
+    PreparedTrace trace;
+    int mapped = mapPreparedTrace(filename, &trace);
+    if (mapped < 0)
+        return 1;
+    if (mapped > 0)
+    {
+        for (int64_t i = 0; i < trace.header->count; i++)
+            addProcess(stats, &trace.records[i]);
+        unmapPreparedTrace(&trace);
+        return 0;
+    }
+
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        printf("Error opening file: %s\n", filename);
+        return 1;
+    }
+    int read = readTextTrace(file, stats);
+    fclose(file);
+    return read < 0;
+}
+
+// Write one distribution row
+void displayDistribution(const char *name, Distribution *dist)
+{
+    double stddev = dist->count > 1 ? sqrt(dist->m2 / (dist->count - 1)) : 0.0;
+    printf("%s,%lld,%.2f,%.2f,%lld,%lld,%lld,%lld,%lld\n",
+           name,
+           dist->count,
+           dist->mean,
+           stddev,
+           dist->min,
+           distributionQuantile(dist, 0.50),
+           distributionQuantile(dist, 0.90),
+           distributionQuantile(dist, 0.99),
+           dist->max);
+}
+
+// Write the statistics as CSV tables
+void displayStats(WorkloadStats *stats)
+{
+    long long span = stats->last_arrival - stats->first_arrival + 1;
+    long long makespan = stats->backlog_end - stats->first_arrival;
+    double n = stats->processes > 0 ? (double)stats->processes : 1.0;
+
+    printf("Metric,Value\n");
+    printf("Processes,%lld\n", stats->processes);
+    printf("Invalid Records,%lld\n", stats->invalid);
+    printf("Out-of-Order Arrivals,%lld\n", stats->out_of_order);
+    printf("First Arrival,%lld\n", stats->first_arrival);
+    printf("Last Arrival,%lld\n", stats->last_arrival);
+    printf("Arrival Rate,%.4f\n", stats->processes / (double)span);
+    printf("Offered Load,%.4f\n", stats->total_burst / (double)span);
+    if (stats->out_of_order == 0 && makespan > 0)
+    {
+        // Any work-conserving single-CPU policy is busy for exactly the total burst
+        printf("Utilization,%.4f\n", stats->total_burst / (double)makespan);
+        printf("Peak Backlog,%lld\n", stats->peak_backlog);
+    }
+    else
+    {
+        printf("Utilization,n/a\n");
+        printf("Peak Backlog,n/a\n");
+    }
+    printf("Periodic Share,%.4f\n", stats->periodic / n);
+    printf("Deadline Share,%.4f\n", stats->with_deadline / n);
+    printf("Infeasible Deadlines,%lld\n", stats->infeasible_deadlines);
+
+    printf("\nDistribution,Count,Mean,StdDev,Min,P50,P90,P99,Max\n");
+    displayDistribution("Inter-arrival Time", &stats->inter_arrival);
+    displayDistribution("Burst Time", &stats->burst);
+    displayDistribution("Deadline Slack", &stats->slack);
+
+    printf("\nCriticality,Count,Share\n");
+    for (int c = MIN_CRITICALITY; c <= MAX_CRITICALITY; c++)
+    {
+        printf("%d,%lld,%.4f\n", c, stats->criticality[c], stats->criticality[c] / n);
+    }
+    printf("Other,%lld,%.4f\n", stats->criticality[MAX_CRITICALITY + 1], stats->criticality[MAX_CRITICALITY + 1] / n);
+
+    printf("\nWindow Start,Window End,Arrivals,Arrival Rate,Offered Load\n");
+    for (int b = 0; b < TIMELINE_BUCKETS; b++)
+    {
+        long long start = b * stats->timeline.width;
+        if (start > stats->last_arrival)
+            break;
+        printf("%lld,%lld,%lld,%.4f,%.4f\n",
+               start,
+               start + stats->timeline.width,
+               stats->timeline.arrivals[b],
+               stats->timeline.arrivals[b] / (double)stats->timeline.width,
+               stats->timeline.work[b] / stats->timeline.width);
+    }
+}
+
+// Characterize a trace in one streaming pass with constant memory
+int main(int argc, char *argv[])
+{
+    char filename[MAX_FILENAME_LENGTH] = "";
+    static WorkloadStats stats;
+    ImportOptions options = {FORMAT_TEXT, DEFAULT_IMPORT_UNIT_NS, 1, false};
+
+    stats.absolute_deadlines = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--absolute-deadlines") == 0)
+            stats.absolute_deadlines = true;
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+        {
+            if (!parseFormat(argv[++i], &options.format))
+            {
+                printf("Unknown trace format: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--unit-ns") == 0 && i + 1 < argc)
+            options.unit_ns = strtoll(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--machine-cpus") == 0 && i + 1 < argc)
+            options.machine_cpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--runtime-only") == 0)
+            options.runtime_only = true;
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        else
+        {
+            strncpy(filename, argv[i], MAX_FILENAME_LENGTH - 1);
+            filename[MAX_FILENAME_LENGTH - 1] = '\0';
+        }
+    }
+
+    if (filename[0] == '\0')
+    {
+        printf("Usage: %s <input_file> [--absolute-deadlines] [--format F] [--unit-ns U] [--machine-cpus C] "
+               "[--runtime-only]\n", argv[0]);
+        printf("Formats: text or prepared (default, detected), swf, google (task_events), alibaba (batch_task)\n");
+        return 1;
+    }
+    if (options.unit_ns < 1 || options.machine_cpus < 1)
+    {
+        printf("Invalid import settings\n");
+        return 1;
+    }
+
+    initializeStats(&stats);
+    if (readTrace(filename, &options, &stats) != 0)
+        return 1;
+
+    displayStats(&stats);
+    return 0;
+}